@@ -0,0 +1,200 @@
+#include "core/JobSystem.hpp"
+#include "core/SceneFile.hpp"
+#include "logging/Log.hpp"
+#include "rendering/MeshOptimizer.hpp"
+#include "rendering/ModelFile.hpp"
+#include "rendering/TextureFile.hpp"
+
+#include <atomic>
+#include <filesystem>
+#include <set>
+#include <string>
+#include <vector>
+
+using namespace lei3d;
+
+namespace fs = std::filesystem;
+
+/*
+ * lei3d_cook: turns source assets into the binary files the engine maps at runtime.
+ *     lei3d_cook [--force] <file or directory>...
+ * Directories are searched recursively. Models (obj, gltf, glb, fbx, dae) get a .lmesh twin (see ModelFile), and
+ * every texture they use a block compressed .dds twin (see TextureFile). Scene text files (Foo.lscene.txt) get their
+ * Foo.lscene. Images given by name are compressed too. Anything already up to date is skipped unless --force is given.
+ */
+
+static bool isSceneSource(const fs::path& path)
+{
+	const std::string name = path.filename().string();
+	const std::string suffix = ".lscene.txt";
+	return name.size() > suffix.size() && name.compare(name.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+// Cooked files record what they were cooked from (see SourceStamp).
+static bool isUpToDate(const fs::path& source, const fs::path& cooked)
+{
+	const std::string sourcePath = source.generic_string();
+	const std::string cookedPath = cooked.generic_string();
+	if (ModelFile::IsModelSource(sourcePath))
+	{
+		return ModelFile::IsUpToDate(sourcePath, cookedPath);
+	}
+	if (TextureFile::IsImageSource(sourcePath))
+	{
+		return TextureFile::IsUpToDate(sourcePath, cookedPath);
+	}
+	return SceneFile::IsUpToDate(sourcePath, cookedPath);
+}
+
+struct CookStats
+{
+	std::atomic<int> cooked = 0; // Textures are cooked as jobs.
+	std::atomic<int> skipped = 0;
+	std::atomic<int> failed = 0;
+};
+
+// Reports what mesh optimization did for a cooked model, whether it was just cooked or already up to date, and adds
+// the textures it uses (relative to the working directory).
+static void inspectCookedModel(const std::string& modelSource, std::set<std::string>& textures)
+{
+	ModelFile modelFile;
+	if (!modelFile.Open(ModelFile::GetCookedPath(modelSource)))
+	{
+		return;
+	}
+
+	const MeshOptimizationStats stats = modelFile.GetOptimizationStats();
+	LEI_INFO("{0}: {1} triangles, {2} -> {3} vertices, ACMR {4:.3f} -> {5:.3f}, ATVR {6:.3f} -> {7:.3f}", modelSource,
+		stats.triangles, stats.verticesBefore, stats.verticesAfter, stats.AcmrBefore(), stats.AcmrAfter(), stats.AtvrBefore(), stats.AtvrAfter());
+
+	// Empty for a model in the working directory, which parent_path handles and cutting at the last '/' doesn't.
+	const fs::path directory = fs::path(modelSource).parent_path();
+	for (uint32_t i = 0; i < modelFile.GetHeader().textureCount; i++)
+	{
+		textures.insert((directory / modelFile.GetString(modelFile.GetTexture(i).path)).generic_string());
+	}
+}
+
+static void cookFile(const fs::path& path, bool force, JobSystem& jobs, CookStats& stats, std::set<std::string>& textures)
+{
+	const std::string source = path.generic_string();
+	const bool		  isModel = ModelFile::IsModelSource(source);
+	std::string		  cooked;
+	if (isModel)
+	{
+		cooked = ModelFile::GetCookedPath(source);
+	}
+	else if (isSceneSource(path))
+	{
+		cooked = source.substr(0, source.size() - std::string(".txt").size());
+	}
+	else
+	{
+		return;
+	}
+
+	if (!force && isUpToDate(path, cooked))
+	{
+		stats.skipped++;
+	}
+	else
+	{
+		LEI_INFO("Cooking {0}", source);
+		const bool success = isModel ? ModelFile::Cook(source, cooked, &jobs) : SceneFile::Cook(source, cooked);
+		success ? stats.cooked++ : stats.failed++;
+	}
+
+	// Even if the model itself was up to date, its textures may not be. It gets reported either way.
+	if (isModel)
+	{
+		inspectCookedModel(source, textures);
+	}
+}
+
+int main(int argc, char** argv)
+{
+	Log::Init();
+
+	bool					 force = false;
+	std::vector<std::string> inputs;
+	for (int i = 1; i < argc; i++)
+	{
+		const std::string arg = argv[i];
+		if (arg == "--force")
+		{
+			force = true;
+		}
+		else
+		{
+			inputs.push_back(arg);
+		}
+	}
+
+	if (inputs.empty())
+	{
+		LEI_ERROR("Usage: lei3d_cook [--force] <file or directory>...");
+		return 1;
+	}
+
+	JobSystem			  jobs;
+	CookStats			  stats;
+	std::set<std::string> textures; // A set, so textures shared by several models are only cooked once.
+	for (const std::string& input : inputs)
+	{
+		std::error_code error;
+		if (fs::is_directory(input, error))
+		{
+			for (const fs::directory_entry& entry : fs::recursive_directory_iterator(input, error))
+			{
+				if (entry.is_regular_file())
+				{
+					cookFile(entry.path(), force, jobs, stats, textures);
+				}
+			}
+		}
+		else if (fs::is_regular_file(input, error))
+		{
+			if (TextureFile::IsImageSource(input))
+			{
+				textures.insert(fs::path(input).generic_string());
+			}
+			else
+			{
+				cookFile(input, force, jobs, stats, textures);
+			}
+		}
+		else
+		{
+			LEI_ERROR("{0} doesn't exist", input);
+			stats.failed++;
+		}
+	}
+
+	// Compressing is by far the slowest part, and every texture is independent.
+	const std::vector<std::string> texturePaths(textures.begin(), textures.end());
+	jobs.ParallelFor(static_cast<uint32_t>(texturePaths.size()), 1, [&](uint32_t begin, uint32_t end) {
+		for (uint32_t i = begin; i < end; i++)
+		{
+			const std::string& source = texturePaths[i];
+			const std::string  cooked = TextureFile::GetCookedPath(source);
+			std::error_code	   error;
+			if (!fs::exists(source, error))
+			{
+				// Not fatal at runtime either, the material just samples an empty texture.
+				LEI_WARN("{0} is used by a model but doesn't exist", source);
+				continue;
+			}
+			if (!force && isUpToDate(source, cooked))
+			{
+				stats.skipped++;
+				continue;
+			}
+
+			LEI_INFO("Cooking {0}", source);
+			TextureFile::Cook(source, cooked) ? stats.cooked++ : stats.failed++;
+		}
+	});
+
+	LEI_INFO("Cooked {0}, {1} up to date, {2} failed", stats.cooked.load(), stats.skipped.load(), stats.failed.load());
+	return stats.failed == 0 ? 0 : 1;
+}
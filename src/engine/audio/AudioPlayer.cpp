@@ -1,6 +1,8 @@
 #define MINIAUDIO_IMPLEMENTATION
 #include "audio/AudioPlayer.hpp"
 
+#include <filesystem>
+
 namespace lei3d
 {
 	AudioPlayer* AudioPlayer::s_AudioPlayer = nullptr;
@@ -27,6 +29,9 @@ namespace lei3d
 		}
 
 		s_AudioPlayer = this;
+
+		FindSounds("data/audio", m_MusicPaths);
+		FindSounds("data/audio/sfx", m_SFXPaths);
 	}
 
 	AudioPlayer::~AudioPlayer()
@@ -39,16 +44,44 @@ namespace lei3d
 		return *(s_AudioPlayer);
 	}
 
-	void AudioPlayer::PlayMusic(const std::string& musicName)
+	void AudioPlayer::PlayMusic(StringId musicName)
 	{
-		std::string musicPath = "data/audio/" + musicName + ".mp3";
+		s_AudioPlayer->PlaySound(s_AudioPlayer->m_MusicPaths, musicName);
+	}
 
-		ma_engine_play_sound(s_AudioPlayer->m_AudioEngine.get(), musicPath.c_str(), NULL);
+	void AudioPlayer::PlaySFX(StringId sfxName)
+	{
+		s_AudioPlayer->PlaySound(s_AudioPlayer->m_SFXPaths, sfxName);
 	}
 
-	void AudioPlayer::PlaySFX(const std::string& sfxName)
+	void AudioPlayer::FindSounds(const std::string& directory, std::unordered_map<StringId, std::string>& paths)
 	{
-		std::string sfxPath = "data/audio/sfx/" + sfxName + ".mp3";
-		ma_engine_play_sound(s_AudioPlayer->m_AudioEngine.get(), sfxPath.c_str(), NULL);
+		std::error_code error;
+		for (const auto& entry : std::filesystem::directory_iterator(directory, error))
+		{
+			if (entry.is_regular_file() && entry.path().extension() == ".mp3")
+			{
+				// Keep the forward slashes the paths used to be built with.
+				const std::string path = directory + "/" + entry.path().filename().string();
+				paths[StringId::Intern(entry.path().stem().string())] = path;
+			}
+		}
+
+		if (error)
+		{
+			LEI_WARN("AudioPlayer: Couldn't list sounds in {0}: {1}", directory, error.message());
+		}
+	}
+
+	void AudioPlayer::PlaySound(const std::unordered_map<StringId, std::string>& paths, StringId name)
+	{
+		auto it = paths.find(name);
+		if (it == paths.end())
+		{
+			LEI_WARN("AudioPlayer: No sound named {0}", name.GetString());
+			return;
+		}
+
+		ma_engine_play_sound(m_AudioEngine.get(), it->second.c_str(), NULL);
 	}
 } // namespace lei3d
\ No newline at end of file
@@ -1,7 +1,10 @@
 #pragma once
 
 #include <memory>
+#include <string>
+#include <unordered_map>
 #include "miniaudio.h"
+#include "core/StringId.hpp"
 #include "logging/Log.hpp"
 
 namespace lei3d
@@ -16,10 +19,19 @@ namespace lei3d
 
         static AudioPlayer& GetAudioPlayer();
 
-        static void PlayMusic(const std::string& musicName);
-        static void PlaySFX(const std::string& sfxName);
+        // Sounds are named by their file name without the extension, e.g. PlaySFX("landing_2").
+        static void PlayMusic(StringId musicName);
+        static void PlaySFX(StringId sfxName);
 
         std::unique_ptr<ma_engine> m_AudioEngine;
+
+    private:
+        // Filled once at startup from what's in the audio folders, so playing a sound doesn't build a path.
+        std::unordered_map<StringId, std::string> m_MusicPaths;
+        std::unordered_map<StringId, std::string> m_SFXPaths;
+
+        static void FindSounds(const std::string& directory, std::unordered_map<StringId, std::string>& paths);
+        void        PlaySound(const std::unordered_map<StringId, std::string>& paths, StringId name);
     };
 
 }
\ No newline at end of file
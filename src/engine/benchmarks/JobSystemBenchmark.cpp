@@ -0,0 +1,95 @@
+#include "JobSystemBenchmark.hpp"
+
+#include "core/JobSystem.hpp"
+#include "core/Scene.hpp"
+#include "core/SystemRegistry.hpp"
+#include "logging/Log.hpp"
+
+#include <glm/gtc/quaternion.hpp>
+
+#include <chrono>
+#include <cmath>
+#include <thread>
+
+namespace lei3d
+{
+	/*
+	 * Bobs and spins its entity. Only writes its own state and its own entity's transform, so it can run in parallel.
+	 */
+	class BenchmarkSpinner : public Component
+	{
+	private:
+		float	  m_Time = 0.0f;
+		float	  m_Speed = 1.0f;
+		glm::vec3 m_Origin = glm::vec3(0.0f);
+
+	public:
+		BenchmarkSpinner(Entity& entity)
+			: Component(entity)
+		{
+		}
+
+		void Init(uint32_t i)
+		{
+			m_Speed = 0.5f + static_cast<float>(i % 97) / 97.0f;
+			m_Origin = glm::vec3(static_cast<float>(i % 256), 0.0f, static_cast<float>(i / 256));
+		}
+
+		void Update() override
+		{
+			constexpr float FRAME_TIME = 1.0f / 120.0f;
+			m_Time += FRAME_TIME * m_Speed;
+
+			const float bob = std::sin(m_Time * 3.0f) * 0.5f + std::sin(m_Time * 7.0f) * 0.1f;
+			m_Entity.SetPosition(m_Origin + glm::vec3(0.0f, bob, 0.0f));
+			m_Entity.SetRotation(glm::angleAxis(m_Time, glm::normalize(glm::vec3(std::cos(m_Time), 1.0f, std::sin(m_Time)))));
+		}
+	};
+
+	std::vector<JobSystemBenchmarkResult> RunJobSystemBenchmark(uint32_t entityCount, uint32_t frameCount)
+	{
+		LEI_INFO("Job system benchmark: {0} entities, {1} frames per run", entityCount, frameCount);
+
+		Scene scene;
+		for (uint32_t i = 0; i < entityCount; i++)
+		{
+			Entity& entity = scene.AddEntity("Spinner");
+			entity.AddComponent<BenchmarkSpinner>()->Init(i);
+		}
+
+		SystemRegistry registry;
+		registry.Register<BenchmarkSpinner, PHASE_UPDATE>("BenchmarkSpinner", { {}, MakeComponentMask<Transform>(), true });
+
+		std::vector<uint32_t> threadCounts;
+		const uint32_t		  maxThreads = std::max(1u, std::thread::hardware_concurrency());
+		for (uint32_t threads = 1; threads < maxThreads; threads *= 2)
+		{
+			threadCounts.push_back(threads);
+		}
+		threadCounts.push_back(maxThreads);
+
+		std::vector<JobSystemBenchmarkResult> results;
+		for (uint32_t threads : threadCounts)
+		{
+			JobSystem jobs(threads - 1);
+
+			// One untimed frame to wake the workers up.
+			registry.Run(PHASE_UPDATE, scene.GetComponentStorage(), &jobs);
+
+			const auto start = std::chrono::steady_clock::now();
+			for (uint32_t frame = 0; frame < frameCount; frame++)
+			{
+				registry.Run(PHASE_UPDATE, scene.GetComponentStorage(), &jobs);
+			}
+			const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+
+			const double msPerFrame = elapsed.count() / frameCount;
+			const double speedup = results.empty() ? 1.0 : results.front().msPerFrame / msPerFrame;
+			results.push_back({ threads, msPerFrame, speedup });
+
+			LEI_INFO("  {0:>2} threads: {1:.3f} ms/frame ({2:.2f}x)", threads, msPerFrame, speedup);
+		}
+
+		return results;
+	}
+} // namespace lei3d
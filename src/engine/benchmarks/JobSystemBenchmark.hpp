@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace lei3d
+{
+	struct JobSystemBenchmarkResult
+	{
+		uint32_t threadCount;
+		double	 msPerFrame;
+		double	 speedup; // Compared to the single threaded run.
+	};
+
+	/*
+	 * Builds a synthetic scene with entityCount entities that each animate their own transform, and times the update
+	 * phase with 1, 2, 4, ... up to all hardware threads. Results are logged and returned (the editor shows them under
+	 * Benchmarks).
+	 */
+	std::vector<JobSystemBenchmarkResult> RunJobSystemBenchmark(uint32_t entityCount = 50000, uint32_t frameCount = 60);
+} // namespace lei3d
@@ -0,0 +1,81 @@
+#include "ModelLoadBenchmark.hpp"
+
+#include "core/Application.hpp"
+#include "core/JobSystem.hpp"
+#include "logging/Log.hpp"
+#include "rendering/Model.hpp"
+#include "rendering/TextureStreamer.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <memory>
+
+namespace lei3d
+{
+	template <typename F>
+	static double timeMs(F&& func)
+	{
+		const auto start = std::chrono::steady_clock::now();
+		func();
+		const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+		return elapsed.count();
+	}
+
+	std::vector<ModelLoadBenchmarkResult> RunModelLoadBenchmark(const std::string& modelDirectory)
+	{
+		namespace fs = std::filesystem;
+
+		std::vector<std::string> paths;
+		std::error_code			 error;
+		for (const fs::directory_entry& entry : fs::recursive_directory_iterator(modelDirectory, error))
+		{
+			if (entry.is_regular_file() && ModelFile::IsModelSource(entry.path().generic_string()))
+			{
+				paths.push_back(entry.path().generic_string());
+			}
+		}
+		std::sort(paths.begin(), paths.end());
+
+		// The application's, a second one would just have its workers compete with the first's for the cores.
+		JobSystem& jobs = Application::GetJobSystem();
+		LEI_INFO("Model load benchmark: {0} models, {1} threads", paths.size(), jobs.ThreadCount());
+
+		std::vector<ModelLoadBenchmarkResult> results;
+		for (const std::string& path : paths)
+		{
+			// One untimed load, so every timed one finds the files in the OS cache. None of them share textures through the
+			// AssetManager, which would skip decoding them.
+			{
+				Model warmUp(path, MODEL_LOAD_IMPORT | MODEL_LOAD_NO_CACHE);
+			}
+
+			ModelLoadBenchmarkResult result;
+			result.path = path;
+			result.serialMs = timeMs([&]() { Model model(path, MODEL_LOAD_IMPORT | MODEL_LOAD_NO_CACHE); });
+
+			std::unique_ptr<Model> model;
+			result.parallelMs = timeMs([&]() { model = std::make_unique<Model>(path, MODEL_LOAD_IMPORT | MODEL_LOAD_NO_CACHE, &jobs); });
+			// Everything the upload costs, not just the part that happens before the textures stream in.
+			result.uploadMs = timeMs([&]() {
+				model->Upload();
+				TextureStreamer::Flush();
+			});
+			model.reset();
+
+			result.cookedMs = -1.0;
+			if (fs::exists(ModelFile::GetCookedPath(path), error))
+			{
+				result.cookedMs = timeMs([&]() { Model cooked(path, MODEL_LOAD_NO_CACHE, &jobs); });
+			}
+
+			result.speedup = result.parallelMs > 0.0 ? result.serialMs / result.parallelMs : 1.0;
+			results.push_back(result);
+
+			LEI_INFO("  {0}: serial {1:.1f} ms, parallel {2:.1f} ms ({3:.2f}x), cooked {4:.1f} ms, upload {5:.1f} ms", path,
+				result.serialMs, result.parallelMs, result.speedup, result.cookedMs, result.uploadMs);
+		}
+
+		return results;
+	}
+} // namespace lei3d
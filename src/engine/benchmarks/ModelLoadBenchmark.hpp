@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace lei3d
+{
+	struct ModelLoadBenchmarkResult
+	{
+		std::string path;
+		double		serialMs;	// Assimp import on one thread.
+		double		parallelMs; // Assimp import with the meshes and textures spread over the job system.
+		double		cookedMs;	// Loading the cooked .lmesh (with the job system), negative if the model isn't cooked.
+		double		uploadMs;	// Upload on the main thread, the part that stays serial.
+		double		speedup;	// serialMs / parallelMs.
+	};
+
+	/*
+	 * Loads every model under modelDirectory (searched recursively) single threaded, then with a job system on all
+	 * hardware threads, then from its cooked twin if there is one, and times each. Creates GL objects, so main thread
+	 * only. Results are logged and returned (the editor shows them under Benchmarks).
+	 */
+	std::vector<ModelLoadBenchmarkResult> RunModelLoadBenchmark(const std::string& modelDirectory = "data/models");
+} // namespace lei3d
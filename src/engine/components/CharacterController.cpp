@@ -41,7 +41,7 @@ namespace lei3d
 		//Set the player's physics transform to the entity transform.
 		btTransform trans;
 		trans.setIdentity();
-		trans.setOrigin(glmToBTVec3(m_Entity.m_Transform.position));
+		trans.setOrigin(glmToBTVec3(m_Entity.GetPosition()));
 
 		//Reset Rigidbody & Ground Check
 		m_RigidBody->setWorldTransform(trans);
@@ -84,6 +84,8 @@ namespace lei3d
 
 		PhysicsWorld& world = SceneManager::ActiveScene().GetPhysicsWorld();
 		world.m_dynamicsWorld->addRigidBody(m_RigidBody);
+		m_IsInDynamicsWorld = true;
+		m_World = world.m_dynamicsWorld.get();
 		// world.m_collisionShapes.push_back(m_Collider);
 
 		// GROUND CHECK ------------------
@@ -105,7 +107,7 @@ namespace lei3d
 		const FollowCameraController* cameraController = m_Entity.GetComponent<FollowCameraController>();
 		if (cameraController != nullptr)
 		{
-			m_Entity.m_Transform.yawRotation = cameraController->GetCamera()->GetYaw();
+			m_Entity.SetYawRotation(cameraController->GetCamera()->GetYaw());
 		}
 	}
 
@@ -125,7 +127,9 @@ namespace lei3d
 			m_MotionState->getWorldTransform(characterTrans);
 		}
 		m_GroundCheckObj->setWorldTransform(getGroundCheckTransform(characterTrans));
-		m_Entity.setFromBTTransform(characterTrans);
+
+		// Only take the position from the body: it never rotates (angular factor is 0), the camera drives our yaw.
+		m_Entity.SetPosition(btTransformToVec3(characterTrans));
 	}
 
 	void CharacterController::OnReset()
@@ -136,6 +140,27 @@ namespace lei3d
 		m_IsInDynamicsWorld = false;
 	}
 
+	// The destructor deletes all of it, the world mustn't step any of it after that. Scenes destroy their entities
+	// before their physics world, so the world is still there. The action stays added while the body is out (OnReset).
+	void CharacterController::OnDestroy()
+	{
+		if (!m_World)
+		{
+			return;
+		}
+
+		m_World->removeAction(m_CharacterPhysicsUpdate);
+		if (m_RigidBody->isInWorld())
+		{
+			m_World->removeRigidBody(m_RigidBody);
+		}
+		if (m_GroundCheckObj->getBroadphaseHandle())
+		{
+			m_World->removeCollisionObject(m_GroundCheckObj);
+		}
+		m_IsInDynamicsWorld = false;
+	}
+
 	btTransform CharacterController::getGroundCheckTransform(const btTransform& parentTransform)
 	{
 		btTransform groundCheckTrans;
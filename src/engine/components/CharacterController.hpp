@@ -27,7 +27,7 @@ namespace lei3d
 		// float m_maxSpeed = 40.0f;
 		//  float m_maxVelocity = 100;
 
-		bool m_IsInDynamicsWorld;
+		bool m_IsInDynamicsWorld = false;
 
 	private:
 		class CharacterPhysicsUpdate : public btActionInterface
@@ -45,22 +45,23 @@ namespace lei3d
 			void debugDraw(btIDebugDraw* debugDrawer) override;
 
 		private:
-			glm::vec3 Accelerate(glm::vec3 wishDir, glm::vec3 prevVelocity, float acceleration, float maxVelocity);
-			glm::vec3 AirAcceleration(glm::vec3 wishDir, glm::vec3 prevVelocity);
-			glm::vec3 GroundAcceleration(glm::vec3 wishDir, glm::vec3 prevVelocity);
+			glm::vec3 Accelerate(glm::vec3 wishDir, glm::vec3 prevVelocity, float acceleration, float maxVelocity, float deltaTime);
+			glm::vec3 AirAcceleration(glm::vec3 wishDir, glm::vec3 prevVelocity, float deltaTime);
+			glm::vec3 GroundAcceleration(glm::vec3 wishDir, glm::vec3 prevVelocity, float deltaTime);
 		};
 
 		float					m_Width, m_Height;
-		btCollisionShape*		m_Collider;
-		btDefaultMotionState*	m_MotionState;
-		btRigidBody*			m_RigidBody;
-		CharacterPhysicsUpdate* m_CharacterPhysicsUpdate;
+		btCollisionShape*		m_Collider = nullptr;
+		btDefaultMotionState*	m_MotionState = nullptr;
+		btRigidBody*			m_RigidBody = nullptr;
+		CharacterPhysicsUpdate* m_CharacterPhysicsUpdate = nullptr;
+		btDynamicsWorld*		m_World = nullptr; // The body and action were added to.
 
 		// GROUND CHECK
 		btVector3		   m_GroundCheckLocalPos;
 		btScalar		   m_GroundCheckDist;
-		btCollisionShape*  m_GroundCheckCollider;
-		btCollisionObject* m_GroundCheckObj;
+		btCollisionShape*  m_GroundCheckCollider = nullptr;
+		btCollisionObject* m_GroundCheckObj = nullptr;
 
 		bool m_Grounded;
 		bool m_IncludeSFX = true;
@@ -76,6 +77,7 @@ namespace lei3d
 		void PhysicsUpdate() override;
 		void OnImGuiRender() override;
 		void OnReset() override;
+		void OnDestroy() override;
 
 		bool IsGrounded() const;
 
@@ -27,8 +27,10 @@ namespace lei3d
 	void FollowCameraController::Update()
 	{
 		//Modify the player's lookdir to match the camera look
-		m_FollowEntity->m_Transform.yawRotation = m_Camera->GetYaw();
-		m_Camera->SetPosition(m_FollowEntity->m_Transform.position + m_OffsetFromEntity);
+		m_FollowEntity->SetYawRotation(m_Camera->GetYaw());
+		// Follow where the entity is drawn, not where the last physics tick put it, or the camera judders.
+		const glm::vec3 renderedPosition = glm::vec3(m_FollowEntity->GetInterpolatedModelMat()[3]);
+		m_Camera->SetPosition(renderedPosition + m_OffsetFromEntity);
 	}
 
 	Camera* FollowCameraController::GetCamera() const
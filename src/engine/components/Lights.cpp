@@ -10,7 +10,7 @@ namespace lei3d
 	{
 		Camera& camera = Application::GetSceneCamera();
 		float farZ = camera.GetFarPlane();
-		cascadeLevels = std::vector<float>{ farZ * 0.067f, farZ * 0.2f, farZ * 0.5f };
+		cascadeLevels = { farZ * 0.067f, farZ * 0.2f, farZ * 0.5f };
 
 //		GLCall(glGenBuffers(1, &lsmUBO));
 //		GLCall(glBindBuffer(GL_UNIFORM_BUFFER, lsmUBO));
@@ -1,7 +1,7 @@
 #pragma once
 
 #include "glm/glm.hpp"
-#include <vector>
+#include <array>
 
 namespace lei3d
 {
@@ -15,8 +15,10 @@ namespace lei3d
 		glm::vec3 color;
 		float intensity;
 
-		std::vector<float> cascadeLevels;
-		std::vector<glm::mat4> lightSpaceMatrices;
+		// Fixed size to match the uniform arrays in forward.frag and depth_cascades.geom.
+		static constexpr int CASCADE_COUNT = 3;
+		std::array<float, CASCADE_COUNT> cascadeLevels;
+		std::array<glm::mat4, CASCADE_COUNT + 1> lightSpaceMatrices;
 //		unsigned int lsmUBO;
 	};
 
@@ -4,6 +4,9 @@
 
 namespace lei3d
 {
+	// Set for every instance drawn, so hash it at compile time.
+	static constexpr StringId MODEL = "model"_sid;
+
 	ModelInstance::ModelInstance(Entity& entity)
 		: Component(entity)
 	{
@@ -20,8 +23,8 @@ namespace lei3d
 
 	void ModelInstance::Draw(Shader* shader, RenderFlag flags, uint32_t bindLocation)
 	{
-		glm::mat4 model = m_Entity.GetModelMat();
-		shader->setUniformMat4("model", model);
+		const glm::mat4& model = m_Entity.GetInterpolatedModelMat();
+		shader->setUniformMat4(MODEL, model);
 
 		if (m_Model)
 		{
@@ -5,6 +5,12 @@
 
 namespace lei3d
 {
+	// Set every frame, so hash them at compile time.
+	static constexpr StringId SKYBOX_CUBEMAP = "skyboxCubemap"_sid;
+	static constexpr StringId PROJ = "u_Proj"_sid;
+	static constexpr StringId VIEW = "u_View"_sid;
+	static constexpr StringId MODEL = "u_Model"_sid;
+
 	// DEFINE_COMPONENT(SkyBox, "SkyBox");
 
 	SkyBox::SkyBox(Entity& entity)
@@ -15,7 +21,7 @@ namespace lei3d
 	SkyBox::~SkyBox()
 	{
 		GLCall(glDeleteBuffers(1, &skyboxVBO));
-		GLCall(glDeleteVertexArrays(1, &skyboxVBO));
+		GLCall(glDeleteVertexArrays(1, &skyboxVAO));
 	}
 
 	// std::string SkyBox::GetComponentName() {
@@ -24,47 +30,27 @@ namespace lei3d
 
 	void SkyBox::Init(const std::vector<std::string>& faces)
 	{
-		loadCubemap(faces);
-
-		skyboxShader.bind();
-		skyboxShader.setInt("skyboxCubemap", 0);
-		skyboxShader.unbind();
+		Init(AssetManager::GetCubeMap(faces));
 	}
 
-	void SkyBox::loadCubemap(const std::vector<std::string>& faces)
+	void SkyBox::Init(AssetHandle<CubeMap> faces)
 	{
-		// load cubemap textures
-		stbi_set_flip_vertically_on_load(false);
-
-		unsigned int textureID;
-		GLCall(glGenTextures(1, &textureID));
-		GLCall(glBindTexture(GL_TEXTURE_CUBE_MAP, textureID));
-
-		int width, height, nrChannels;
-		for (unsigned int i = 0; i < faces.size(); i++)
+		cubeMap = std::move(faces);
+		if (!cubeMap->IsUploaded())
 		{
-			unsigned char* data = stbi_load(faces[i].c_str(), &width, &height, &nrChannels, 0);
-			if (data)
-			{
-				glTexImage2D(
-					GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, data); // valid because the cube maps are internally indexed.
-				stbi_image_free(data);
-			}
-			else
-			{
-				LEI_WARN("Cubemap texture failed to load at path: " + faces[i]);
-				stbi_image_free(data);
-			}
+			cubeMap->Upload();
 		}
-		GLCall(glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR));
-		GLCall(glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR));
-		GLCall(glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
-		GLCall(glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
-		GLCall(glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE));
 
-		// load skybox shader
-		skyboxShader = Shader("./data/shaders/skybox.vert", "./data/shaders/skybox.frag");
+		skyboxShader = AssetManager::GetShader("./data/shaders/skybox.vert", "./data/shaders/skybox.frag");
+		skyboxShader->bind();
+		skyboxShader->setInt(SKYBOX_CUBEMAP, 0);
+		skyboxShader->unbind();
 
+		setupCube();
+	}
+
+	void SkyBox::setupCube()
+	{
 		// set up VAO/VBO (remember, array object references the buffer object )
 		float skyboxVertices[] = {
 			// positions
@@ -122,7 +108,6 @@ namespace lei3d
 		GLCall(glBindBuffer(GL_ARRAY_BUFFER, 0));
 		GLCall(glBindVertexArray(0));
 
-		this->cubeMapTexture = textureID;
 		this->skyboxVAO = skyboxVAO;
 		this->skyboxVBO = skyboxVBO;
 	}
@@ -135,15 +120,15 @@ namespace lei3d
 		glm::mat4 proj = camera.GetProj();
 		glm::mat4 skyboxView = glm::mat4(glm::mat3(camera.GetView()));
 		glm::mat4 model = glm::identity<glm::mat4>();
-		skyboxShader.setUniformMat4("u_Proj", proj);
-		skyboxShader.setUniformMat4("u_View", skyboxView);
-		skyboxShader.setUniformMat4("u_Model", model);
-		skyboxShader.bind();
+		skyboxShader->setUniformMat4(PROJ, proj);
+		skyboxShader->setUniformMat4(VIEW, skyboxView);
+		skyboxShader->setUniformMat4(MODEL, model);
+		skyboxShader->bind();
 
 		GLCall(glDepthFunc(GL_LEQUAL));		  // we change the depth function here to it passes when testingdepth value is equal to what is current stored
 		GLCall(glBindVertexArray(skyboxVAO));
 		GLCall(glActiveTexture(GL_TEXTURE0)); //! could be the problem
-		GLCall(glBindTexture(GL_TEXTURE_CUBE_MAP, cubeMapTexture));
+		GLCall(glBindTexture(GL_TEXTURE_CUBE_MAP, cubeMap->GetTextureID()));
 		GLCall(glDrawArrays(GL_TRIANGLES, 0, 36));
 		GLCall(glBindVertexArray(0));
 		GLCall(glDepthFunc(GL_LESS)); // set depth function back to normal
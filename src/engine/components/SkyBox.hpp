@@ -10,7 +10,9 @@
 	#include <stb_image.h>
 #endif
 
+#include "core/AssetManager.hpp"
 #include "core/Component.hpp"
+#include "rendering/CubeMap.hpp"
 #include "rendering/Shader.hpp"
 
 namespace lei3d
@@ -19,20 +21,21 @@ namespace lei3d
 	class SkyBox : public Component
 	{
 	public:
-		unsigned int skyboxVAO;
-		unsigned int skyboxVBO;
-		Shader		 skyboxShader;
-		unsigned int cubeMapTexture;
+		unsigned int		 skyboxVAO = 0;
+		unsigned int		 skyboxVBO = 0;
+		AssetHandle<Shader>	 skyboxShader; // Shared by every sky box, see AssetManager.
+		AssetHandle<CubeMap> cubeMap;
 
 		SkyBox(Entity& entity);
 		~SkyBox();
 
 		// std::string GetComponentName() override;
 		void Init(const std::vector<std::string>& faces);
+		void Init(AssetHandle<CubeMap> faces); // E.g. requested from AssetManager on a loading thread. Uploads it if nobody has.
 
 		void Render() override;
 
 	private:
-		void loadCubemap(const std::vector<std::string>& faces);
+		void setupCube();
 	};
 } // namespace lei3d
\ No newline at end of file
@@ -12,10 +12,12 @@ namespace lei3d
 
 	StaticCollider::~StaticCollider()
 	{
-		delete m_Collider;
-		delete m_NonScaledCollider;
-		delete m_MotionState;
-		delete m_RigidBody;
+		for (const Body& body : m_Bodies)
+		{
+			delete body.collider;
+			delete body.motionState;
+			delete body.rigidBody;
+		}
 	}
 
 	/**
@@ -30,45 +32,46 @@ namespace lei3d
 
 	void StaticCollider::SetColliderToModel(Model& model)
 	{
-		std::vector<btTriangleMesh*>& modelMeshes = model.GetCollisionMeshes();
-		for (auto triMesh : modelMeshes)
+		// World space, the entity may have a parent. The world scale is the length of the model matrix's basis vectors.
+		const glm::mat4& modelMat = m_Entity.GetModelMat();
+		const btVector3	 scale{ glm::length(glm::vec3(modelMat[0])), glm::length(glm::vec3(modelMat[1])), glm::length(glm::vec3(modelMat[2])) };
+		const btTransform transform = m_Entity.getBTTransform();
+
+		// The BVHs are built by the model (ideally already on the loading thread), only the cheap scaling happens here.
+		std::vector<btBvhTriangleMeshShape*>& modelShapes = model.GetCollisionShapes();
+		for (auto shape : modelShapes)
 		{
-			AddCollisionsFromTriangleMesh(triMesh, m_Entity.m_Transform);
+			AddCollisionsFromShape(shape, transform, scale);
 		}
 	}
 
 	/**
-	 * @brief Mutates values in PhysicsWorld to add the triMesh to the dynamicsWorldScene
+	 * @brief Mutates values in PhysicsWorld to add the shape to the dynamicsWorldScene
 	 *
-	 * NOTE: triMesh not passed by const bc btBvhTriangleMeshShape does n ot  take in const
-	 *
-	 * @param triMesh
-	 * @param transform
+	 * @param shape
+	 * @param transform - World position and rotation.
+	 * @param scale - World scale.
 	 */
-	void StaticCollider::AddCollisionsFromTriangleMesh(btTriangleMesh* triMesh, const Transform& transform)
+	void StaticCollider::AddCollisionsFromShape(btBvhTriangleMeshShape* shape, const btTransform& transform, const btVector3& scale)
 	{
-		btVector3 scaleVector{ transform.scale.x, transform.scale.y, transform.scale.z };
-		m_NonScaledCollider = new btBvhTriangleMeshShape(triMesh, true, true);
-		m_Collider = new btScaledBvhTriangleMeshShape(m_NonScaledCollider, scaleVector);
+		btScaledBvhTriangleMeshShape* collider = new btScaledBvhTriangleMeshShape(shape, scale);
 
 		// now add this mesh to our physics world.
 		PhysicsWorld& world = SceneManager::ActiveScene().GetPhysicsWorld();
 		//.m_collisionShapes.push_back(m_Collider);
 
-		btTransform meshTransform;
-		meshTransform.setIdentity();
-		meshTransform.setOrigin(btVector3{ transform.position.x, transform.position.y, transform.position.z });
-
 		// mesh environment collisions are static
 		btScalar  meshMass = 0.0f;
 		btVector3 meshLocalInertia{ 0.0f, 0.0f, 0.0f };
 
-		m_MotionState = new btDefaultMotionState(meshTransform);
-		btRigidBody::btRigidBodyConstructionInfo rbMeshInfo{ meshMass, m_MotionState, m_Collider, meshLocalInertia };
-		m_RigidBody = new btRigidBody(rbMeshInfo);
-		m_RigidBody->setRestitution(0.0);
+		btMotionState*							 motionState = new btDefaultMotionState(transform);
+		btRigidBody::btRigidBodyConstructionInfo rbMeshInfo{ meshMass, motionState, collider, meshLocalInertia };
+		btRigidBody*							 rigidBody = new btRigidBody(rbMeshInfo);
+		rigidBody->setRestitution(0.0);
 
-		world.m_dynamicsWorld->addRigidBody(m_RigidBody);
+		world.m_dynamicsWorld->addRigidBody(rigidBody);
+		m_World = world.m_dynamicsWorld.get();
+		m_Bodies.push_back({ collider, motionState, rigidBody });
 	}
 
 	// FOR SOME REASON THE COLLISION MESH DOESN'T CHANGE
@@ -80,9 +83,25 @@ namespace lei3d
 		{
 			m_Entity.m_ResetTransform = false;
 			trans = m_Entity.getBTTransform();
-			m_RigidBody->setWorldTransform(trans);
-			m_MotionState->setWorldTransform(trans);
+			for (const Body& body : m_Bodies)
+			{
+				body.rigidBody->setWorldTransform(trans);
+				body.motionState->setWorldTransform(trans);
+			}
 			m_Entity.setFromBTTransform(trans);
 		}
 	}
+
+	// The destructor deletes the bodies, the world mustn't step them after that. Scenes destroy their entities before
+	// their physics world, so the world is still there.
+	void StaticCollider::OnDestroy()
+	{
+		for (const Body& body : m_Bodies)
+		{
+			if (body.rigidBody->isInWorld())
+			{
+				m_World->removeRigidBody(body.rigidBody);
+			}
+		}
+	}
 } // namespace lei3d
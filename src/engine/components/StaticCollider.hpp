@@ -11,10 +11,16 @@ namespace lei3d
 	class StaticCollider : public Component
 	{
 	private:
-		btScaledBvhTriangleMeshShape* m_Collider;
-		btBvhTriangleMeshShape*		  m_NonScaledCollider;
-		btMotionState*				  m_MotionState;
-		btRigidBody*				  m_RigidBody;
+		// One per collision shape of the model.
+		struct Body
+		{
+			btScaledBvhTriangleMeshShape* collider; // The unscaled shape it wraps belongs to the model.
+			btMotionState*				  motionState;
+			btRigidBody*				  rigidBody;
+		};
+
+		std::vector<Body> m_Bodies;
+		btDynamicsWorld*  m_World = nullptr; // The bodies were added to.
 
 	public:
 		StaticCollider(Entity& entity);
@@ -23,8 +29,9 @@ namespace lei3d
 		void Init();
 		void SetColliderToModel(Model& model);
 		void PhysicsUpdate() override;
+		void OnDestroy() override;
 
 	private:
-		void AddCollisionsFromTriangleMesh(btTriangleMesh* triMesh, const Transform& transform);
+		void AddCollisionsFromShape(btBvhTriangleMeshShape* shape, const btTransform& transform, const btVector3& scale);
 	};
 } // namespace lei3d
@@ -0,0 +1,132 @@
+#include "AllocationTracker.hpp"
+
+#ifdef LEI_TRACK_ALLOCATIONS
+	#include <atomic>
+	#include <cstdlib>
+	#include <new>
+
+namespace
+{
+	std::atomic<uint64_t> s_AllocationCount = 0;
+
+	void* CountedAlloc(size_t size)
+	{
+		s_AllocationCount.fetch_add(1, std::memory_order_relaxed);
+		if (void* memory = std::malloc(size == 0 ? 1 : size))
+		{
+			return memory;
+		}
+		throw std::bad_alloc();
+	}
+
+	void* CountedAlignedAlloc(size_t size, std::align_val_t alignment)
+	{
+		s_AllocationCount.fetch_add(1, std::memory_order_relaxed);
+	#ifdef _WIN32
+		void* memory = _aligned_malloc(size == 0 ? 1 : size, static_cast<size_t>(alignment));
+	#else
+		void* memory = nullptr;
+		if (posix_memalign(&memory, static_cast<size_t>(alignment), size == 0 ? 1 : size) != 0)
+		{
+			memory = nullptr;
+		}
+	#endif
+		if (memory)
+		{
+			return memory;
+		}
+		throw std::bad_alloc();
+	}
+
+	void AlignedFree(void* memory)
+	{
+	#ifdef _WIN32
+		_aligned_free(memory);
+	#else
+		std::free(memory);
+	#endif
+	}
+} // namespace
+
+// Replacements for the global allocation functions. Every other form (nothrow, sized delete) is defined in terms of these.
+void* operator new(size_t size)
+{
+	return CountedAlloc(size);
+}
+
+void* operator new[](size_t size)
+{
+	return CountedAlloc(size);
+}
+
+void* operator new(size_t size, std::align_val_t alignment)
+{
+	return CountedAlignedAlloc(size, alignment);
+}
+
+void* operator new[](size_t size, std::align_val_t alignment)
+{
+	return CountedAlignedAlloc(size, alignment);
+}
+
+void operator delete(void* memory) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete[](void* memory, size_t) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete(void* memory, std::align_val_t) noexcept
+{
+	AlignedFree(memory);
+}
+
+void operator delete[](void* memory, std::align_val_t) noexcept
+{
+	AlignedFree(memory);
+}
+
+void operator delete(void* memory, size_t, std::align_val_t) noexcept
+{
+	AlignedFree(memory);
+}
+
+void operator delete[](void* memory, size_t, std::align_val_t) noexcept
+{
+	AlignedFree(memory);
+}
+#endif
+
+namespace lei3d
+{
+	bool AllocationTracker::IsEnabled()
+	{
+#ifdef LEI_TRACK_ALLOCATIONS
+		return true;
+#else
+		return false;
+#endif
+	}
+
+	uint64_t AllocationTracker::GetAllocationCount()
+	{
+#ifdef LEI_TRACK_ALLOCATIONS
+		return s_AllocationCount.load(std::memory_order_relaxed);
+#else
+		return 0;
+#endif
+	}
+} // namespace lei3d
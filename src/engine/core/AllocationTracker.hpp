@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstdint>
+
+namespace lei3d
+{
+	/*
+	 * Counts heap allocations made through the global operator new.
+	 * Only active when built with the LEI_TRACK_ALLOCATIONS CMake option, since counting means replacing operator new
+	 * for the whole program. Application uses it to report how many allocations each frame makes, which should be
+	 * zero once a scene is running (transient per frame data goes in the FrameAllocator).
+	 */
+	class AllocationTracker
+	{
+	public:
+		static bool		IsEnabled();
+		static uint64_t GetAllocationCount(); // Since startup. Always 0 when tracking is off.
+	};
+} // namespace lei3d
@@ -1,10 +1,15 @@
 #define STB_IMAGE_IMPLEMENTATION
 #include "Application.hpp"
 
+#include "core/AllocationTracker.hpp"
+
 #include "logging/GLDebug.hpp"
 
 #include <stb_image.h>
 
+#include <algorithm>
+#include <cmath>
+
 namespace lei3d
 {
 
@@ -30,14 +35,20 @@ namespace lei3d
 	{
 		s_Instance = nullptr;
 
-		// Shutdown GLFW
-		glfwDestroyWindow(m_Window);
-		glfwTerminate();
+		// Everything that deletes GL objects goes while the context is still there, in the order the members would.
+		m_SceneManager.reset();
+		m_AssetManager.reset();
+		m_TextureResidency.reset();
+		m_TextureStreamer.reset();
 
 		// Shutdown IMGUI
 		ImGui_ImplOpenGL3_Shutdown();
 		ImGui_ImplGlfw_Shutdown();
 		ImGui::DestroyContext();
+
+		// Shutdown GLFW
+		glfwDestroyWindow(m_Window);
+		glfwTerminate();
 	}
 
 	void Application::Run()
@@ -45,17 +56,13 @@ namespace lei3d
 		LEI_TRACE("Initializing Engine");
 		Initialize();
 
-		LEI_ASSERT(m_ActiveScene != nullptr, "Please make sure a scene is set before running");
+		LEI_ASSERT(SceneManager::HasScenes(), "Please make sure a scene is set before running");
 
 		LEI_TRACE("Entering Frame Loop");
 		while (!glfwWindowShouldClose(m_Window))
 		{
-			// We need to block frame ticking until the new scene has been loaded
-			// Not the most optimal scene loader (may need to look into async loading), but works for now.
-			if (m_SceneManager->NeedsSceneSwitch())
-			{
-				m_SceneManager->LoadNextScene();
-			}
+			// Scenes load on a loading thread while we keep ticking, this only blocks for the final GPU upload.
+			m_SceneManager->UpdateLoading();
 			FrameTick();
 		}
 
@@ -113,6 +120,18 @@ namespace lei3d
 		m_EditorGUI = std::make_unique<EditorGUI>();
 		SetUIActive(false);
 
+		// INIT JOB SYSTEM ------------------------------
+		// Before the scenes, so loading can already use it.
+		m_JobSystem = std::make_unique<JobSystem>();
+		LEI_INFO("Job system running on {0} threads", m_JobSystem->ThreadCount());
+
+		// INIT TEXTURE STREAMING ------------------------------
+		m_TextureStreamer = std::make_unique<TextureStreamer>(m_JobSystem.get());
+		m_TextureResidency = std::make_unique<TextureResidency>();
+
+		// INIT ASSET MANAGER ------------------------------
+		m_AssetManager = std::make_unique<AssetManager>(m_JobSystem.get());
+
 		// CREATE SCENES --------------------------------
 		m_SceneManager = std::make_unique<SceneManager>();
 		m_SceneManager->Init();
@@ -146,41 +165,81 @@ namespace lei3d
 	{
 		// This is called every frame and controls the execution order of everything and frame syncing.
 
-		const auto currentTime = static_cast<float>(glfwGetTime());
-
-		m_DeltaTime = currentTime - m_LastFrameTime;
-		m_LastFrameTime = currentTime;
+		m_DeltaTime = m_FramePacer.BeginFrame();
+		m_FrameAllocator.BeginFrame();
+		const uint64_t allocationsAtStart = AllocationTracker::GetAllocationCount();
 
 		glfwPollEvents();
-		Update();
-		Render();
-		ImGuiRender();
+		m_Input.Sample();
+		ProcessInputEvents();
 
-		glfwSwapBuffers(m_Window);
+		// Mip levels the last frame needed (or no longer does) get queued or evicted, then textures uploaded since last
+		// frame (or still streaming) get the next slice of their data.
+		TextureResidency::Update();
+		TextureStreamer::Update();
 
-		// Sync FPS to desired value
-		const float currentDrawTime = (float)glfwGetTime() - currentTime;
-		const float sleepTime = 1.0f / m_DesiredFPS - currentDrawTime;
+		// Until the first scene is done loading there is nothing to update or render, just the loading screen.
+		const bool hasScene = SceneManager::HasActiveScene();
+		if (hasScene)
+		{
+			Update();
+		}
 
-		typedef std::chrono::duration<int, std::milli> ms;
+		// Mouse look is applied straight from the cursor callback, so polling again here gets the camera the input
+		// that came in while we were updating. Everything else waits in the Input queue until the next Sample.
+		if (m_FramePacer.LateInputSampling())
+		{
+			glfwPollEvents();
+		}
 
-		const ms sleepDuration = ms((int)(sleepTime * 1000));
-		if (sleepTime > 0.0f)
+		if (hasScene)
 		{
-			// Note: Need to fix, currently doesn't cap at the right fps.
-			std::this_thread::sleep_for(sleepDuration);
-			//_sleep(sleepTime);    //Platform Dependent
+			Render();
 		}
+		else
+		{
+			GLCall(glClearColor(0.0f, 0.0f, 0.0f, 1.0f));
+			GLCall(glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT));
+		}
+		ImGuiRender();
+
+		glfwSwapBuffers(m_Window);
+
+		m_LastFrameAllocations = AllocationTracker::GetAllocationCount() - allocationsAtStart;
+		m_FramePacer.WaitForNextFrame();
 	}
 
 	void Application::Update()
 	{
 		Scene& scene = m_SceneManager->ActiveScene();
+
+		// Simulate first so per frame code (like cameras following the player) sees this frame's interpolated transforms.
+		FixedUpdate(scene);
 		scene.Update();
-		scene.PhysicsUpdate();
 		m_SceneView->Update(scene);
 	}
 
+	void Application::FixedUpdate(Scene& scene)
+	{
+		m_FixedTimeAccumulator += m_DeltaTime;
+
+		int ticks = 0;
+		while (m_FixedTimeAccumulator >= FIXED_DELTA_TIME && ticks < m_MaxCatchUpTicks)
+		{
+			scene.PhysicsUpdate();
+			m_FixedTimeAccumulator -= FIXED_DELTA_TIME;
+			ticks++;
+		}
+
+		if (ticks == m_MaxCatchUpTicks)
+		{
+			// We fell behind (hitch, scene load, breakpoint...). Slow down instead of trying to catch up forever.
+			m_FixedTimeAccumulator = std::fmod(m_FixedTimeAccumulator, FIXED_DELTA_TIME);
+		}
+
+		scene.InterpolateTransforms(m_FixedTimeAccumulator / FIXED_DELTA_TIME);
+	}
+
 	void Application::SetUIActive(bool uiActive)
 	{
 		m_UIActive = uiActive;
@@ -202,16 +261,44 @@ namespace lei3d
 		ImGui_ImplGlfw_NewFrame();
 		ImGui::NewFrame();
 
-		if (m_UIActive)
+		if (m_UIActive && SceneManager::HasActiveScene())
 		{
 			m_EditorGUI->RenderUI();
 		}
 
+		if (SceneManager::IsLoading())
+		{
+			RenderLoadingScreen();
+		}
+
 		ImGui::Render();
 		ImDrawData* drawData = ImGui::GetDrawData();
 		ImGui_ImplOpenGL3_RenderDrawData(drawData);
 	}
 
+	void Application::RenderLoadingScreen()
+	{
+		// Full screen while there's nothing else to show, otherwise a small box over the scene that is still running.
+		const bool		 fullScreen = !SceneManager::HasActiveScene();
+		const ImGuiIO&	 io = ImGui::GetIO();
+		const ImVec2	 size = fullScreen ? io.DisplaySize : ImVec2(300.0f, 0.0f);
+		const ImVec2	 position = fullScreen ? ImVec2(0.0f, 0.0f) : ImVec2(io.DisplaySize.x - size.x - 10.0f, io.DisplaySize.y - 60.0f);
+		ImGuiWindowFlags windowFlags = ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_NoMove | ImGuiWindowFlags_NoSavedSettings | ImGuiWindowFlags_NoInputs;
+
+		ImGui::SetNextWindowPos(position);
+		ImGui::SetNextWindowSize(size);
+		if (ImGui::Begin("Loading", nullptr, windowFlags))
+		{
+			if (fullScreen)
+			{
+				ImGui::SetCursorPosY(size.y * 0.5f);
+			}
+			ImGui::Text("Loading %s...", SceneManager::GetLoadingSceneName().c_str());
+			ImGui::ProgressBar(SceneManager::GetLoadProgress(), ImVec2(-1.0f, 0.0f));
+		}
+		ImGui::End();
+	}
+
 	SceneView& Application::GetSceneView()
 	{
 		return *s_Instance->m_SceneView;
@@ -222,6 +309,11 @@ namespace lei3d
 		return s_Instance->m_PrimitiveRenderer;
 	}
 
+	JobSystem& Application::GetJobSystem()
+	{
+		return *s_Instance->m_JobSystem;
+	}
+
 	// TODO: Put into input class
 	void Application::SetupInputCallbacks()
 	{
@@ -241,16 +333,21 @@ namespace lei3d
 				ImGui_ImplGlfw_CursorPosCallback(window, x, y);
 			}
 
+			Application* self = static_cast<Application*>(glfwGetWindowUserPointer(window));
+			if (self)
+			{
+				self->m_Input.OnCursorPos(x, y);
+			}
+
 			ImGuiIO& io = ImGui::GetIO();
 			if (!io.WantCaptureMouse)
 			{
 				// Do mouse position things in game
 				// Only pass data to the app if ImGui is not using it.
-
-				Application* self = static_cast<Application*>(glfwGetWindowUserPointer(window));
+				// Mouse look skips the Input queue so it can use the newest cursor position (see FrameTick).
 				if (self)
 				{
-					if (cursorDisabled)
+					if (cursorDisabled && SceneManager::HasActiveScene())
 					{
 						Camera& sceneCamera = Application::GetSceneCamera();
 						sceneCamera.cameraMouseCallback(x, y);
@@ -262,40 +359,49 @@ namespace lei3d
 		glfwSetMouseButtonCallback(m_Window, [](GLFWwindow* window, int button, int action, int mods) {
 			ImGui_ImplGlfw_MouseButtonCallback(window, button, action, mods);
 
-			ImGuiIO& io = ImGui::GetIO();
-			if (!io.WantCaptureMouse)
+			Application* self = static_cast<Application*>(glfwGetWindowUserPointer(window));
+			if (self)
 			{
-				// Do Mouse Button things in game
+				self->m_Input.OnMouseButton(button, action, mods, ImGui::GetIO().WantCaptureMouse);
 			}
 		});
 
 		glfwSetKeyCallback(m_Window, [](GLFWwindow* window, int key, int scancode, int action, int mods) {
 			ImGui_ImplGlfw_KeyCallback(window, key, scancode, action, mods);
 
-			ImGuiIO& io = ImGui::GetIO();
-			if (!io.WantCaptureKeyboard)
+			Application* self = static_cast<Application*>(glfwGetWindowUserPointer(window));
+			if (self)
 			{
-				// Do cursor position things in game
-				Application* self = static_cast<Application*>(glfwGetWindowUserPointer(window));
-				if (self)
+				self->m_Input.OnKey(key, action, mods, ImGui::GetIO().WantCaptureKeyboard);
+			}
+		});
+	}
+
+	void Application::ProcessInputEvents()
+	{
+		for (const InputEvent& event : m_Input.Events())
+		{
+			if (event.type == INPUT_KEY)
+			{
+				ProcessKeyboardInput(event);
+				if (SceneManager::HasActiveScene())
 				{
-					self->ProcessKeyboardInput(window, key, scancode, action, mods);
-					self->m_SceneView->ProcessKeyboardInput(window, key, scancode, action, mods);
+					m_SceneView->ProcessKeyboardInput(event);
 				}
 			}
-		});
+		}
 	}
 
-	void Application::ProcessKeyboardInput(GLFWwindow* window, int key, int scancode, int action, int mods)
+	void Application::ProcessKeyboardInput(const InputEvent& event)
 	{
 		// gracefully exit on escape
-		if (key == GLFW_KEY_ESCAPE && action == GLFW_PRESS)
+		if (event.code == GLFW_KEY_ESCAPE && event.action == GLFW_PRESS)
 		{
-			glfwSetWindowShouldClose(window, true);
+			glfwSetWindowShouldClose(m_Window, true);
 		}
 
 		//Editor Specific Controls
-		if (key == GLFW_KEY_TAB && action == GLFW_PRESS)
+		if (event.code == GLFW_KEY_TAB && event.action == GLFW_PRESS)
 		{
 			SetUIActive(!m_UIActive);
 		}
@@ -311,4 +417,39 @@ namespace lei3d
 		return s_Instance->m_DeltaTime;
 	}
 
+	FramePacer& Application::GetFramePacer()
+	{
+		return s_Instance->m_FramePacer;
+	}
+
+	FrameAllocator& Application::GetFrameAllocator()
+	{
+		return s_Instance->m_FrameAllocator;
+	}
+
+	uint64_t Application::LastFrameAllocations()
+	{
+		return s_Instance->m_LastFrameAllocations;
+	}
+
+	const Input& Application::GetInput()
+	{
+		return s_Instance->m_Input;
+	}
+
+	float Application::FixedDeltaTime()
+	{
+		return FIXED_DELTA_TIME;
+	}
+
+	int Application::GetMaxCatchUpTicks()
+	{
+		return s_Instance->m_MaxCatchUpTicks;
+	}
+
+	void Application::SetMaxCatchUpTicks(int maxTicks)
+	{
+		s_Instance->m_MaxCatchUpTicks = std::max(1, maxTicks);
+	}
+
 } // namespace lei3d
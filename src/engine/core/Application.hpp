@@ -1,5 +1,10 @@
 #pragma once
 
+#include "core/AssetManager.hpp"
+#include "core/FrameAllocator.hpp"
+#include "core/FramePacer.hpp"
+#include "core/Input.hpp"
+#include "core/JobSystem.hpp"
 #include "core/SceneManager.hpp"
 #include "core/SceneView.hpp"
 
@@ -7,6 +12,8 @@
 
 #include "rendering/PrimitiveRenderer.hpp"
 #include "rendering/RenderSystem.hpp"
+#include "rendering/TextureResidency.hpp"
+#include "rendering/TextureStreamer.hpp"
 
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
@@ -21,9 +28,6 @@
 #include <vector>
 #include "audio/AudioPlayer.hpp"
 
-#include <chrono>
-#include <thread>
-
 namespace lei3d
 {
 	class AppGUI;
@@ -40,10 +44,16 @@ namespace lei3d
 		GLFWwindow* m_Window = nullptr;
 
 		// TODO: Refactor things into editor/game
-		std::unique_ptr<EditorGUI>	  m_EditorGUI;
-		std::unique_ptr<SceneManager> m_SceneManager;
-		std::unique_ptr<AudioPlayer>  m_AudioPlayer;
-		std::unique_ptr<SceneView>	  m_SceneView;
+		std::unique_ptr<EditorGUI>		  m_EditorGUI;
+		std::unique_ptr<JobSystem>		  m_JobSystem;		 // Before AssetManager and SceneManager, so it outlives any load still running.
+		std::unique_ptr<TextureStreamer>  m_TextureStreamer;	 // Before AssetManager, so textures still streaming can cancel.
+		std::unique_ptr<TextureResidency> m_TextureResidency; // Before AssetManager too, textures unregister when destroyed.
+		std::unique_ptr<AssetManager>	  m_AssetManager;	 // Before SceneManager, so it outlives the scenes holding assets.
+		std::unique_ptr<SceneManager>	  m_SceneManager;
+		std::unique_ptr<AudioPlayer>	  m_AudioPlayer;
+		std::unique_ptr<SceneView>		  m_SceneView;
+
+		Input m_Input; // Filled by the GLFW callbacks, sampled once per frame.
 
 		//Should we keep these on the stack? idk
 		RenderSystem	  m_Renderer;
@@ -52,10 +62,16 @@ namespace lei3d
 		// NOTE: Don't modify this directly. Use SetUIActive.
 		bool m_UIActive = false;
 
-		float m_LastFrameTime = 0.0f; // used to keep track of delta time
-		float m_DeltaTime = 0.0f;	  // Total time for last frame.
-		float m_DesiredFPS =
-			120.0f; // FPS will be capped to this value. (current bug means that the FPS cap is half, not sure why)
+		FramePacer m_FramePacer = FramePacer(120.0f); // Caps the FPS and keeps frame time stats.
+		float	   m_DeltaTime = 0.0f;					// Total time for last frame.
+
+		FrameAllocator m_FrameAllocator;		   // Transient per frame data. Reset at the start of every FrameTick.
+		uint64_t	   m_LastFrameAllocations = 0; // Heap allocations during the last frame, if LEI_TRACK_ALLOCATIONS is on.
+
+		// Physics and other PhysicsUpdate code run at a fixed rate, independent of the frame rate.
+		static constexpr float FIXED_DELTA_TIME = 1.0f / 128.0f; // 128 Hz, the usual tick rate for surf.
+		float				   m_FixedTimeAccumulator = 0.0f;	 // Frame time not simulated yet.
+		int					   m_MaxCatchUpTicks = 8;			 // Ticks per frame at most. After a hitch we drop time rather than spiral.
 	public:
 		Application();
 		~Application();
@@ -66,8 +82,16 @@ namespace lei3d
 
 		static GLFWwindow*		  Window();
 		static float			  DeltaTime();
+		static float			  FixedDeltaTime();
+		static int				  GetMaxCatchUpTicks();
+		static void				  SetMaxCatchUpTicks(int maxTicks);
 		static SceneView&		  GetSceneView();
 		static PrimitiveRenderer& GetPrimitiveRenderer();
+		static JobSystem&		  GetJobSystem();
+		static const Input&		  GetInput();
+		static FramePacer&		  GetFramePacer();
+		static FrameAllocator&	  GetFrameAllocator();
+		static uint64_t			  LastFrameAllocations();
 
 		static inline Camera& GetSceneCamera()
 		{
@@ -79,10 +103,13 @@ namespace lei3d
 		void FrameTick();  // Called every frame
 
 		void Update();
+		void FixedUpdate(Scene& scene);
 		void Render();
 		void ImGuiRender();
+		void RenderLoadingScreen();
 
 		void SetupInputCallbacks();
-		void ProcessKeyboardInput(GLFWwindow* window, int key, int scancode, int action, int mods);
+		void ProcessInputEvents();
+		void ProcessKeyboardInput(const InputEvent& event);
 	};
 } // namespace lei3d
\ No newline at end of file
@@ -0,0 +1,265 @@
+#include "AssetManager.hpp"
+
+#include "logging/GLDebug.hpp"
+#include "logging/Log.hpp"
+#include "rendering/CubeMap.hpp"
+#include "rendering/Model.hpp"
+#include "rendering/Shader.hpp"
+#include "rendering/Texture.hpp"
+
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <filesystem>
+
+namespace lei3d
+{
+	AssetManager* AssetManager::s_Instance = nullptr;
+
+	AssetManager::AssetManager(JobSystem* jobs)
+		: m_JobSystem(jobs)
+	{
+		if (s_Instance)
+		{
+			LEI_ERROR("Multiple instances detected. Only one AssetManager should exist.");
+		}
+
+		s_Instance = this;
+	}
+
+	AssetManager::~AssetManager()
+	{
+		for (auto& [id, entry] : m_Assets)
+		{
+			if (entry.asset.use_count() > 1)
+			{
+				LEI_WARN("{0} is still in use while shutting down the AssetManager", entry.name);
+			}
+			Destroy(entry);
+		}
+		s_Instance = nullptr;
+	}
+
+	template <typename T, typename LoadFn>
+	AssetHandle<T> AssetManager::GetOrLoad(AssetType type, const std::string& name, LoadFn load)
+	{
+		const StringId id(name);
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			auto						cached = m_Assets.find(id);
+			if (cached != m_Assets.end())
+			{
+				if (cached->second.type != type)
+				{
+					LEI_ERROR("{0} is already loaded as a {1}, not a {2}", name, GetTypeName(cached->second.type), GetTypeName(type));
+					return nullptr;
+				}
+				cached->second.lastUsed = ++m_UseCounter;
+				m_Stats[type].reused++;
+				m_Stats[type].savedBytes += cached->second.loadedBytes;
+				return std::static_pointer_cast<T>(cached->second.asset);
+			}
+		}
+
+		LEI_TRACE("Loading {0} {1}", GetTypeName(type), name);
+		AssetEntry loaded{ type, name, load() };
+		loaded.loadedBytes = LoadedBytes(loaded); // Nobody else has it yet, so it's fine to look at from this thread.
+
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		auto [entry, inserted] = m_Assets.try_emplace(id, std::move(loaded));
+		if (!inserted && entry->second.type != type)
+		{
+			return nullptr;
+		}
+		// Not inserted: another thread finished loading it first, and ours is dropped here. Only GetModel, GetTexture and
+		// GetCubeMap can race like that (GetShader is main thread only), and those don't have GL objects before Upload.
+		entry->second.lastUsed = ++m_UseCounter;
+		return std::static_pointer_cast<T>(entry->second.asset);
+	}
+
+	AssetHandle<Model> AssetManager::GetModel(const std::string& path)
+	{
+		return s_Instance->GetOrLoad<Model>(ASSET_MODEL, CanonicalPath(path), [&path]() {
+			return std::make_shared<Model>(path, MODEL_LOAD_DEFAULT, s_Instance->m_JobSystem);
+		});
+	}
+
+	AssetHandle<Texture> AssetManager::GetTexture(const std::string& path)
+	{
+		return s_Instance->GetOrLoad<Texture>(ASSET_TEXTURE, CanonicalPath(path), [&path]() {
+			return std::make_shared<Texture>(path);
+		});
+	}
+
+	AssetHandle<CubeMap> AssetManager::GetCubeMap(const std::vector<std::string>& facePaths)
+	{
+		std::string name;
+		for (const std::string& path : facePaths)
+		{
+			name += name.empty() ? CanonicalPath(path) : "|" + CanonicalPath(path);
+		}
+
+		return s_Instance->GetOrLoad<CubeMap>(ASSET_CUBEMAP, name, [&facePaths]() {
+			return std::make_shared<CubeMap>(facePaths, s_Instance->m_JobSystem);
+		});
+	}
+
+	AssetHandle<Shader> AssetManager::GetShader(const std::string& vertexPath, const std::string& fragPath, const std::string& geomPath)
+	{
+		const std::string name = CanonicalPath(vertexPath) + "|" + CanonicalPath(fragPath) + (geomPath.empty() ? "" : "|" + CanonicalPath(geomPath));
+
+		return s_Instance->GetOrLoad<Shader>(ASSET_SHADER, name, [&]() {
+			return std::make_shared<Shader>(vertexPath.c_str(), fragPath.c_str(), geomPath.empty() ? nullptr : geomPath.c_str());
+		});
+	}
+
+	size_t AssetManager::GetMemoryBudget()
+	{
+		return s_Instance->m_MemoryBudget;
+	}
+
+	void AssetManager::SetMemoryBudget(size_t bytes)
+	{
+		std::lock_guard<std::mutex> lock(s_Instance->m_Mutex);
+		s_Instance->m_MemoryBudget = bytes;
+	}
+
+	std::array<AssetTypeStats, ASSET_TYPE_COUNT> AssetManager::GetStats()
+	{
+		std::lock_guard<std::mutex> lock(s_Instance->m_Mutex);
+		return s_Instance->m_Stats;
+	}
+
+	const char* AssetManager::GetTypeName(AssetType type)
+	{
+		switch (type)
+		{
+			case ASSET_MODEL:
+				return "Model";
+			case ASSET_TEXTURE:
+				return "Texture";
+			case ASSET_CUBEMAP:
+				return "CubeMap";
+			case ASSET_SHADER:
+				return "Shader";
+			default:
+				return "Unknown";
+		}
+	}
+
+	void AssetManager::EvictUnused(bool ignoreBudget)
+	{
+		AssetManager&				self = *s_Instance;
+		std::lock_guard<std::mutex> lock(self.m_Mutex);
+
+		size_t totalBytes = 0;
+		for (const auto& [id, entry] : self.m_Assets)
+		{
+			Measure(entry, totalBytes, totalBytes);
+		}
+
+		while (ignoreBudget || totalBytes > self.m_MemoryBudget)
+		{
+			// Unused means the manager's own reference is the only one left.
+			auto leastRecent = self.m_Assets.end();
+			for (auto it = self.m_Assets.begin(); it != self.m_Assets.end(); ++it)
+			{
+				if (it->second.asset.use_count() == 1 && (leastRecent == self.m_Assets.end() || it->second.lastUsed < leastRecent->second.lastUsed))
+				{
+					leastRecent = it;
+				}
+			}
+
+			if (leastRecent == self.m_Assets.end())
+			{
+				break;
+			}
+
+			size_t bytes = 0;
+			Measure(leastRecent->second, bytes, bytes);
+			totalBytes -= std::min(bytes, totalBytes);
+
+			LEI_TRACE("Evicting {0} {1} ({2} KB)", GetTypeName(leastRecent->second.type), leastRecent->second.name, bytes / 1024);
+			Destroy(leastRecent->second);
+			self.m_Assets.erase(leastRecent);
+		}
+
+		for (AssetTypeStats& typeStats : self.m_Stats)
+		{
+			typeStats = { 0, 0, 0, 0, typeStats.reused, typeStats.savedBytes };
+		}
+		for (const auto& [id, entry] : self.m_Assets)
+		{
+			AssetTypeStats& typeStats = self.m_Stats[entry.type];
+			typeStats.count++;
+			typeStats.unused += entry.asset.use_count() == 1;
+			Measure(entry, typeStats.cpuBytes, typeStats.gpuBytes);
+		}
+	}
+
+	std::string AssetManager::CanonicalPath(const std::string& path)
+	{
+		// Falls back to just tidying up the path if it doesn't exist, loading it will complain about that.
+		std::error_code				error;
+		const std::filesystem::path canonical = std::filesystem::weakly_canonical(path, error);
+		return error ? std::filesystem::path(path).lexically_normal().generic_string() : canonical.generic_string();
+	}
+
+	void AssetManager::Measure(const AssetEntry& entry, size_t& cpuBytes, size_t& gpuBytes)
+	{
+		switch (entry.type)
+		{
+			case ASSET_MODEL:
+			{
+				const Model* model = static_cast<const Model*>(entry.asset.get());
+				cpuBytes += model->GetCpuBytes();
+				gpuBytes += model->GetGpuBytes();
+				break;
+			}
+			case ASSET_TEXTURE:
+			{
+				const Texture* texture = static_cast<const Texture*>(entry.asset.get());
+				cpuBytes += texture->GetCpuBytes();
+				gpuBytes += texture->GetGpuBytes();
+				break;
+			}
+			case ASSET_CUBEMAP:
+			{
+				const CubeMap* cubeMap = static_cast<const CubeMap*>(entry.asset.get());
+				cpuBytes += cubeMap->GetCpuBytes();
+				gpuBytes += cubeMap->GetGpuBytes();
+				break;
+			}
+			case ASSET_SHADER:
+			{
+				gpuBytes += static_cast<const Shader*>(entry.asset.get())->getProgramBinarySize();
+				break;
+			}
+			default:
+				break;
+		}
+	}
+
+	size_t AssetManager::LoadedBytes(const AssetEntry& entry)
+	{
+		// Textures are there to be uploaded, so a second copy would have cost VRAM.
+		if (entry.type == ASSET_TEXTURE)
+		{
+			return static_cast<const Texture*>(entry.asset.get())->GetUploadedBytes();
+		}
+
+		size_t bytes = 0;
+		Measure(entry, bytes, bytes);
+		return bytes;
+	}
+
+	void AssetManager::Destroy(AssetEntry& entry)
+	{
+		// Shader is copied around by value elsewhere, so it doesn't delete its program itself.
+		if (entry.type == ASSET_SHADER && entry.asset.use_count() == 1)
+		{
+			GLCall(glDeleteProgram(static_cast<const Shader*>(entry.asset.get())->getShaderID()));
+		}
+		entry.asset.reset();
+	}
+} // namespace lei3d
@@ -0,0 +1,121 @@
+#pragma once
+
+#include "core/StringId.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace lei3d
+{
+	class CubeMap;
+	class JobSystem;
+	class Model;
+	class Shader;
+	class Texture;
+
+	// Shared ownership of a loaded asset. Everything asking for the same file gets the same object.
+	template <typename T>
+	using AssetHandle = std::shared_ptr<T>;
+
+	enum AssetType
+	{
+		ASSET_MODEL,
+		ASSET_TEXTURE,
+		ASSET_CUBEMAP,
+		ASSET_SHADER,
+		ASSET_TYPE_COUNT
+	};
+
+	struct AssetTypeStats
+	{
+		uint32_t count = 0;
+		uint32_t unused = 0; // Only kept alive by the cache, first in line for eviction.
+		size_t	 cpuBytes = 0;
+		size_t	 gpuBytes = 0;
+
+		// Requests served from the cache instead of loading the asset again, and what the extra copies would have
+		// taken (GPU bytes for textures, CPU bytes for the rest). Counted since startup, evicted assets included.
+		uint32_t reused = 0;
+		size_t	 savedBytes = 0;
+	};
+
+	/*
+	 * Loads models, textures, cube maps and shaders once and hands out shared handles to them, so scenes using the same
+	 * backpack.obj or sky box share one copy, and so do models using the same texture file.
+	 * Assets are keyed by the hash (StringId) of their canonical path, so "data/models/a/../b/x.png" and
+	 * "data/models/b/x.png" are the same texture, and finding one is a single hash lookup.
+	 *
+	 * An asset nobody holds a handle to any more stays cached, so going back to a scene doesn't load it again. Once
+	 * everything cached takes more than the memory budget (CPU and GPU bytes together), EvictUnused destroys unused
+	 * assets, least recently requested first. Assets still in use are never evicted, even over budget.
+	 *
+	 * GetModel, GetTexture and GetCubeMap only do CPU work and can be called from the loading thread (or its jobs); the caller uploads on the
+	 * main thread as usual. With a JobSystem they spread that work (mesh conversion, image decoding) across its threads. GetShader compiles, so main thread only. Assets are only ever destroyed by EvictUnused or
+	 * the AssetManager's destructor, both on the main thread, so GL objects never get deleted from the loading thread.
+	 */
+	class AssetManager
+	{
+	private:
+		struct AssetEntry
+		{
+			AssetType			  type;
+			std::string			  name; // Path (or paths) it was loaded from, for the stats.
+			std::shared_ptr<void> asset;
+			uint64_t			  lastUsed = 0;
+			size_t				  loadedBytes = 0; // What loading it again would cost, see AssetTypeStats::savedBytes.
+		};
+
+		static AssetManager* s_Instance;
+
+		JobSystem* m_JobSystem;
+
+		std::mutex								 m_Mutex; // Guards everything below.
+		std::unordered_map<StringId, AssetEntry> m_Assets;
+		uint64_t								 m_UseCounter = 0;
+		size_t									 m_MemoryBudget = 512ull * 1024 * 1024;
+
+		std::array<AssetTypeStats, ASSET_TYPE_COUNT> m_Stats; // As of the last EvictUnused, except reused and savedBytes which are kept up to date.
+
+	public:
+		explicit AssetManager(JobSystem* jobs = nullptr);
+		~AssetManager();
+
+		static AssetHandle<Model>	GetModel(const std::string& path);
+		static AssetHandle<Texture> GetTexture(const std::string& path);
+		static AssetHandle<CubeMap> GetCubeMap(const std::vector<std::string>& facePaths);
+		static AssetHandle<Shader>	GetShader(const std::string& vertexPath, const std::string& fragPath, const std::string& geomPath = "");
+
+		static size_t GetMemoryBudget();
+		static void	  SetMemoryBudget(size_t bytes);
+
+		static std::array<AssetTypeStats, ASSET_TYPE_COUNT> GetStats(); // Counts and bytes as of the last EvictUnused.
+		static const char*									GetTypeName(AssetType type);
+
+		/*
+		 * Evicts unused assets while over budget (or all of them with ignoreBudget), and updates GetStats.
+		 * Main thread, and only while no other thread is loading: measuring an asset reads it. SceneManager calls this
+		 * after every scene switch, which is also when assets stop being used.
+		 */
+		static void EvictUnused(bool ignoreBudget = false);
+
+	private:
+		/*
+		 * Returns the cached asset for key, or loads it with load() (outside the lock, so other threads can keep
+		 * getting cached assets meanwhile). If two threads load the same asset at once, the first one in wins.
+		 */
+		template <typename T, typename LoadFn>
+		AssetHandle<T> GetOrLoad(AssetType type, const std::string& name, LoadFn load);
+
+		static std::string CanonicalPath(const std::string& path);
+
+		static void	  Measure(const AssetEntry& entry, size_t& cpuBytes, size_t& gpuBytes);
+		static size_t LoadedBytes(const AssetEntry& entry);
+		static void Destroy(AssetEntry& entry);
+	};
+} // namespace lei3d
@@ -16,6 +16,8 @@ namespace lei3d
 	public:
 		Component(Entity& entity);
 
+		Entity& GetEntity() const { return m_Entity; }
+
 		virtual void Start() {}
 		virtual void Update() {}
 		virtual void PhysicsUpdate() {}
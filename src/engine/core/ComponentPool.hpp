@@ -0,0 +1,106 @@
+#pragma once
+
+#include "core/ObjectPool.hpp"
+#include "util/TypeName.hpp"
+
+#include <cstdint>
+#include <string>
+#include <utility>
+
+namespace lei3d
+{
+	class Component;
+
+	/*
+	 * Type-erased interface for a ComponentPool so a scene can own the pools of every component type together.
+	 */
+	class ComponentPoolBase
+	{
+	private:
+		std::string m_TypeName;
+
+	public:
+		ComponentPoolBase(std::string typeName)
+			: m_TypeName(std::move(typeName))
+		{
+		}
+		virtual ~ComponentPoolBase() = default;
+
+		const std::string& GetTypeName() const { return m_TypeName; } // For the editor.
+
+		virtual Component*		Get(uint32_t slot) = 0;
+		virtual void			Destroy(uint32_t slot) = 0;
+		virtual uint32_t		Count() const = 0;
+		virtual uint32_t		ChunkCount() const = 0;
+		virtual ObjectPoolStats GetStats() const = 0;
+	};
+
+	/*
+	 * Storage for every component of type C in a scene, on top of an ObjectPool.
+	 *
+	 * Components of the same type sit next to each other in fixed-size chunks, so per-type update loops walk memory
+	 * linearly instead of chasing a pointer per component.
+	 * Component addresses are stable, which we rely on since Bullet actions (see CharacterController) and other
+	 * components hold raw pointers to components.
+	 */
+	template <typename C>
+	class ComponentPool : public ComponentPoolBase
+	{
+	public:
+		static constexpr uint32_t CHUNK_CAPACITY = ObjectPool<C>::CHUNK_CAPACITY;
+
+	private:
+		ObjectPool<C> m_Objects;
+
+	public:
+		ComponentPool()
+			: ComponentPoolBase(TypeNameOf<C>())
+		{
+		}
+
+		template <typename... Args>
+		std::pair<C*, uint32_t> Create(Args&&... args)
+		{
+			return m_Objects.Create(std::forward<Args>(args)...);
+		}
+
+		Component* Get(uint32_t slot) override
+		{
+			return m_Objects.Get(slot);
+		}
+
+		void Destroy(uint32_t slot) override
+		{
+			m_Objects.Destroy(slot);
+		}
+
+		uint32_t Count() const override
+		{
+			return m_Objects.Count();
+		}
+
+		uint32_t ChunkCount() const override
+		{
+			return m_Objects.ChunkCount();
+		}
+
+		ObjectPoolStats GetStats() const override
+		{
+			return m_Objects.GetStats();
+		}
+
+		// See ObjectPool::ForEach.
+		template <typename F>
+		void ForEach(F&& func)
+		{
+			m_Objects.ForEach(func);
+		}
+
+		// See ObjectPool::ForEachInChunks.
+		template <typename F>
+		void ForEachInChunks(uint32_t firstChunk, uint32_t lastChunk, F&& func)
+		{
+			m_Objects.ForEachInChunks(firstChunk, lastChunk, func);
+		}
+	};
+} // namespace lei3d
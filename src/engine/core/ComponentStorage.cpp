@@ -0,0 +1,20 @@
+#include "ComponentStorage.hpp"
+
+namespace lei3d
+{
+	ComponentPoolBase* ComponentStorage::FindPool(ComponentTypeID typeID) const
+	{
+		return m_PoolsByType[typeID];
+	}
+
+	const std::vector<std::unique_ptr<ComponentPoolBase>>& ComponentStorage::GetPools() const
+	{
+		return m_Pools;
+	}
+
+	void ComponentStorage::Clear()
+	{
+		m_PoolsByType.fill(nullptr);
+		m_Pools.clear();
+	}
+} // namespace lei3d
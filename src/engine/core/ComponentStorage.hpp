@@ -0,0 +1,55 @@
+#pragma once
+
+#include "core/ComponentPool.hpp"
+#include "core/ComponentType.hpp"
+
+#include <array>
+#include <memory>
+#include <vector>
+
+namespace lei3d
+{
+	/*
+	 * Owns one ComponentPool per component type used in a scene.
+	 * Entities allocate their components from here (see Entity::AddComponent) and the SystemRegistry runs the
+	 * per-phase update loops over its pools one component type at a time.
+	 */
+	class ComponentStorage
+	{
+	private:
+		std::array<ComponentPoolBase*, MAX_COMPONENT_TYPES> m_PoolsByType{}; // Indexed by ComponentTypeID.
+		std::vector<std::unique_ptr<ComponentPoolBase>>		m_Pools;
+
+	public:
+		ComponentStorage() = default;
+		ComponentStorage(const ComponentStorage&) = delete;
+		ComponentStorage& operator=(const ComponentStorage&) = delete;
+
+		template <typename C>
+		ComponentPool<C>& GetPool()
+		{
+			if (ComponentPool<C>* pool = FindPool<C>())
+			{
+				return *pool;
+			}
+
+			auto* pool = new ComponentPool<C>();
+			m_Pools.emplace_back(pool);
+			m_PoolsByType[GetComponentTypeID<C>()] = pool;
+			return *pool;
+		}
+
+		template <typename C>
+		ComponentPool<C>* FindPool()
+		{
+			return static_cast<ComponentPool<C>*>(m_PoolsByType[GetComponentTypeID<C>()]);
+		}
+
+		ComponentPoolBase* FindPool(ComponentTypeID typeID) const;
+
+		// Every pool created so far, in creation order.
+		const std::vector<std::unique_ptr<ComponentPoolBase>>& GetPools() const;
+
+		void Clear();
+	};
+} // namespace lei3d
@@ -0,0 +1,17 @@
+#include "ComponentType.hpp"
+
+#include "logging/Log.hpp"
+
+#include <atomic>
+
+namespace lei3d
+{
+	ComponentTypeID NextComponentTypeID()
+	{
+		static std::atomic<ComponentTypeID> s_NextID = 0;
+
+		const ComponentTypeID id = s_NextID++;
+		LEI_ASSERT(id < MAX_COMPONENT_TYPES, "Too many component types. Increase MAX_COMPONENT_TYPES.");
+		return id;
+	}
+} // namespace lei3d
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <bitset>
+#include <cstdint>
+
+namespace lei3d
+{
+	using ComponentTypeID = uint32_t;
+
+	// Bump this if we ever have more component types than this. Entities store one bit per type.
+	constexpr ComponentTypeID MAX_COMPONENT_TYPES = 32;
+
+	using ComponentMask = std::bitset<MAX_COMPONENT_TYPES>;
+
+	ComponentTypeID NextComponentTypeID();
+
+	/*
+	 * Returns a small dense index for component type C, usable to index arrays and bitmasks without RTTI.
+	 * Each type gets its ID the first time this is called for it, and keeps it for the lifetime of the program.
+	 */
+	template <typename C>
+	ComponentTypeID GetComponentTypeID()
+	{
+		static const ComponentTypeID id = NextComponentTypeID();
+		return id;
+	}
+
+	template <typename... Cs>
+	ComponentMask MakeComponentMask()
+	{
+		ComponentMask mask;
+		(mask.set(GetComponentTypeID<Cs>()), ...);
+		return mask;
+	}
+} // namespace lei3d
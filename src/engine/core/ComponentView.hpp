@@ -0,0 +1,58 @@
+#pragma once
+
+#include "core/ComponentStorage.hpp"
+#include "core/ComponentType.hpp"
+#include "core/Entity.hpp"
+
+namespace lei3d
+{
+	/*
+	 * Iterates every entity in a scene that has all of the components First, Rest...
+	 *
+	 * Iteration walks the pool of First linearly and filters on each entity's component mask, so put the rarest
+	 * component type first. Get one through Scene::View<...>().
+	 *
+	 * Usage:
+	 *     scene.View<ModelInstance>().ForEach([](Entity& entity, ModelInstance& model) { ... });
+	 */
+	template <typename First, typename... Rest>
+	class ComponentView
+	{
+	private:
+		ComponentStorage& m_Storage;
+
+	public:
+		ComponentView(ComponentStorage& storage)
+			: m_Storage(storage)
+		{
+		}
+
+		template <typename F>
+		void ForEach(F&& func)
+		{
+			ComponentPool<First>* pool = m_Storage.FindPool<First>();
+			if (pool == nullptr)
+			{
+				return;
+			}
+
+			if constexpr (sizeof...(Rest) == 0)
+			{
+				pool->ForEach([&func](First& component) {
+					func(component.GetEntity(), component);
+				});
+			}
+			else
+			{
+				const ComponentMask required = MakeComponentMask<Rest...>();
+				pool->ForEach([&func, &required](First& component) {
+					Entity& entity = component.GetEntity();
+					if ((entity.GetComponentMask() & required) == required)
+					{
+						func(entity, component, *entity.GetComponent<Rest>()...);
+					}
+				});
+			}
+		}
+	};
+} // namespace lei3d
@@ -1,5 +1,7 @@
 #include "Entity.hpp"
 
+#include "core/Scene.hpp"
+
 #include "logging/Log.hpp"
 #include "logging/LogGLM.hpp"
 
@@ -9,135 +11,161 @@
 
 namespace lei3d
 {
-	Entity::Entity()
-	{
-		m_Name = "Unnamed";
-	}
-
-	Entity::Entity(const std::string& name)
+	Entity::Entity(Scene& scene, EntityHandle handle, const std::string& name)
+		: m_Scene(scene), m_Handle(handle), m_ComponentStorage(scene.m_ComponentStorage)
 	{
 		m_Name = name;
+		m_ComponentIndices.fill(NO_COMPONENT);
 	}
 
 	Entity::~Entity()
 	{
 		OnDestroy();
+
+		// Hand the component slots back to their pools.
+		for (auto& record : m_Components)
+		{
+			record.pool->Destroy(record.slot);
+		}
 	}
 
 	void Entity::Start()
 	{
 		LEI_TRACE("Started Entity");
 
-		for (auto& component : m_Components)
+		for (auto& record : m_Components)
 		{
-			component->Start();
+			record.component->Start();
 		}
 	}
 
-	void Entity::Update()
+	void Entity::Render()
 	{
-		for (auto& component : m_Components)
+		for (auto& record : m_Components)
 		{
-			component->Update();
+			record.component->Render();
 		}
 	}
 
-	void Entity::PhysicsUpdate()
+	void Entity::OnDestroy()
 	{
-		for (auto& component : m_Components)
+		for (auto& record : m_Components)
 		{
-			component->PhysicsUpdate();
+			record.component->OnDestroy();
 		}
 	}
 
-	void Entity::Render()
+	void Entity::OnReset()
 	{
-		for (auto& component : m_Components)
+		for (auto& record : m_Components)
 		{
-			component->Render();
+			record.component->OnReset();
 		}
 	}
 
-	void Entity::OnDestroy()
+	const std::string& Entity::GetName() const
 	{
-		for (auto& component : m_Components)
-		{
-			component->OnDestroy();
-		}
+		return m_Name;
 	}
 
-	void Entity::OnReset()
+	void Entity::SetName(const std::string& name)
 	{
-		for (auto& component : m_Components)
+		if (name != m_Name)
 		{
-			component->OnReset();
+			m_Scene.RenameEntity(*this, name);
 		}
 	}
 
-	void Entity::OnEditorUpdate()
+	EntityHandle Entity::GetHandle() const
 	{
-		for (auto& component : m_Components)
-		{
-			component->OnEditorUpdate();
-		}
+		return m_Handle;
 	}
 
-	const std::string& Entity::GetName() const
+	const ComponentMask& Entity::GetComponentMask() const
 	{
-		return m_Name;
+		return m_ComponentMask;
 	}
 
-	void Entity::SetName(const std::string& name)
+	Transform Entity::GetTransform() const
 	{
-		m_Name = name;
+		return m_Scene.m_TransformSystem.GetLocal(m_Handle);
+	}
+
+	glm::vec3 Entity::GetPosition() const
+	{
+		return GetTransform().position;
+	}
+
+	glm::quat Entity::GetRotation() const
+	{
+		return GetTransform().rotation;
+	}
+
+	float Entity::GetYawRotation() const
+	{
+		return GetTransform().GetYawRotation();
+	}
+
+	glm::vec3 Entity::GetScale() const
+	{
+		return GetTransform().scale;
 	}
 
 	void Entity::SetPosition(const glm::vec3& position)
 	{
-		m_Transform.position = position;
+		m_Scene.m_TransformSystem.SetPosition(m_Handle, position);
+	}
+
+	void Entity::SetRotation(const glm::quat& rotation)
+	{
+		m_Scene.m_TransformSystem.SetRotation(m_Handle, rotation);
 	}
 
 	void Entity::SetScale(const glm::vec3& scale)
 	{
-		m_Transform.scale = scale;
+		m_Scene.m_TransformSystem.SetScale(m_Handle, scale);
 	}
 
 	void Entity::SetYawRotation(const float yawRotation)
 	{
-		m_Transform.yawRotation = yawRotation;
+		Transform transform;
+		transform.SetYawRotation(yawRotation);
+		SetRotation(transform.rotation);
+	}
+
+	void Entity::SetParent(Entity* parent)
+	{
+		m_Scene.m_TransformSystem.SetParent(m_Handle, parent ? parent->m_Handle : EntityHandle{});
+	}
+
+	Entity* Entity::GetParent() const
+	{
+		return m_Scene.GetEntity(m_Scene.m_TransformSystem.GetParent(m_Handle));
 	}
 
 	glm::mat4 Entity::GetTranslationMat() const
 	{
-		return glm::translate(glm::identity<glm::mat4>(), m_Transform.position);
+		return glm::translate(glm::identity<glm::mat4>(), GetPosition());
 	}
 
 	glm::mat4 Entity::GetRotationMat() const
 	{
-		//TODO: Implement quaternion.
-		return glm::rotate(glm::identity<glm::mat4>(), glm::radians(m_Transform.yawRotation), glm::vec3(0.0f, 1.0f, 0.0f));
+		return glm::mat4_cast(GetRotation());
 	}
 
 	glm::mat4 Entity::GetScaleMat() const
 	{
-		return glm::scale(glm::identity<glm::mat4>(), m_Transform.scale);
+		return glm::scale(glm::identity<glm::mat4>(), GetScale());
 	}
 
-	glm::mat4 Entity::GetModelMat() const
+	const glm::mat4& Entity::GetModelMat() const
 	{
-		glm::mat4 translate = GetTranslationMat();
-		glm::mat4 rotate = GetRotationMat();
-		glm::mat4 scale = GetScaleMat();
-		glm::mat4 model = translate * rotate * scale;
-		// LEI_INFO("TRANSLATE:");
-		// PrintMat4(translate);
-		// LEI_INFO("ROTATE:");
-		// PrintMat4(rotate);
-		// LEI_INFO("SCALE:");
-		// PrintMat4(scale);
-		// LEI_INFO("MODEL: ");
-		// PrintMat4(model);
-		return model;
+		return m_Scene.m_TransformSystem.GetWorldMatrix(m_Handle);
+	}
+
+	const glm::mat4& Entity::GetInterpolatedModelMat() const
+	{
+		return m_Scene.m_TransformSystem.GetRenderMatrix(m_Handle);
 	}
 
 	void Entity::NameGUI()
@@ -169,9 +197,9 @@ namespace lei3d
 		if (ImGui::CollapsingHeader("Transform"))
 		{
 			ImGui::Text("Position");
-			float x = m_Transform.position.x;
-			float y = m_Transform.position.y;
-			float z = m_Transform.position.z;
+			float x = GetPosition().x;
+			float y = GetPosition().y;
+			float z = GetPosition().z;
 
 			constexpr float STEP_FINE = 0.5f;
 			constexpr float STEP_FAST = 10.0f; // Hold down Ctrl to scroll faster.
@@ -182,21 +210,39 @@ namespace lei3d
 			ImGui::InputFloat("z", &z, STEP_FINE, STEP_FAST);
 
 			// NOTE: If the position is not changing, it's probably because the physics engine (or something else) is overwriting it)
-			SetPosition(glm::vec3(x, y, z));
+			if (m_ResetTransform)
+			{
+				SetPosition(glm::vec3(x, y, z));
+			}
+
+			// Edited as euler angles (pitch, yaw, roll) in degrees, stored as a quaternion.
+			ImGui::Text("Rotation");
+			glm::vec3 eulerDegrees = glm::degrees(glm::eulerAngles(GetRotation()));
+			if (ImGui::InputFloat3("Rotation", &eulerDegrees[0]))
+			{
+				SetRotation(glm::quat(glm::radians(eulerDegrees)));
+				m_ResetTransform = true;
+			}
+
+			ImGui::Text("Scale");
+			glm::vec3 scale = GetScale();
+			if (ImGui::InputFloat3("Scale", &scale[0]))
+			{
+				SetScale(scale);
+			}
 		}
 	}
 
 	btTransform Entity::getBTTransform()
 	{
 		btTransform btTrans;
-		btTrans.setIdentity();
-		btTrans.setOrigin(btVector3{ m_Transform.position.x, m_Transform.position.y, m_Transform.position.z });
+		m_Scene.m_TransformSystem.GetWorldBTTransforms(&m_Handle, 1, &btTrans);
 		return btTrans;
 	}
 
 	void Entity::setFromBTTransform(const btTransform& btTrans)
 	{
-		m_Transform.position = btTransformToVec3(btTrans);
+		m_Scene.m_TransformSystem.SetWorldFromBTTransforms(&m_Handle, &btTrans, 1);
 	}
 
 	void Entity::ShowInspectorGUI()
@@ -206,9 +252,9 @@ namespace lei3d
 		NameGUI();
 		TransformGUI();
 
-		for (auto& component : m_Components)
+		for (auto& record : m_Components)
 		{
-			component->OnImGuiRender();
+			record.component->OnImGuiRender();
 		}
 
 		ImGui::SetWindowSize(ImVec2(300, 800), ImGuiCond_Once);
@@ -1,6 +1,10 @@
 #pragma once
 
 #include "core/Component.hpp"
+#include "core/ComponentStorage.hpp"
+#include "core/ComponentType.hpp"
+#include "core/EntityHandle.hpp"
+#include "core/TransformSystem.hpp"
 #include "logging/Log.hpp"
 #include "rendering/Shader.hpp"
 
@@ -9,61 +13,94 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
+#include <array>
 #include <memory>
 #include <string>
-#include <typeinfo>
 #include <unordered_map>
 
 namespace lei3d
 {
-	struct Transform
-	{
-		glm::vec3 position;
-		float	  yawRotation;
-		glm::vec3 scale;
-	};
-
 	class Component;
+	class Scene;
 	class Shader;
 
 	class Entity
 	{
 	private:
-		std::vector<std::unique_ptr<Component>> m_Components;
-		std::string								m_Name;
+		friend Scene;
+
+		// Where a component of this entity lives inside the scene's ComponentStorage.
+		struct ComponentRecord
+		{
+			Component*		   component;
+			ComponentPoolBase* pool;
+			uint32_t		   slot;
+		};
+
+		static constexpr uint8_t NO_COMPONENT = 0xFF;
+
+		Scene&						 m_Scene;
+		EntityHandle				 m_Handle;
+		ComponentStorage&			 m_ComponentStorage;
+		std::vector<ComponentRecord> m_Components;
+		std::string					 m_Name; // Unique within the scene. Change it through SetName so the scene's name index stays in sync.
+
+		// Sparse index from ComponentTypeID into m_Components, so GetComponent doesn't need to search.
+		ComponentMask							 m_ComponentMask;
+		std::array<uint8_t, MAX_COMPONENT_TYPES> m_ComponentIndices;
 
 	public:
-		Transform m_Transform;
-		bool m_ResetTransform;
+		bool m_ResetTransform = false;
 
-		Entity();
-		Entity(const std::string& name);
+		// Entities should only be created through Scene::AddEntity.
+		Entity(Scene& scene, EntityHandle handle, const std::string& name);
+		Entity(const Entity&) = delete;
+		Entity& operator=(const Entity&) = delete;
 
 		~Entity();
 
+		// Update, PhysicsUpdate and OnEditorUpdate are dispatched per component type by the scene (see SystemRegistry).
 		void Start();
-		void Update();
-		void PhysicsUpdate();
 		void Render();
 		void OnDestroy();
 		void OnReset();
 
-		void OnEditorUpdate();
-
-		glm::mat4 GetTranslationMat() const;
-		glm::mat4 GetRotationMat() const;
-		glm::mat4 GetScaleMat() const;
-		glm::mat4 GetModelMat() const;
+		/*
+		 * Transform:
+		 * The transform lives in the scene's TransformSystem. Positions, rotations and scales are local (relative to the
+		 * parent entity, if there is one), while GetModelMat and the Bullet conversions are in world space.
+		 */
+		Transform GetTransform() const;
+		glm::vec3 GetPosition() const;
+		glm::quat GetRotation() const;
+		float	  GetYawRotation() const;
+		glm::vec3 GetScale() const;
+
+		glm::mat4		 GetTranslationMat() const;
+		glm::mat4		 GetRotationMat() const;
+		glm::mat4		 GetScaleMat() const;
+		const glm::mat4& GetModelMat() const; // Cached, only recomputed when this entity or one of its parents moves.
+		const glm::mat4& GetInterpolatedModelMat() const; // What to render: GetModelMat blended between the last two fixed ticks.
 
 		void SetPosition(const glm::vec3& position);
+		void SetRotation(const glm::quat& rotation);
 		void SetScale(const glm::vec3& scale);
-		void SetYawRotation(const float yawRotation);
+		void SetYawRotation(const float yawRotation); // Replaces the whole rotation with one around the up axis.
 
+		// Pass nullptr to detach from the current parent.
+		void	SetParent(Entity* parent);
+		Entity* GetParent() const;
+
+		// World space position and rotation. Scale isn't part of a btTransform, it goes on the collision shape.
 		btTransform getBTTransform();
 		void		setFromBTTransform(const btTransform& btTrans);
 
+		EntityHandle GetHandle() const;
+
 		const std::string& GetName() const;
-		void			   SetName(const std::string& name);
+		void			   SetName(const std::string& name); // Gets a number appended if another entity already has the name.
+
+		const ComponentMask& GetComponentMask() const;
 
 		//TODO: Consider refactoring Editor GUIs to separate class
 		void NameGUI();
@@ -74,32 +111,42 @@ namespace lei3d
 		 * Component System:
 		 * Components should always be added through AddComponent<C> and returned through GetComponent<C>.
 		 * These work essentially the same as in Unity.
+		 * Components are allocated from the scene's ComponentStorage, so all components of one type are stored together.
 		 * DO NOT Call the Constructor for a Component or any of it's subclasses. Always use add Component.
 		 * If you need to initialize a component with data, use an Init function (see SkyBox.cpp for an example)
 		 */
 
 		/*
-		 * Will return component attached to this entity of type C.
-		 * If there are multiple components of the same type, it will return the first one found.
+		 * Will return component attached to this entity of type C, or nullptr if there is none.
+		 * C has to be the exact type the component was added as (lookups go through GetComponentTypeID, not RTTI).
+		 * If there are multiple components of the same type, it will return the first one added.
 		 */
 		template <typename C>
 		C* GetComponent()
 		{
 			static_assert(std::is_convertible<C, Component>::value, "C must be a component type");
 
-			//(may need GetComponents if we have multiple)
-			for (auto& c : m_Components)
+			const ComponentTypeID typeID = GetComponentTypeID<C>();
+			if (!m_ComponentMask.test(typeID))
 			{
-				// Component& cRef = *c;
-				if (auto* casted = dynamic_cast<C*>(c.get()))
-				{
-					// returns the first match
-					return static_cast<C*>(c.get());
-				}
+				return nullptr;
 			}
 
-			// LEI_ERROR("Could not find component.");
-			return nullptr;
+			return static_cast<C*>(m_Components[m_ComponentIndices[typeID]].component);
+		}
+
+		template <typename C>
+		bool HasComponent() const
+		{
+			static_assert(std::is_convertible<C, Component>::value, "C must be a component type");
+
+			return m_ComponentMask.test(GetComponentTypeID<C>());
+		}
+
+		template <typename... Cs>
+		bool HasComponents() const
+		{
+			return (HasComponent<Cs>() && ...);
 		}
 
 		/*
@@ -112,11 +159,18 @@ namespace lei3d
 			// If this is hitting, check that your component is using "public" for inheritance.
 			static_assert(std::is_convertible<C, Component>::value, "C must be a component type.");
 
-			std::unique_ptr<C> c = std::make_unique<C>(*this);
-			m_Components.push_back(std::move(c));
-			// The element was just added at the back of the component list, so we retrieve it from the back here.
-			// Note: We cannot use c since it got moved into the list.
-			return static_cast<C*>(m_Components.back().get());
+			ComponentPool<C>& pool = m_ComponentStorage.GetPool<C>();
+			auto [c, slot] = pool.Create(*this);
+			m_Components.push_back({ c, &pool, slot });
+
+			const ComponentTypeID typeID = GetComponentTypeID<C>();
+			if (!m_ComponentMask.test(typeID))
+			{
+				m_ComponentMask.set(typeID);
+				m_ComponentIndices[typeID] = static_cast<uint8_t>(m_Components.size() - 1);
+			}
+
+			return c;
 		}
 	};
 } // namespace lei3d
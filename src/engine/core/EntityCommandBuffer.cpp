@@ -0,0 +1,53 @@
+#include "EntityCommandBuffer.hpp"
+
+#include "core/Scene.hpp"
+
+namespace lei3d
+{
+	EntityCommandBuffer::EntityCommandBuffer(Scene& scene)
+		: m_Scene(scene)
+	{
+	}
+
+	EntityHandle EntityCommandBuffer::Create(std::string_view name)
+	{
+		const EntityHandle handle = m_Scene.ReserveEntityHandle();
+
+		EntityCommand command{ ENTITY_COMMAND_CREATE, handle };
+		command.nameLength = static_cast<uint32_t>(name.size());
+
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		command.nameOffset = static_cast<uint32_t>(m_Names.size());
+		m_Names.insert(m_Names.end(), name.begin(), name.end());
+		m_Commands.push_back(command);
+		return handle;
+	}
+
+	void EntityCommandBuffer::Destroy(EntityHandle handle)
+	{
+		Record({ ENTITY_COMMAND_DESTROY, handle });
+	}
+
+	void EntityCommandBuffer::TakeCommands(std::vector<EntityCommand>& commands, std::vector<char>& names)
+	{
+		commands.clear();
+		names.clear();
+
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		std::swap(commands, m_Commands);
+		std::swap(names, m_Names);
+	}
+
+	void EntityCommandBuffer::Clear()
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Commands.clear();
+		m_Names.clear();
+	}
+
+	void EntityCommandBuffer::Record(const EntityCommand& command)
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Commands.push_back(command);
+	}
+} // namespace lei3d
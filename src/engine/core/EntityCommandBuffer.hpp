@@ -0,0 +1,102 @@
+#pragma once
+
+#include "core/Entity.hpp"
+#include "core/EntityHandle.hpp"
+
+#include <cstddef>
+#include <cstring>
+#include <mutex>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace lei3d
+{
+	class Scene;
+
+	enum EntityCommandType
+	{
+		ENTITY_COMMAND_CREATE,
+		ENTITY_COMMAND_DESTROY,
+		ENTITY_COMMAND_ADD_COMPONENT,
+	};
+
+	// Plain data, so recording one never allocates (beyond the buffer growing).
+	struct EntityCommand
+	{
+		static constexpr size_t INIT_CAPACITY = 32; // Bytes a component init callable can capture.
+
+		EntityCommandType type;
+		EntityHandle	  handle;
+
+		// ENTITY_COMMAND_CREATE only. Where the name is in the buffer's name characters.
+		uint32_t nameOffset = 0;
+		uint32_t nameLength = 0;
+
+		// ENTITY_COMMAND_ADD_COMPONENT only. Adds the component to the entity, then runs the init stored in init on it.
+		void (*addComponent)(Entity& entity, const void* init) = nullptr;
+		alignas(std::max_align_t) unsigned char init[INIT_CAPACITY];
+	};
+
+	/*
+	 * Records entity creation and destruction to apply later, so they can be requested while the scene is being
+	 * iterated (from a component update, a physics callback or a job) without invalidating anything.
+	 *
+	 * Recording is thread safe. Create hands out the new entity's handle right away, so later commands (and other
+	 * code) can refer to it, but it only resolves through Scene::GetEntity after the buffer has been flushed.
+	 * The scene flushes once per frame, after its update (see Scene::FlushEntityCommands), applying commands in the
+	 * order they were recorded.
+	 */
+	class EntityCommandBuffer
+	{
+	private:
+		Scene&					   m_Scene;
+		std::mutex				   m_Mutex;
+		std::vector<EntityCommand> m_Commands;
+		std::vector<char>		   m_Names; // The names of every created entity, back to back.
+
+	public:
+		EntityCommandBuffer(Scene& scene);
+		EntityCommandBuffer(const EntityCommandBuffer&) = delete;
+		EntityCommandBuffer& operator=(const EntityCommandBuffer&) = delete;
+
+		EntityHandle Create(std::string_view name);
+		void		 Destroy(EntityHandle handle);
+
+		template <typename C>
+		void AddComponent(EntityHandle handle)
+		{
+			AddComponent<C>(handle, [](C&) {});
+		}
+
+		/*
+		 * init is called with the new component right after it's added, e.g. to call its Init function. It's stored
+		 * in the command by copying its bytes, so it has to be small and trivially copyable: a lambda capturing a few
+		 * pointers or values, not one capturing a std::string or a std::function.
+		 */
+		template <typename C, typename Init>
+		void AddComponent(EntityHandle handle, Init init)
+		{
+			static_assert(std::is_trivially_copyable_v<Init>, "Component init must be trivially copyable.");
+			static_assert(sizeof(Init) <= EntityCommand::INIT_CAPACITY, "Component init captures too much.");
+			static_assert(alignof(Init) <= alignof(std::max_align_t), "Component init is overaligned.");
+
+			EntityCommand command{ ENTITY_COMMAND_ADD_COMPONENT, handle };
+			command.addComponent = [](Entity& entity, const void* data) {
+				C* component = entity.AddComponent<C>();
+				(*static_cast<const Init*>(data))(*component);
+			};
+			std::memcpy(command.init, &init, sizeof(Init));
+			Record(command);
+		}
+
+		// Moves the recorded commands and the names they refer to into the outputs (which are cleared first) and
+		// empties the buffer.
+		void TakeCommands(std::vector<EntityCommand>& commands, std::vector<char>& names);
+
+		void Clear();
+
+	private:
+		void Record(const EntityCommand& command);
+	};
+} // namespace lei3d
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+
+namespace lei3d
+{
+	/*
+	 * Stable reference to an entity in a scene. Resolve it with Scene::GetEntity(EntityHandle).
+	 *
+	 * index is the entity's slot in the scene and generation counts how many times that slot has been reused.
+	 * Once an entity is removed its handle stops resolving (GetEntity returns nullptr), even if a new entity
+	 * takes over the slot. This makes handles safe to cache, unlike Entity pointers or names.
+	 */
+	struct EntityHandle
+	{
+		static constexpr uint32_t INVALID_INDEX = UINT32_MAX;
+
+		uint32_t index = INVALID_INDEX;
+		uint32_t generation = 0;
+
+		bool IsValid() const { return index != INVALID_INDEX; }
+
+		// Packed into one 64 bit value, e.g. for hashing or saving.
+		uint64_t ToU64() const { return (static_cast<uint64_t>(generation) << 32) | index; }
+
+		bool operator==(const EntityHandle& other) const = default;
+	};
+} // namespace lei3d
+
+template <>
+struct std::hash<lei3d::EntityHandle>
+{
+	size_t operator()(const lei3d::EntityHandle& handle) const noexcept
+	{
+		return std::hash<uint64_t>()(handle.ToU64());
+	}
+};
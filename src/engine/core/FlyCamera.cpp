@@ -17,10 +17,10 @@ namespace lei3d
 
 	void FlyCamera::PollCameraMovementInput()
 	{
-		GLFWwindow* const window = Application::Window();
+		const InputSnapshot& input = Application::GetInput().Snapshot();
 
 		float speed = m_FlySpeed;
-		if (glfwGetKey(window, GLFW_KEY_LEFT_SHIFT) == GLFW_PRESS)
+		if (input.IsKeyDown(GLFW_KEY_LEFT_SHIFT))
 		{
 			speed *= 10.0f;
 
@@ -30,27 +30,27 @@ namespace lei3d
 			}
 		}
 
-		if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS)
+		if (input.IsKeyDown(GLFW_KEY_W))
 		{
 			handleForward(speed);
 		}
-		if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS)
+		if (input.IsKeyDown(GLFW_KEY_S))
 		{
 			handleBack(speed);
 		}
-		if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS)
+		if (input.IsKeyDown(GLFW_KEY_A))
 		{
 			handleLeft(speed);
 		}
-		if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS)
+		if (input.IsKeyDown(GLFW_KEY_D))
 		{
 			handleRight(speed);
 		}
-		if (glfwGetKey(window, GLFW_KEY_E) == GLFW_PRESS)
+		if (input.IsKeyDown(GLFW_KEY_E))
 		{
 			handleUp(speed);
 		}
-		if (glfwGetKey(window, GLFW_KEY_Q) == GLFW_PRESS)
+		if (input.IsKeyDown(GLFW_KEY_Q))
 		{
 			handleDown(speed);
 		}
@@ -0,0 +1,90 @@
+#include "FrameAllocator.hpp"
+
+#include "logging/Log.hpp"
+
+#include <algorithm>
+#include <new>
+
+namespace lei3d
+{
+	FrameAllocator::FrameAllocator(size_t capacity)
+	{
+		for (Arena& arena : m_Arenas)
+		{
+			arena.memory = std::make_unique<std::byte[]>(capacity);
+			arena.capacity = capacity;
+		}
+	}
+
+	FrameAllocator::~FrameAllocator()
+	{
+		for (Arena& arena : m_Arenas)
+		{
+			ReleaseOverflow(arena);
+		}
+	}
+
+	void FrameAllocator::BeginFrame()
+	{
+		m_Current = (m_Current + 1) % m_Arenas.size();
+		Arena& arena = m_Arenas[m_Current];
+
+		// Nothing in here is alive anymore, so this is the one point where the arena can be swapped for a bigger one.
+		if (arena.overflowBytes > 0)
+		{
+			const size_t newCapacity = std::max(arena.capacity * 2, arena.offset + arena.overflowBytes);
+			LEI_WARN("Frame allocator ran out of space, growing from {0} to {1} bytes", arena.capacity, newCapacity);
+
+			ReleaseOverflow(arena);
+			arena.memory = std::make_unique<std::byte[]>(newCapacity);
+			arena.capacity = newCapacity;
+			m_OverflowFrames++;
+		}
+
+		arena.offset = 0;
+	}
+
+	void* FrameAllocator::Allocate(size_t size, size_t alignment)
+	{
+		Arena& arena = m_Arenas[m_Current];
+
+		const uintptr_t base = reinterpret_cast<uintptr_t>(arena.memory.get());
+		const uintptr_t aligned = (base + arena.offset + alignment - 1) & ~(uintptr_t(alignment) - 1);
+		const size_t	newOffset = (aligned - base) + size;
+		if (newOffset <= arena.capacity)
+		{
+			arena.offset = newOffset;
+			return reinterpret_cast<void*>(aligned);
+		}
+
+		void* memory = ::operator new(size, std::align_val_t(alignment));
+		arena.overflow.push_back({ memory, alignment });
+		arena.overflowBytes += size + alignment;
+		return memory;
+	}
+
+	size_t FrameAllocator::BytesUsed() const
+	{
+		return m_Arenas[m_Current].offset + m_Arenas[m_Current].overflowBytes;
+	}
+
+	size_t FrameAllocator::Capacity() const
+	{
+		return m_Arenas[m_Current].capacity;
+	}
+
+	uint32_t FrameAllocator::OverflowFrames() const
+	{
+		return m_OverflowFrames;
+	}
+
+	void FrameAllocator::ReleaseOverflow(Arena& arena)
+	{
+		for (const OverflowBlock& block : arena.overflow)
+		{
+			::operator delete(block.memory, std::align_val_t(block.alignment));
+		}
+		arena.overflow.clear();
+		arena.overflowBytes = 0;
+	}
+} // namespace lei3d
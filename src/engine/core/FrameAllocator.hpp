@@ -0,0 +1,113 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace lei3d
+{
+	/*
+	 * Bump allocator for data that only lives for a frame, like the render lists the RenderSystem builds every draw.
+	 *
+	 * Allocating is a pointer bump and nothing is freed individually, the whole arena is dropped at once by BeginFrame.
+	 * There are two arenas that take turns, so anything allocated last frame is still valid for the whole current
+	 * frame, but not after that. Don't keep pointers into it any longer.
+	 *
+	 * Running out of space doesn't fail: the allocation falls back to the heap, and the arena grows to fit at its next
+	 * reset. After a few frames it has settled and frames stop touching the heap.
+	 *
+	 * Main thread only. Jobs can read frame allocations made before they were started but shouldn't allocate.
+	 */
+	class FrameAllocator
+	{
+	public:
+		static constexpr size_t DEFAULT_CAPACITY = 256 * 1024; // Per arena.
+
+	private:
+		struct OverflowBlock
+		{
+			void*  memory;
+			size_t alignment;
+		};
+
+		struct Arena
+		{
+			std::unique_ptr<std::byte[]> memory;
+			size_t						 capacity = 0;
+			size_t						 offset = 0;
+			std::vector<OverflowBlock>	 overflow; // Heap allocations made after the arena filled up.
+			size_t						 overflowBytes = 0;
+		};
+
+		std::array<Arena, 2> m_Arenas;
+		uint32_t			 m_Current = 0;
+		uint32_t			 m_OverflowFrames = 0; // Frames that had to fall back to the heap.
+
+	public:
+		explicit FrameAllocator(size_t capacity = DEFAULT_CAPACITY);
+		FrameAllocator(const FrameAllocator&) = delete;
+		FrameAllocator& operator=(const FrameAllocator&) = delete;
+		~FrameAllocator();
+
+		// Switches to the other arena and empties it. Call once at the start of every frame.
+		void BeginFrame();
+
+		void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+		template <typename T>
+		T* Allocate(size_t count)
+		{
+			return static_cast<T*>(Allocate(count * sizeof(T), alignof(T)));
+		}
+
+		size_t	 BytesUsed() const; // By the current frame.
+		size_t	 Capacity() const;	// Of the current frame's arena.
+		uint32_t OverflowFrames() const;
+
+	private:
+		static void ReleaseOverflow(Arena& arena);
+	};
+
+	/*
+	 * STL allocator on top of a FrameAllocator. deallocate does nothing, memory comes back when the arena resets.
+	 */
+	template <typename T>
+	struct FrameStdAllocator
+	{
+		using value_type = T;
+
+		FrameAllocator* frameAllocator;
+
+		FrameStdAllocator(FrameAllocator& allocator)
+			: frameAllocator(&allocator)
+		{
+		}
+
+		template <typename U>
+		FrameStdAllocator(const FrameStdAllocator<U>& other)
+			: frameAllocator(other.frameAllocator)
+		{
+		}
+
+		T* allocate(size_t n)
+		{
+			return frameAllocator->Allocate<T>(n);
+		}
+
+		void deallocate(T*, size_t)
+		{
+		}
+
+		template <typename U>
+		bool operator==(const FrameStdAllocator<U>& other) const
+		{
+			return frameAllocator == other.frameAllocator;
+		}
+	};
+
+	// Construct with a FrameAllocator: FrameVector<int> ints(Application::GetFrameAllocator());
+	template <typename T>
+	using FrameVector = std::vector<T, FrameStdAllocator<T>>;
+} // namespace lei3d
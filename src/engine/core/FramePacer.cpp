@@ -0,0 +1,116 @@
+#include "FramePacer.hpp"
+
+#include <algorithm>
+#include <thread>
+
+namespace lei3d
+{
+	FramePacer::FramePacer(float targetFPS)
+	{
+		SetTargetFPS(targetFPS);
+		m_FrameStart = Clock::now();
+		m_Deadline = m_FrameStart;
+	}
+
+	void FramePacer::SetTargetFPS(float fps)
+	{
+		if (fps <= 0.0f)
+		{
+			m_TargetFrameTime = Clock::duration::zero();
+			return;
+		}
+
+		m_TargetFrameTime = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / fps));
+	}
+
+	float FramePacer::GetTargetFPS() const
+	{
+		if (m_TargetFrameTime == Clock::duration::zero())
+		{
+			return 0.0f;
+		}
+		return static_cast<float>(1.0 / std::chrono::duration<double>(m_TargetFrameTime).count());
+	}
+
+	void FramePacer::SetLateInputSampling(bool lateInputSampling)
+	{
+		m_LateInputSampling = lateInputSampling;
+	}
+
+	bool FramePacer::LateInputSampling() const
+	{
+		return m_LateInputSampling;
+	}
+
+	float FramePacer::BeginFrame()
+	{
+		const Clock::time_point now = Clock::now();
+		const std::chrono::duration<float> frameTime = now - m_FrameStart;
+		m_FrameStart = now;
+
+		m_FrameTimesMs[m_NextFrameTimeI] = frameTime.count() * 1000.0f;
+		m_NextFrameTimeI = (m_NextFrameTimeI + 1) % FRAME_HISTORY;
+		m_FrameTimeCount = std::min(m_FrameTimeCount + 1, FRAME_HISTORY);
+
+		return frameTime.count();
+	}
+
+	void FramePacer::WaitForNextFrame()
+	{
+		if (m_TargetFrameTime == Clock::duration::zero())
+		{
+			return;
+		}
+
+		// If we're more than a frame late, start the schedule over instead of rushing frames out to catch up.
+		m_Deadline += m_TargetFrameTime;
+		Clock::time_point now = Clock::now();
+		if (m_Deadline < now - m_TargetFrameTime)
+		{
+			m_Deadline = now;
+		}
+
+		// Sleep while we're far enough away that an overshoot won't make us late.
+		while (m_Deadline - now > m_SleepOvershoot)
+		{
+			const Clock::duration sleepTime = m_Deadline - now - m_SleepOvershoot;
+			std::this_thread::sleep_for(sleepTime);
+
+			const Clock::time_point afterSleep = Clock::now();
+			const Clock::duration	overshoot = afterSleep - now - sleepTime;
+
+			// Jump up to new worst cases right away, decay slowly back down when sleeps get more accurate.
+			m_SleepOvershoot = std::max(overshoot, m_SleepOvershoot - m_SleepOvershoot / 64);
+			now = afterSleep;
+		}
+
+		// Spin the rest of the way.
+		while (Clock::now() < m_Deadline)
+		{
+		}
+	}
+
+	FrameTimeStats FramePacer::GetStats() const
+	{
+		FrameTimeStats stats;
+		if (m_FrameTimeCount == 0)
+		{
+			return stats;
+		}
+
+		std::array<float, FRAME_HISTORY> sorted = m_FrameTimesMs;
+		std::sort(sorted.begin(), sorted.begin() + m_FrameTimeCount);
+
+		float total = 0.0f;
+		for (uint32_t i = 0; i < m_FrameTimeCount; i++)
+		{
+			total += sorted[i];
+		}
+
+		stats.p50Ms = sorted[(m_FrameTimeCount - 1) / 2];
+		stats.p99Ms = sorted[(m_FrameTimeCount - 1) * 99 / 100];
+		stats.maxMs = sorted[m_FrameTimeCount - 1];
+		stats.averageMs = total / m_FrameTimeCount;
+		return stats;
+	}
+} // namespace lei3d
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+
+namespace lei3d
+{
+	struct FrameTimeStats
+	{
+		float p50Ms = 0.0f;
+		float p99Ms = 0.0f;
+		float maxMs = 0.0f;
+		float averageMs = 0.0f;
+	};
+
+	/*
+	 * Caps the frame rate and measures frame times.
+	 *
+	 * Waiting is a hybrid of sleeping and spinning on steady_clock: the OS sleep is only accurate to a millisecond or so
+	 * (and usually oversleeps), so we sleep until we're close to the deadline and spin the rest of the way.
+	 * How close is learned from how much sleeps have overshot so far.
+	 * Deadlines are spaced exactly one target frame apart, so small errors don't add up into a lower frame rate.
+	 *
+	 * Also keeps the last FRAME_HISTORY frame times for percentile stats (see the editor's Game Info panel).
+	 */
+	class FramePacer
+	{
+	public:
+		using Clock = std::chrono::steady_clock;
+
+		static constexpr uint32_t FRAME_HISTORY = 240;
+
+	private:
+		Clock::duration	  m_TargetFrameTime = Clock::duration::zero(); // Zero means uncapped.
+		Clock::time_point m_FrameStart;
+		Clock::time_point m_Deadline;
+		Clock::duration	  m_SleepOvershoot = std::chrono::milliseconds(1); // Estimated, starts pessimistic.
+
+		bool m_LateInputSampling = true;
+
+		std::array<float, FRAME_HISTORY> m_FrameTimesMs = {};
+		uint32_t						 m_FrameTimeCount = 0;
+		uint32_t						 m_NextFrameTimeI = 0;
+
+	public:
+		FramePacer(float targetFPS);
+
+		void  SetTargetFPS(float fps); // 0 or less uncaps.
+		float GetTargetFPS() const;
+
+		/*
+		 * When on, the application polls input again right before rendering,
+		 * so the camera uses the newest mouse movement instead of what was there at the start of the frame.
+		 */
+		void SetLateInputSampling(bool lateInputSampling);
+		bool LateInputSampling() const;
+
+		// Call at the very start of the frame. Returns the time since the last frame started, in seconds.
+		float BeginFrame();
+
+		// Call at the end of the frame. Blocks until it's time for the next one.
+		void WaitForNextFrame();
+
+		FrameTimeStats GetStats() const;
+	};
+} // namespace lei3d
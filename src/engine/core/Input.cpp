@@ -0,0 +1,101 @@
+#include "Input.hpp"
+
+#include <utility>
+
+namespace lei3d
+{
+	bool InputSnapshot::IsKeyDown(int key) const
+	{
+		return key >= 0 && key <= GLFW_KEY_LAST && keysDown.test(key);
+	}
+
+	bool InputSnapshot::IsMouseButtonDown(int button) const
+	{
+		return button >= 0 && button <= GLFW_MOUSE_BUTTON_LAST && mouseButtonsDown.test(button);
+	}
+
+	void Input::OnKey(int key, int action, int mods, bool capturedByUI)
+	{
+		// GLFW_KEY_UNKNOWN is -1.
+		if (key < 0 || key > GLFW_KEY_LAST)
+		{
+			return;
+		}
+
+		if (action == GLFW_RELEASE)
+		{
+			m_Live.keysDown.reset(key);
+		}
+		else if (!capturedByUI)
+		{
+			m_Live.keysDown.set(key);
+		}
+
+		if (!capturedByUI)
+		{
+			m_PendingEvents.push_back({ INPUT_KEY, key, action, mods });
+		}
+	}
+
+	void Input::OnMouseButton(int button, int action, int mods, bool capturedByUI)
+	{
+		if (button < 0 || button > GLFW_MOUSE_BUTTON_LAST)
+		{
+			return;
+		}
+
+		if (action == GLFW_RELEASE)
+		{
+			m_Live.mouseButtonsDown.reset(button);
+		}
+		else if (!capturedByUI)
+		{
+			m_Live.mouseButtonsDown.set(button);
+		}
+
+		if (!capturedByUI)
+		{
+			m_PendingEvents.push_back({ INPUT_MOUSE_BUTTON, button, action, mods });
+		}
+	}
+
+	void Input::OnCursorPos(double x, double y)
+	{
+		m_Live.cursorPos = glm::vec2(static_cast<float>(x), static_cast<float>(y));
+	}
+
+	void Input::Sample()
+	{
+		m_PreviousSnapshot = m_Snapshot;
+		m_Live.frame++;
+		m_Snapshot = m_Live;
+
+		std::swap(m_Events, m_PendingEvents);
+		m_PendingEvents.clear();
+	}
+
+	const InputSnapshot& Input::Snapshot() const
+	{
+		return m_Snapshot;
+	}
+
+	bool Input::IsKeyDown(int key) const
+	{
+		return m_Snapshot.IsKeyDown(key);
+	}
+
+	bool Input::WasKeyPressed(int key) const
+	{
+		return m_Snapshot.IsKeyDown(key) && !m_PreviousSnapshot.IsKeyDown(key);
+	}
+
+	bool Input::WasKeyReleased(int key) const
+	{
+		return !m_Snapshot.IsKeyDown(key) && m_PreviousSnapshot.IsKeyDown(key);
+	}
+
+	const std::vector<InputEvent>& Input::Events() const
+	{
+		return m_Events;
+	}
+} // namespace lei3d
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <glm/glm.hpp>
+
+#include <bitset>
+#include <cstdint>
+#include <vector>
+
+namespace lei3d
+{
+	enum InputEventType
+	{
+		INPUT_KEY,
+		INPUT_MOUSE_BUTTON,
+	};
+
+	struct InputEvent
+	{
+		InputEventType type;
+		int			   code; // GLFW_KEY_* or GLFW_MOUSE_BUTTON_*.
+		int			   action; // GLFW_PRESS, GLFW_RELEASE or GLFW_REPEAT.
+		int			   mods;
+	};
+
+	/*
+	 * What the keyboard and mouse looked like at one point in time.
+	 * Gameplay and physics read input only through this, so a tick's behaviour depends on nothing but its snapshot,
+	 * and a recorded sequence of snapshots replays the same way.
+	 */
+	struct InputSnapshot
+	{
+		std::bitset<GLFW_KEY_LAST + 1>			keysDown;
+		std::bitset<GLFW_MOUSE_BUTTON_LAST + 1> mouseButtonsDown;
+		glm::vec2								cursorPos = glm::vec2(0.0f);
+		uint64_t								frame = 0; // Which Sample this came from.
+
+		bool IsKeyDown(int key) const;
+		bool IsMouseButtonDown(int button) const;
+	};
+
+	/*
+	 * Collects input from the GLFW callbacks and hands it out once per frame.
+	 *
+	 * The callbacks only record into a live state and a pending event queue. Sample (called by the Application right
+	 * after polling events) freezes the live state into the snapshot everyone reads for the rest of the frame,
+	 * including every fixed tick, and makes the events that came in since the last Sample available through Events.
+	 * Nothing reads GLFW directly anymore, so the physics step sees the same keys in every substep.
+	 *
+	 * Presses that ImGui wants are dropped, but releases always go through so keys can't get stuck.
+	 */
+	class Input
+	{
+	private:
+		InputSnapshot m_Live;
+		InputSnapshot m_Snapshot;
+		InputSnapshot m_PreviousSnapshot;
+
+		// Swapped on Sample. Both keep their capacity, so a frame's events don't allocate.
+		std::vector<InputEvent> m_PendingEvents;
+		std::vector<InputEvent> m_Events;
+
+	public:
+		void OnKey(int key, int action, int mods, bool capturedByUI);
+		void OnMouseButton(int button, int action, int mods, bool capturedByUI);
+		void OnCursorPos(double x, double y);
+
+		void Sample();
+
+		const InputSnapshot& Snapshot() const;
+
+		bool IsKeyDown(int key) const;
+		bool WasKeyPressed(int key) const; // Went down between the previous snapshot and this one.
+		bool WasKeyReleased(int key) const;
+
+		const std::vector<InputEvent>& Events() const; // In the order they happened.
+	};
+} // namespace lei3d
@@ -0,0 +1,160 @@
+#include "JobSystem.hpp"
+
+namespace lei3d
+{
+	// Which queue of which job system the current thread owns, for the threads a job system spawned.
+	static thread_local const JobSystem* t_JobSystem = nullptr;
+	static thread_local uint32_t		 t_QueueIndex = 0;
+
+	JobSystem::JobSystem(uint32_t workerCount)
+		: m_OwnerThread(std::this_thread::get_id())
+		, m_ForeignQueue(workerCount + 1)
+	{
+		for (uint32_t i = 0; i < workerCount + 2; i++)
+		{
+			m_Queues.push_back(std::make_unique<WorkerQueue>());
+		}
+
+		for (uint32_t i = 0; i < workerCount; i++)
+		{
+			m_Threads.emplace_back(&JobSystem::WorkerLoop, this, i + 1);
+		}
+	}
+
+	JobSystem::~JobSystem()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_WakeMutex);
+			m_Running = false;
+		}
+		m_WakeCondition.notify_all();
+
+		for (std::thread& thread : m_Threads)
+		{
+			thread.join();
+		}
+	}
+
+	uint32_t JobSystem::DefaultWorkerCount()
+	{
+		const uint32_t cores = std::thread::hardware_concurrency();
+		return cores > 1 ? cores - 1 : 0;
+	}
+
+	uint32_t JobSystem::ThreadCount() const
+	{
+		return static_cast<uint32_t>(m_Threads.size() + 1);
+	}
+
+	void JobSystem::Run(Job job, JobCounter& counter)
+	{
+		counter.pending++;
+
+		WorkerQueue& queue = *m_Queues[CurrentQueueIndex()];
+		{
+			std::lock_guard<std::mutex> lock(queue.mutex);
+			queue.jobs.push_back({ std::move(job), &counter });
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(m_WakeMutex);
+			m_QueuedJobs++;
+		}
+		m_WakeCondition.notify_one();
+	}
+
+	void JobSystem::Wait(JobCounter& counter)
+	{
+		const uint32_t queueIndex = CurrentQueueIndex();
+		while (counter.pending > 0)
+		{
+			if (!TryRunJob(queueIndex))
+			{
+				// Everything left is already running on other threads.
+				std::this_thread::yield();
+			}
+		}
+	}
+
+	void JobSystem::WorkerLoop(uint32_t queueIndex)
+	{
+		t_JobSystem = this;
+		t_QueueIndex = queueIndex;
+
+		while (true)
+		{
+			if (TryRunJob(queueIndex))
+			{
+				continue;
+			}
+
+			std::unique_lock<std::mutex> lock(m_WakeMutex);
+			m_WakeCondition.wait(lock, [this]() { return m_QueuedJobs > 0 || !m_Running; });
+			if (!m_Running)
+			{
+				return;
+			}
+		}
+	}
+
+	bool JobSystem::TryRunJob(uint32_t queueIndex)
+	{
+		JobEntry entry;
+		if (!PopOwn(queueIndex, entry) && !Steal(queueIndex, entry))
+		{
+			return false;
+		}
+
+		m_QueuedJobs--;
+		entry.job();
+		entry.counter->pending--;
+		return true;
+	}
+
+	bool JobSystem::PopOwn(uint32_t queueIndex, JobEntry& out)
+	{
+		WorkerQueue&				queue = *m_Queues[queueIndex];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		if (queue.jobs.empty())
+		{
+			return false;
+		}
+
+		out = std::move(queue.jobs.back());
+		queue.jobs.pop_back();
+		return true;
+	}
+
+	bool JobSystem::Steal(uint32_t thiefIndex, JobEntry& out)
+	{
+		// Start with the next queue over so thieves spread out instead of all hitting queue 0.
+		const uint32_t queueCount = static_cast<uint32_t>(m_Queues.size());
+		for (uint32_t offset = 1; offset < queueCount; offset++)
+		{
+			const uint32_t victimIndex = (thiefIndex + offset) % queueCount;
+			if (thiefIndex == 0 && victimIndex == m_ForeignQueue)
+			{
+				continue; // The owning thread stays out of other threads' work, see the class comment.
+			}
+
+			WorkerQueue&				victim = *m_Queues[victimIndex];
+			std::lock_guard<std::mutex> lock(victim.mutex);
+			if (!victim.jobs.empty())
+			{
+				out = std::move(victim.jobs.front());
+				victim.jobs.pop_front();
+				return true;
+			}
+		}
+		return false;
+	}
+
+	uint32_t JobSystem::CurrentQueueIndex() const
+	{
+		if (t_JobSystem == this)
+		{
+			return t_QueueIndex;
+		}
+		return std::this_thread::get_id() == m_OwnerThread ? 0 : m_ForeignQueue;
+	}
+} // namespace lei3d
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace lei3d
+{
+	/*
+	 * Tracks a group of jobs. Pass it to Run for every job in the group, then Wait on it.
+	 */
+	struct JobCounter
+	{
+		std::atomic<uint32_t> pending = 0;
+	};
+
+	/*
+	 * Work stealing job system: plain tasks, no fibers.
+	 *
+	 * Every thread (the workers plus the thread that owns the job system, normally the main thread) has its own
+	 * job deque. Threads push and pop jobs at the back of their own deque, which keeps recently split work hot in
+	 * cache, and steal from the front of other threads' deques when they run out.
+	 * Waiting threads don't block, they keep running jobs until the counter they wait on reaches zero. That makes it
+	 * fine to Run and Wait from inside a job.
+	 * Other threads (e.g. the scene loading thread) share one more deque. The owning thread never runs jobs from it,
+	 * so slow work queued from a loading thread doesn't end up running in the middle of a frame.
+	 */
+	class JobSystem
+	{
+	public:
+		using Job = std::function<void()>;
+
+	private:
+		struct JobEntry
+		{
+			Job			job;
+			JobCounter* counter;
+		};
+
+		struct WorkerQueue
+		{
+			std::mutex			 mutex;
+			std::deque<JobEntry> jobs;
+		};
+
+		// Queue 0 belongs to the owning thread, queue i + 1 to m_Threads[i], and the last one to every other thread.
+		std::vector<std::unique_ptr<WorkerQueue>> m_Queues;
+		std::vector<std::thread>				  m_Threads;
+		std::thread::id							  m_OwnerThread;
+		uint32_t								  m_ForeignQueue;
+
+		std::atomic<bool>		m_Running = true;
+		std::atomic<uint32_t>	m_QueuedJobs = 0;
+		std::mutex				m_WakeMutex;
+		std::condition_variable m_WakeCondition;
+
+	public:
+		// workerCount is the number of threads spawned on top of the owning thread. 0 runs everything inline on Wait.
+		explicit JobSystem(uint32_t workerCount = DefaultWorkerCount());
+		~JobSystem();
+		JobSystem(const JobSystem&) = delete;
+		JobSystem& operator=(const JobSystem&) = delete;
+
+		static uint32_t DefaultWorkerCount(); // One less than the number of cores, leaving one for the owning thread.
+
+		uint32_t ThreadCount() const; // Workers plus the owning thread.
+
+		void Run(Job job, JobCounter& counter);
+		void Wait(JobCounter& counter);
+
+		/*
+		 * Calls func(begin, end) over [0, count) split into ranges run across all threads, and waits for them.
+		 * grainSize is the smallest range handed to a job. 0 picks one that gives every thread a few jobs to balance.
+		 */
+		template <typename F>
+		void ParallelFor(uint32_t count, uint32_t grainSize, F&& func)
+		{
+			if (count == 0)
+			{
+				return;
+			}
+
+			if (grainSize == 0)
+			{
+				constexpr uint32_t JOBS_PER_THREAD = 4;
+				grainSize = std::max(1u, count / (ThreadCount() * JOBS_PER_THREAD));
+			}
+
+			JobCounter counter;
+			for (uint32_t begin = 0; begin < count; begin += grainSize)
+			{
+				const uint32_t end = std::min(count, begin + grainSize);
+				Run([&func, begin, end]() { func(begin, end); }, counter);
+			}
+			Wait(counter);
+		}
+
+	private:
+		void WorkerLoop(uint32_t queueIndex);
+		bool TryRunJob(uint32_t queueIndex);
+		bool PopOwn(uint32_t queueIndex, JobEntry& out);
+		bool Steal(uint32_t thiefIndex, JobEntry& out);
+
+		uint32_t CurrentQueueIndex() const;
+	};
+} // namespace lei3d
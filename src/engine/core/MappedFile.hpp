@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace lei3d
+{
+	/*
+	 * A whole file mapped into memory in one go, so reading it costs page faults instead of copies.
+	 * The mapping is copy-on-write: writing to Data() (e.g. to patch offsets into pointers) only touches this
+	 * process's copy of the touched pages and never the file on disk.
+	 */
+	class MappedFile
+	{
+	private:
+		char*  m_Data = nullptr;
+		size_t m_Size = 0;
+
+#ifdef _WIN32
+		void* m_FileHandle = nullptr;
+		void* m_MappingHandle = nullptr;
+#endif
+
+	public:
+		MappedFile() = default;
+		~MappedFile();
+
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+		MappedFile(MappedFile&& other) noexcept;
+		MappedFile& operator=(MappedFile&& other) noexcept;
+
+		bool Open(const std::string& path); // Closes whatever was open before. Returns false (and logs) on failure.
+		void Close();
+
+		bool   IsOpen() const { return m_Data != nullptr; }
+		char*  Data() const { return m_Data; }
+		size_t Size() const { return m_Size; }
+	};
+} // namespace lei3d
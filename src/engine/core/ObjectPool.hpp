@@ -0,0 +1,170 @@
+#pragma once
+
+#include <bitset>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace lei3d
+{
+	struct ObjectPoolStats
+	{
+		uint32_t live = 0;	   // Objects currently alive.
+		uint32_t capacity = 0; // Slots in all chunks, alive or not.
+		uint32_t chunks = 0;
+	};
+
+	/*
+	 * Slab allocator for objects of type T.
+	 *
+	 * Objects live in fixed-size chunks that are never moved or freed while the pool is alive, so object addresses
+	 * are stable. Destroyed slots go on a free list and the next Create reuses them, which means a workload that
+	 * keeps spawning and destroying the same kind of object stops allocating once the pool has grown to its peak.
+	 * Objects of one type also end up next to each other, so loops over all of them walk memory linearly.
+	 *
+	 * Slots are plain indices: slot / CHUNK_CAPACITY is the chunk and slot % CHUNK_CAPACITY the position inside it.
+	 */
+	template <typename T>
+	class ObjectPool
+	{
+	public:
+		static constexpr uint32_t CHUNK_CAPACITY = 64;
+
+	private:
+		struct Chunk
+		{
+			alignas(T) unsigned char	m_Storage[sizeof(T) * CHUNK_CAPACITY];
+			std::bitset<CHUNK_CAPACITY> m_Alive;
+
+			T* At(uint32_t i) { return std::launder(reinterpret_cast<T*>(m_Storage) + i); }
+		};
+
+		std::vector<std::unique_ptr<Chunk>> m_Chunks;
+		std::vector<uint32_t>				m_FreeSlots;
+		uint32_t							m_HighWaterMark = 0; // One past the highest slot that was ever used.
+		uint32_t							m_Count = 0;
+
+	public:
+		ObjectPool() = default;
+		ObjectPool(const ObjectPool&) = delete;
+		ObjectPool& operator=(const ObjectPool&) = delete;
+
+		~ObjectPool()
+		{
+			Clear();
+		}
+
+		/*
+		 * Constructs a new object in the first free slot and returns it along with the slot it lives in.
+		 */
+		template <typename... Args>
+		std::pair<T*, uint32_t> Create(Args&&... args)
+		{
+			uint32_t slot;
+			if (!m_FreeSlots.empty())
+			{
+				slot = m_FreeSlots.back();
+				m_FreeSlots.pop_back();
+			}
+			else
+			{
+				slot = m_HighWaterMark++;
+				if (slot / CHUNK_CAPACITY >= m_Chunks.size())
+				{
+					m_Chunks.push_back(std::make_unique<Chunk>());
+				}
+			}
+
+			Chunk&		   chunk = *m_Chunks[slot / CHUNK_CAPACITY];
+			const uint32_t index = slot % CHUNK_CAPACITY;
+			T*			   object = new (chunk.At(index)) T(std::forward<Args>(args)...);
+			chunk.m_Alive.set(index);
+			m_Count++;
+
+			return { object, slot };
+		}
+
+		T* Get(uint32_t slot)
+		{
+			return m_Chunks[slot / CHUNK_CAPACITY]->At(slot % CHUNK_CAPACITY);
+		}
+
+		void Destroy(uint32_t slot)
+		{
+			Chunk&		   chunk = *m_Chunks[slot / CHUNK_CAPACITY];
+			const uint32_t index = slot % CHUNK_CAPACITY;
+			if (!chunk.m_Alive.test(index))
+			{
+				return;
+			}
+
+			// Mark the slot dead first, in case the destructor looks at the pool.
+			chunk.m_Alive.reset(index);
+			chunk.At(index)->~T();
+			m_FreeSlots.push_back(slot);
+			m_Count--;
+		}
+
+		// Destroys every object but keeps the chunks, so refilling the pool doesn't allocate.
+		void Clear()
+		{
+			for (uint32_t slot = 0; slot < m_HighWaterMark; slot++)
+			{
+				Destroy(slot);
+			}
+		}
+
+		uint32_t Count() const
+		{
+			return m_Count;
+		}
+
+		uint32_t ChunkCount() const
+		{
+			return static_cast<uint32_t>(m_Chunks.size());
+		}
+
+		ObjectPoolStats GetStats() const
+		{
+			return { m_Count, ChunkCount() * CHUNK_CAPACITY, ChunkCount() };
+		}
+
+		/*
+		 * Calls func on every live object in slot order.
+		 * Indexing (instead of iterators) keeps this safe if func creates objects in the same pool.
+		 */
+		template <typename F>
+		void ForEach(F&& func)
+		{
+			ForEachInChunks(0, UINT32_MAX, func);
+		}
+
+		/*
+		 * Same as ForEach, limited to the chunks [firstChunk, lastChunk).
+		 * Chunks don't share any memory, so different chunk ranges can be walked from different threads
+		 * as long as nothing creates or destroys objects in this pool meanwhile.
+		 */
+		template <typename F>
+		void ForEachInChunks(uint32_t firstChunk, uint32_t lastChunk, F&& func)
+		{
+			for (size_t chunkI = firstChunk; chunkI < lastChunk && chunkI < m_Chunks.size(); chunkI++)
+			{
+				Chunk& chunk = *m_Chunks[chunkI];
+				if (chunk.m_Alive.none())
+				{
+					continue;
+				}
+
+				for (uint32_t i = 0; i < CHUNK_CAPACITY; i++)
+				{
+					if (chunk.m_Alive.test(i))
+					{
+						func(*chunk.At(i));
+					}
+				}
+			}
+		}
+	};
+} // namespace lei3d
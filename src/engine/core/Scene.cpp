@@ -2,6 +2,7 @@
 
 #include "core/Application.hpp"
 #include "core/Camera.hpp"
+#include "core/SystemRegistry.hpp"
 
 #include "logging/GLDebug.hpp"
 
@@ -13,9 +14,17 @@ namespace lei3d
 
 	Scene::~Scene()
 	{
+		// Entities first, their components take their bodies out of the physics world Destroy deletes.
+		m_EntityPool.Clear();
+		m_Entities.clear();
 		Destroy();
 	}
 
+	void Scene::Prepare(SceneLoadProgress& progress)
+	{
+		OnPrepare(progress);
+	}
+
 	void Scene::Load()
 	{
 		//Default Camera
@@ -34,25 +43,53 @@ namespace lei3d
 		m_State = SCENE_START; //Scene ready to start by default.
 	}
 
-	Entity& Scene::AddEntity(std::string name)
+	Entity& Scene::AddEntity(const std::string& name)
+	{
+		return CreateEntity(ReserveEntityHandle(), name);
+	}
+
+	EntityHandle Scene::ReserveEntityHandle()
 	{
-		// Add number to name if multiple instances of the same name.
-		std::stringstream entityNameSS;
-		entityNameSS << name;
-		if (m_EntityNameCounts.find(name) != m_EntityNameCounts.end())
+		std::lock_guard<std::mutex> lock(m_EntitySlotMutex);
+
+		EntityHandle handle;
+		if (!m_FreeEntitySlots.empty())
 		{
-			const std::string numberStr = std::to_string(m_EntityNameCounts[name]);
-			entityNameSS << numberStr;
+			handle.index = m_FreeEntitySlots.back();
+			handle.generation = m_EntitySlots[handle.index].generation;
+			m_FreeEntitySlots.pop_back();
 		}
 		else
 		{
-			m_EntityNameCounts[name] = 0;
+			// m_EntitySlots only grows on the main thread (in CreateEntity), so the slot may not exist yet.
+			handle.index = m_EntitySlotCount++;
+			handle.generation = 0;
+		}
+		return handle;
+	}
+
+	Entity& Scene::CreateEntity(EntityHandle handle, const std::string& name)
+	{
+		const std::string uniqueName = MakeUniqueEntityName(name);
+		m_TransformSystem.Add(handle);
+
+		auto [entityPtr, poolSlot] = m_EntityPool.Create(*this, handle, uniqueName);
+		Entity& entity = *entityPtr;
+		m_Entities.push_back(&entity);
+
+		{
+			std::lock_guard<std::mutex> lock(m_EntitySlotMutex);
+			if (handle.index >= m_EntitySlots.size())
+			{
+				m_EntitySlots.resize(handle.index + 1);
+			}
+			m_EntitySlots[handle.index].entity = &entity;
+			m_EntitySlots[handle.index].poolSlot = poolSlot;
+			m_EntitySlots[handle.index].entityIndex = static_cast<uint32_t>(m_Entities.size() - 1);
 		}
-		m_EntityNameCounts[name]++;
 
-		std::unique_ptr<Entity> newEntity = std::make_unique<Entity>(entityNameSS.str());
-		m_Entities.push_back(std::move(newEntity));
-		return *m_Entities.back();
+		m_EntityNameIndex[StringId(uniqueName)] = handle;
+		return entity;
 	}
 
 	Entity& Scene::AddEntity()
@@ -60,22 +97,158 @@ namespace lei3d
 		return AddEntity("Unnamed Entity");
 	}
 
-	Entity* Scene::GetEntity(std::string name) const
+	void Scene::RemoveEntity(EntityHandle handle)
 	{
-		for (auto& entity : m_Entities)
+		Entity* entity = GetEntity(handle);
+		if (!entity)
+		{
+			LEI_WARN("Tried to remove an entity that doesn't exist anymore.");
+			return;
+		}
+
+		m_EntityNameIndex.erase(entity->GetName());
+		m_TransformSystem.Remove(handle); // Dropped for good by ApplyRemovals, once per frame in Update.
+
+		// Bumping the generation invalidates every handle to this entity before the slot gets reused.
+		uint32_t poolSlot;
 		{
-			if (entity->GetName().compare(name) == 0)
+			std::lock_guard<std::mutex> lock(m_EntitySlotMutex);
+			EntitySlot&					slot = m_EntitySlots[handle.index];
+			poolSlot = slot.poolSlot;
+
+			Entity* last = m_Entities.back();
+			m_Entities[slot.entityIndex] = last;
+			m_EntitySlots[last->m_Handle.index].entityIndex = slot.entityIndex;
+			m_Entities.pop_back();
+
+			slot.entity = nullptr;
+			slot.generation++;
+			m_FreeEntitySlots.push_back(handle.index);
+		}
+
+		m_EntityPool.Destroy(poolSlot);
+	}
+
+	EntityCommandBuffer& Scene::GetEntityCommands()
+	{
+		return m_EntityCommands;
+	}
+
+	void Scene::FlushEntityCommands()
+	{
+		m_EntityCommands.TakeCommands(m_FlushingCommands, m_FlushingNames);
+		if (m_FlushingCommands.empty())
+		{
+			return;
+		}
+
+		m_SpawnedEntities.clear();
+		for (EntityCommand& command : m_FlushingCommands)
+		{
+			switch (command.type)
 			{
-				return entity.get();
+				case ENTITY_COMMAND_CREATE:
+					CreateEntity(command.handle, std::string(m_FlushingNames.data() + command.nameOffset, command.nameLength));
+					m_SpawnedEntities.push_back(command.handle);
+					break;
+				case ENTITY_COMMAND_DESTROY:
+					// Destroying twice is fine, gameplay code can't always tell if someone else got to it first.
+					if (GetEntity(command.handle))
+					{
+						RemoveEntity(command.handle);
+					}
+					break;
+				case ENTITY_COMMAND_ADD_COMPONENT:
+					if (Entity* entity = GetEntity(command.handle))
+					{
+						command.addComponent(*entity, command.init);
+					}
+					else
+					{
+						LEI_WARN("Tried to add a component to an entity that doesn't exist anymore.");
+					}
+					break;
 			}
 		}
 
-		return nullptr;
+		// Entities spawned mid-game missed Scene::Start, so start them now that all their components are there. That
+		// includes while paused: Play only starts the scene if it's at SCENE_START.
+		if (m_State != SCENE_START)
+		{
+			for (EntityHandle handle : m_SpawnedEntities)
+			{
+				if (Entity* entity = GetEntity(handle))
+				{
+					entity->Start();
+				}
+			}
+		}
+
+		// Keep the capacity for next frame.
+		m_FlushingCommands.clear();
+		m_FlushingNames.clear();
+	}
+
+	Entity* Scene::GetEntity(EntityHandle handle) const
+	{
+		if (handle.index >= m_EntitySlots.size())
+		{
+			return nullptr;
+		}
+
+		const EntitySlot& slot = m_EntitySlots[handle.index];
+		return slot.generation == handle.generation ? slot.entity : nullptr;
+	}
+
+	Entity* Scene::GetEntity(StringId name) const
+	{
+		return GetEntity(FindEntityHandle(name));
+	}
+
+	EntityHandle Scene::FindEntityHandle(StringId name) const
+	{
+		auto it = m_EntityNameIndex.find(name);
+		return it != m_EntityNameIndex.end() ? it->second : EntityHandle{};
+	}
+
+	// Add number to name if multiple instances of the same name.
+	std::string Scene::MakeUniqueEntityName(const std::string& name)
+	{
+		if (m_EntityNameIndex.find(name) == m_EntityNameIndex.end())
+		{
+			return name;
+		}
+
+		int&		count = m_EntityNameCounts[name];
+		std::string uniqueName;
+		do
+		{
+			uniqueName = name + std::to_string(++count);
+		}
+		while (m_EntityNameIndex.find(uniqueName) != m_EntityNameIndex.end());
+
+		return uniqueName;
+	}
+
+	void Scene::RenameEntity(Entity& entity, const std::string& name)
+	{
+		m_EntityNameIndex.erase(entity.m_Name);
+		entity.m_Name = MakeUniqueEntityName(name);
+		m_EntityNameIndex[StringId(entity.m_Name)] = entity.m_Handle;
 	}
 
 	void Scene::Unload()
 	{
-		m_Entities.clear(); // This should auto-destruct entities bc smart pointers.
+		m_EntityPool.Clear(); // Keeps the pool's memory around for the next load.
+		m_Entities.clear();
+		m_EntityCommands.Clear();
+		m_EntitySlots.clear();
+		m_FreeEntitySlots.clear();
+		m_EntitySlotCount = 0;
+		m_EntityNameIndex.clear();
+		m_EntityNameCounts.clear();
+		m_TransformSystem.Clear();
+		m_ComponentStorage.Clear();
 
 		OnUnload();
 		Destroy();
@@ -127,17 +300,22 @@ namespace lei3d
 			case SCENE_PLAYING:
 				// LEI_TRACE("Scene Update");
 
-				for (auto& entity : m_Entities)
-				{
-					entity->Update();
-				}
+				SystemRegistry::Get().Run(PHASE_UPDATE, m_ComponentStorage, &Application::GetJobSystem());
 
 				OnUpdate();
 				break;
 			case SCENE_PAUSED:
 			case SCENE_START:
+				SystemRegistry::Get().Run(PHASE_EDITOR_UPDATE, m_ComponentStorage, &Application::GetJobSystem());
 				break;
 		}
+
+		// The one point per frame where spawns and despawns recorded during the frame (fixed ticks included) happen.
+		FlushEntityCommands();
+		m_TransformSystem.ApplyRemovals(); // All of the frame's despawns in one rebuild.
+
+		// Refresh the world matrices of everything that moved in one pass, before anything gets rendered.
+		m_TransformSystem.Update();
 	}
 
 	void Scene::PhysicsUpdate()
@@ -145,15 +323,23 @@ namespace lei3d
 		if (m_State == SCENE_PLAYING)
 		{
 			// LEI_TRACE("Scene Physics Update");
-			for (auto& entity : m_Entities)
-			{
-				entity->PhysicsUpdate();
-			}
+			m_TransformSystem.BeginFixedTick();
+
+			SystemRegistry::Get().Run(PHASE_PHYSICS_UPDATE, m_ComponentStorage, &Application::GetJobSystem());
 
 			OnPhysicsUpdate();
+
+			m_TransformSystem.EndFixedTick();
 		}
 	}
 
+	void Scene::InterpolateTransforms(float alpha)
+	{
+		// Nothing is ticking unless we're playing, so show everything where it actually is.
+		m_TransformSystem.SetInterpolationAlpha(m_State == SCENE_PLAYING ? alpha : 1.0f);
+		m_TransformSystem.Update();
+	}
+
 	// yucky
 	std::string Scene::StateToString() const
 	{
@@ -197,29 +383,25 @@ namespace lei3d
 		ImGui::Text("Physics World: ");
 		m_PhysicsWorld->OnImGuiRender();
 
-		static int currentEntityI = -1; // Here we store our selection data as an index.
+		static EntityHandle selectedEntity; // Here we store our selection data as a handle, so it survives entities being removed.
 		if (ImGui::TreeNode("Entities"))
 		{
 			// Using the generic BeginListBox() API, you have full control over how to display the combo contents.
 			// (your selection data could be an index, a pointer to the object, an id for the object, a flag intrusively
 			// stored in the object itself, etc.)
-			std::vector<std::string> entityNames;
-			for (auto& entity : m_Entities)
-			{
-				entityNames.push_back(entity->GetName());
-			}
 
-			// LEI_INFO("Number of Entities: {0}", entityNames.size());
+			// LEI_INFO("Number of Entities: {0}", m_Entities.size());
 
 			if (ImGui::BeginListBox("Entities"))
 			{
-				for (int i = 0; i < entityNames.size(); i++)
+				for (auto& entity : m_Entities)
 				{
-					const char* label = entityNames[i] == "" ? "Unnamed" : entityNames[i].c_str();
-					const bool	is_selected = (currentEntityI == i);
+					const std::string& name = entity->GetName();
+					const char*		   label = name == "" ? "Unnamed" : name.c_str();
+					const bool		   is_selected = (selectedEntity == entity->GetHandle());
 					if (ImGui::Selectable(label, is_selected))
 					{
-						currentEntityI = i;
+						selectedEntity = entity->GetHandle();
 					}
 
 					// Set the initial focus when opening the combo (scrolling + keyboard navigation focus)
@@ -235,10 +417,9 @@ namespace lei3d
 		}
 
 		// Create an inspector for the entity if one is selected
-		if (currentEntityI >= 0)
+		if (Entity* entity = GetEntity(selectedEntity))
 		{
-			Entity& entity = *m_Entities[currentEntityI];
-			entity.ShowInspectorGUI();
+			entity->ShowInspectorGUI();
 		}
 
 		ImGui::SetWindowSize(ImVec2(300, 600), ImGuiCond_Once);
@@ -261,6 +442,16 @@ namespace lei3d
 		return *m_DefaultCamera;
 	}
 
+	ComponentStorage& Scene::GetComponentStorage()
+	{
+		return m_ComponentStorage;
+	}
+
+	ObjectPoolStats Scene::GetEntityPoolStats() const
+	{
+		return m_EntityPool.GetStats();
+	}
+
 	PhysicsWorld& Scene::GetPhysicsWorld() const
 	{
 		return *m_PhysicsWorld;
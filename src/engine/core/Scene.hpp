@@ -1,6 +1,13 @@
 #pragma once
 
+#include "core/ComponentStorage.hpp"
+#include "core/ComponentView.hpp"
 #include "core/Entity.hpp"
+#include "core/EntityCommandBuffer.hpp"
+#include "core/EntityHandle.hpp"
+#include "core/ObjectPool.hpp"
+#include "core/StringId.hpp"
+#include "core/TransformSystem.hpp"
 
 #include "core/Camera.hpp"
 
@@ -10,7 +17,10 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
+#include <atomic>
 #include <memory>
+#include <mutex>
+#include <string>
 #include <unordered_map>
 #include <vector>
 
@@ -21,6 +31,19 @@ namespace lei3d
 	class PhysicsWorld;
 	class RenderSystem;
 
+	// Written by the loading thread while a scene prepares, read by the main thread to draw a loading screen.
+	struct SceneLoadProgress
+	{
+		std::atomic<uint32_t> completedSteps = 0;
+		std::atomic<uint32_t> totalSteps = 0;
+
+		float GetFraction() const
+		{
+			const uint32_t total = totalSteps.load(std::memory_order_relaxed);
+			return total > 0 ? static_cast<float>(completedSteps.load(std::memory_order_relaxed)) / total : 0.0f;
+		}
+	};
+
 	class Scene
 	{
 		enum SceneState
@@ -30,11 +53,37 @@ namespace lei3d
 			SCENE_START,
 		};
 
+		// Where the entity for an EntityHandle index lives, and how many times that index has been reused.
+		struct EntitySlot
+		{
+			Entity*	 entity = nullptr;
+			uint32_t generation = 0;
+			uint32_t poolSlot = 0;	  // In m_EntityPool.
+			uint32_t entityIndex = 0; // In m_Entities.
+		};
+
 	private:
+		friend Entity;
+		friend EntityCommandBuffer;
 		friend RenderSystem;
 
-		std::vector<std::unique_ptr<Entity>> m_Entities;
-		std::unordered_map<std::string, int> m_EntityNameCounts;
+		// Declared before m_EntityPool so entities are destroyed (and release their components) before the pools are.
+		ComponentStorage	 m_ComponentStorage;
+		TransformSystem		 m_TransformSystem;
+		ObjectPool<Entity>	 m_EntityPool;
+		std::vector<Entity*> m_Entities; // In creation order, except that removing moves the last entity into the gap.
+
+		std::vector<EntitySlot>						  m_EntitySlots; // Indexed by EntityHandle::index.
+		std::vector<uint32_t>						  m_FreeEntitySlots;
+		uint32_t									  m_EntitySlotCount = 0; // Includes reserved slots m_EntitySlots hasn't grown to yet.
+		std::mutex									  m_EntitySlotMutex;	 // Handles can be reserved from any thread.
+		std::unordered_map<StringId, EntityHandle>	  m_EntityNameIndex;  // Names aren't interned, the entity has its own copy and spawning would grow the global table forever.
+		std::unordered_map<StringId, int>			  m_EntityNameCounts; // Last number appended to each duplicated name.
+
+		EntityCommandBuffer		   m_EntityCommands{ *this };
+		std::vector<EntityCommand> m_FlushingCommands; // All three kept around so flushing reuses their capacity.
+		std::vector<char>		   m_FlushingNames;
+		std::vector<EntityHandle>  m_SpawnedEntities;
 
 	protected:
 		// We should prob. limit how much stuff we put into the base scene.
@@ -50,14 +99,23 @@ namespace lei3d
 		Scene();
 		~Scene();
 
-		// Entities
-		Entity& AddEntity(std::string name);
+		/*
+		 * Entities:
+		 * AddEntity and RemoveEntity take effect immediately, so only use them on the main thread while nothing is
+		 * iterating the scene (e.g. in OnLoad). Everywhere else, record into GetEntityCommands instead.
+		 */
+		Entity& AddEntity(const std::string& name);
 		Entity& AddEntity();
+		void	RemoveEntity(EntityHandle handle);
+
+		EntityCommandBuffer& GetEntityCommands();
+		void				 FlushEntityCommands(); // Called once per frame by Update.
 
 		// Entity Messages
 		void Start();
 		void Update();
-		void PhysicsUpdate();
+		void PhysicsUpdate(); // One fixed tick. Application calls this at a fixed rate (see Application::FixedDeltaTime).
+		void InterpolateTransforms(float alpha); // How far rendering is between the last two ticks, from 0 to 1.
 		void Destroy();
 
 		// Scene State Changers
@@ -65,14 +123,21 @@ namespace lei3d
 		void Pause();
 		void Reset();
 
+		/*
+		 * Loading happens in two steps. Prepare runs on a loading thread while the previous scene keeps running, and
+		 * does everything that doesn't need OpenGL or the scene's entities (file I/O, decoding, mesh processing,
+		 * collision cooking). Load runs on the main thread afterwards, uploads to the GPU and creates the entities.
+		 * Prepare is optional, scenes without an OnPrepare do all their work in Load.
+		 */
+		void Prepare(SceneLoadProgress& progress);
 		void Load();
 		void Unload();
 
 		//GUI
 		void ShowHeirarchyGUI();
 
-		// TODO: Abstract scene creation/loading into files: https://trello.com/c/eC66QGuD/25-define-scene-file-format
-		// Right now we use this virtual Load function to load all the objs in code.
+		// Scenes from scene files (see DataScene) load their entities here. Scenes built in code can override it too.
+		virtual void OnPrepare(SceneLoadProgress& progress) {} // Loading thread, see Prepare.
 		virtual void OnLoad() {}
 		virtual void OnUnload() {}
 
@@ -83,13 +148,42 @@ namespace lei3d
 		virtual void OnDestroy() {}
 		virtual void OnReset() {}
 
+		/*
+		 * The scene the player most likely goes to next (e.g. the next level). SceneManager prepares it in the
+		 * background once this one is active, so switching to it only has to upload. Empty for no preference.
+		 */
+		virtual StringId GetPreloadHint() const { return {}; }
+
 		virtual Camera& GetMainCamera() const; //Scene must have some camera created (basically just the first person camera lmao.
 
-		Entity*		  GetEntity(std::string name) const;
-		PhysicsWorld& GetPhysicsWorld() const;
+		/*
+		 * Both return nullptr if there is no such entity (or the handle's entity has been removed).
+		 * Prefer caching a handle over looking the same entity up by name every time.
+		 */
+		Entity*		 GetEntity(EntityHandle handle) const;
+		Entity*		 GetEntity(StringId name) const;
+		EntityHandle FindEntityHandle(StringId name) const;
+
+		// Iterate all entities that have every one of the components Cs (see ComponentView).
+		template <typename... Cs>
+		ComponentView<Cs...> View()
+		{
+			return ComponentView<Cs...>(m_ComponentStorage);
+		}
+
+		ComponentStorage& GetComponentStorage();
+		ObjectPoolStats	  GetEntityPoolStats() const;
+		PhysicsWorld&	  GetPhysicsWorld() const;
 
 		void PrintEntityList() const; // For Debugging
 
 		std::string StateToString() const;
+
+	private:
+		EntityHandle ReserveEntityHandle(); // Thread safe.
+		Entity&		 CreateEntity(EntityHandle handle, const std::string& name);
+
+		std::string MakeUniqueEntityName(const std::string& name);
+		void		RenameEntity(Entity& entity, const std::string& name);
 	};
 } // namespace lei3d
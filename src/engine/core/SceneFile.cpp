@@ -0,0 +1,553 @@
+#include "SceneFile.hpp"
+
+#include "core/TransformSystem.hpp"
+#include "logging/Log.hpp"
+#include "util/StringUtil.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+namespace lei3d
+{
+	static_assert(sizeof(SceneAssetRecord) == 16, "Scene file records must not change size without bumping SCENE_FILE_VERSION");
+	static_assert(sizeof(ScenePropertyRecord) == 48, "Scene file records must not change size without bumping SCENE_FILE_VERSION");
+	static_assert(sizeof(SceneComponentRecord) == 32, "Scene file records must not change size without bumping SCENE_FILE_VERSION");
+	static_assert(sizeof(SceneEntityRecord) == 64, "Scene file records must not change size without bumping SCENE_FILE_VERSION");
+	static_assert(sizeof(SceneFileHeader) == 96, "Scene file records must not change size without bumping SCENE_FILE_VERSION");
+
+	namespace
+	{
+		// What the text parser builds, before it gets flattened into the binary layout.
+		struct PropertyDesc
+		{
+			std::string		  key;
+			ScenePropertyType type = SCENE_PROPERTY_FLOAT;
+			float			  values[3] = { 0.0f, 0.0f, 0.0f };
+			std::string		  string;
+			uint32_t		  asset = 0;
+		};
+
+		struct ComponentDesc
+		{
+			std::string				  type;
+			std::vector<PropertyDesc> properties;
+		};
+
+		struct EntityDesc
+		{
+			std::string				   name;
+			std::string				   parent;
+			float					   position[3] = { 0.0f, 0.0f, 0.0f };
+			float					   rotation[4] = { 0.0f, 0.0f, 0.0f, 1.0f };
+			float					   scale[3] = { 1.0f, 1.0f, 1.0f };
+			std::vector<ComponentDesc> components;
+		};
+
+		struct SceneDesc
+		{
+			std::string				 music;
+			std::string				 nextScene;
+			std::vector<std::string> assets;
+			std::vector<EntityDesc>	 entities;
+		};
+
+		// Splits "keyword the rest" into its first word and the (trimmed) rest of the line.
+		void splitStatement(const std::string& line, std::string& keyword, std::string& rest)
+		{
+			const size_t keywordEnd = line.find(' ');
+			keyword = line.substr(0, keywordEnd);
+			rest = keywordEnd == std::string::npos ? "" : strTrim(line.substr(keywordEnd));
+		}
+
+		std::string unquote(const std::string& str)
+		{
+			if (str.size() >= 2 && str.front() == '"' && str.back() == '"')
+			{
+				return str.substr(1, str.size() - 2);
+			}
+			return str;
+		}
+
+		// Parses every space separated token of str as a float. Returns false if any of them isn't one.
+		bool parseFloats(const std::string& str, std::vector<float>& values)
+		{
+			values.clear();
+			for (const std::string& token : tokenize(str))
+			{
+				char*		end = nullptr;
+				const float value = std::strtof(token.c_str(), &end);
+				if (end != token.c_str() + token.size())
+				{
+					return false;
+				}
+				values.push_back(value);
+			}
+			return !values.empty();
+		}
+
+		uint32_t findOrAddAsset(SceneDesc& scene, const std::string& path)
+		{
+			for (uint32_t i = 0; i < scene.assets.size(); i++)
+			{
+				if (scene.assets[i] == path)
+				{
+					return i;
+				}
+			}
+			scene.assets.push_back(path);
+			return static_cast<uint32_t>(scene.assets.size() - 1);
+		}
+
+		bool parseSceneText(const std::string& textPath, SceneDesc& scene)
+		{
+			std::ifstream fileStream(textPath, std::ifstream::in);
+			if (!fileStream.is_open())
+			{
+				LEI_ERROR("Failed to open scene file {0}", textPath);
+				return false;
+			}
+
+			std::string		   line;
+			int				   lineNumber = 0;
+			bool			   foundVersion = false;
+			std::vector<float> values;
+			while (std::getline(fileStream, line))
+			{
+				lineNumber++;
+
+				const size_t commentStart = line.find('#');
+				if (commentStart != std::string::npos)
+				{
+					line.erase(commentStart);
+				}
+				for (char& c : line)
+				{
+					c = c == '\t' || c == '\r' ? ' ' : c;
+				}
+				line = strTrim(line);
+				if (line.empty())
+				{
+					continue;
+				}
+
+				std::string keyword;
+				std::string rest;
+				splitStatement(line, keyword, rest);
+
+				auto parseError = [&](const std::string& message) {
+					LEI_ERROR("{0}:{1}: {2}", textPath, lineNumber, message);
+					return false;
+				};
+
+				if (!foundVersion)
+				{
+					if (keyword != "lscene" || !parseFloats(rest, values) || values.size() != 1)
+					{
+						return parseError("Scene files have to start with \"lscene <version>\"");
+					}
+					if (static_cast<uint32_t>(values[0]) != SCENE_FILE_VERSION)
+					{
+						return parseError("Unsupported scene file version " + rest);
+					}
+					foundVersion = true;
+					continue;
+				}
+
+				EntityDesc*	   entity = scene.entities.empty() ? nullptr : &scene.entities.back();
+				ComponentDesc* component = entity && !entity->components.empty() ? &entity->components.back() : nullptr;
+
+				if (keyword == "music" && !entity)
+				{
+					scene.music = unquote(rest);
+				}
+				else if (keyword == "next" && !entity)
+				{
+					scene.nextScene = unquote(rest);
+				}
+				else if (keyword == "entity")
+				{
+					if (rest.empty())
+					{
+						return parseError("Entities need a name");
+					}
+					scene.entities.emplace_back();
+					scene.entities.back().name = unquote(rest);
+				}
+				else if (!entity)
+				{
+					return parseError("Expected an entity before \"" + keyword + "\"");
+				}
+				else if (keyword == "component")
+				{
+					if (rest.empty())
+					{
+						return parseError("Components need a type");
+					}
+					entity->components.emplace_back();
+					entity->components.back().type = rest;
+				}
+				else if (component)
+				{
+					PropertyDesc property;
+					property.key = keyword;
+					if (!rest.empty() && rest.front() == '@')
+					{
+						property.type = SCENE_PROPERTY_ASSET;
+						property.asset = findOrAddAsset(scene, strTrim(rest.substr(1)));
+					}
+					else if (parseFloats(rest, values) && (values.size() == 1 || values.size() == 3))
+					{
+						property.type = values.size() == 1 ? SCENE_PROPERTY_FLOAT : SCENE_PROPERTY_VEC3;
+						std::copy(values.begin(), values.end(), property.values);
+					}
+					else
+					{
+						property.type = SCENE_PROPERTY_STRING;
+						property.string = unquote(rest);
+					}
+					component->properties.push_back(std::move(property));
+				}
+				else if (keyword == "parent")
+				{
+					entity->parent = unquote(rest);
+				}
+				else if (keyword == "position" || keyword == "scale")
+				{
+					if (!parseFloats(rest, values) || values.size() != 3)
+					{
+						return parseError(keyword + " needs 3 numbers");
+					}
+					std::copy(values.begin(), values.end(), keyword == "position" ? entity->position : entity->scale);
+				}
+				else if (keyword == "rotation")
+				{
+					if (!parseFloats(rest, values) || values.size() != 4)
+					{
+						return parseError("rotation needs 4 numbers (x y z w)");
+					}
+					std::copy(values.begin(), values.end(), entity->rotation);
+				}
+				else if (keyword == "yaw")
+				{
+					if (!parseFloats(rest, values) || values.size() != 1)
+					{
+						return parseError("yaw needs 1 number");
+					}
+					Transform transform;
+					transform.SetYawRotation(values[0]);
+					entity->rotation[0] = transform.rotation.x;
+					entity->rotation[1] = transform.rotation.y;
+					entity->rotation[2] = transform.rotation.z;
+					entity->rotation[3] = transform.rotation.w;
+				}
+				else
+				{
+					return parseError("Unknown statement \"" + keyword + "\"");
+				}
+			}
+
+			if (!foundVersion)
+			{
+				LEI_ERROR("{0} is empty", textPath);
+				return false;
+			}
+			return true;
+		}
+
+		// Flattens a scene into the binary layout. Records are written by offset, since the buffer moves as it grows.
+		class SceneFileWriter
+		{
+		private:
+			std::vector<char>	  m_Data;
+			std::vector<uint64_t> m_Relocations;
+
+		public:
+			uint64_t Reserve(size_t size)
+			{
+				const uint64_t offset = (m_Data.size() + 7) & ~uint64_t(7);
+				m_Data.resize(offset + size);
+				return offset;
+			}
+
+			template <typename T>
+			T& At(uint64_t offset)
+			{
+				return *reinterpret_cast<T*>(m_Data.data() + offset);
+			}
+
+			uint64_t WriteString(const std::string& str)
+			{
+				const uint64_t offset = Reserve(str.size() + 1);
+				std::memcpy(m_Data.data() + offset, str.c_str(), str.size() + 1);
+				return offset;
+			}
+
+			// Points the SceneFilePtr at fieldOffset to target, and remembers to relocate it on load.
+			void SetPtr(uint64_t fieldOffset, uint64_t target)
+			{
+				At<uint64_t>(fieldOffset) = target;
+				if (target != 0)
+				{
+					m_Relocations.push_back(fieldOffset);
+				}
+			}
+
+			const std::vector<char>& Finish()
+			{
+				const uint64_t relocationOffset = Reserve(m_Relocations.size() * sizeof(uint64_t));
+				std::memcpy(m_Data.data() + relocationOffset, m_Relocations.data(), m_Relocations.size() * sizeof(uint64_t));
+
+				SceneFileHeader& header = At<SceneFileHeader>(0);
+				header.fileSize = m_Data.size();
+				header.relocationOffset = relocationOffset;
+				header.relocationCount = static_cast<uint32_t>(m_Relocations.size());
+				return m_Data;
+			}
+		};
+
+		bool writeSceneBinary(const SceneDesc& scene, const SourceStamp& source, const std::string& binaryPath)
+		{
+			SceneFileWriter writer;
+
+			const uint64_t headerOffset = writer.Reserve(sizeof(SceneFileHeader));
+			{
+				SceneFileHeader& header = writer.At<SceneFileHeader>(headerOffset);
+				header.magic = SCENE_FILE_MAGIC;
+				header.version = SCENE_FILE_VERSION;
+				header.entityCount = static_cast<uint32_t>(scene.entities.size());
+				header.assetCount = static_cast<uint32_t>(scene.assets.size());
+				header.source = source;
+			}
+
+			if (!scene.music.empty())
+			{
+				writer.SetPtr(headerOffset + offsetof(SceneFileHeader, music), writer.WriteString(scene.music));
+			}
+
+			if (!scene.nextScene.empty())
+			{
+				writer.SetPtr(headerOffset + offsetof(SceneFileHeader, nextScene), writer.WriteString(scene.nextScene));
+			}
+
+			const uint64_t assetsOffset = writer.Reserve(scene.assets.size() * sizeof(SceneAssetRecord));
+			writer.SetPtr(headerOffset + offsetof(SceneFileHeader, assets), scene.assets.empty() ? 0 : assetsOffset);
+			for (size_t i = 0; i < scene.assets.size(); i++)
+			{
+				const uint64_t recordOffset = assetsOffset + i * sizeof(SceneAssetRecord);
+				writer.At<SceneAssetRecord>(recordOffset).pathId = StringId::Hash(scene.assets[i]);
+				writer.SetPtr(recordOffset + offsetof(SceneAssetRecord, path), writer.WriteString(scene.assets[i]));
+			}
+
+			const uint64_t entitiesOffset = writer.Reserve(scene.entities.size() * sizeof(SceneEntityRecord));
+			writer.SetPtr(headerOffset + offsetof(SceneFileHeader, entities), scene.entities.empty() ? 0 : entitiesOffset);
+			for (size_t i = 0; i < scene.entities.size(); i++)
+			{
+				const EntityDesc& entity = scene.entities[i];
+				const uint64_t	  recordOffset = entitiesOffset + i * sizeof(SceneEntityRecord);
+
+				int32_t parent = -1;
+				if (!entity.parent.empty())
+				{
+					for (size_t j = 0; j < scene.entities.size(); j++)
+					{
+						if (scene.entities[j].name == entity.parent && j != i)
+						{
+							parent = static_cast<int32_t>(j);
+							break;
+						}
+					}
+					if (parent < 0)
+					{
+						LEI_ERROR("{0} has parent {1}, but there is no entity with that name", entity.name, entity.parent);
+						return false;
+					}
+				}
+
+				{
+					SceneEntityRecord& record = writer.At<SceneEntityRecord>(recordOffset);
+					record.componentCount = static_cast<uint32_t>(entity.components.size());
+					record.parent = parent;
+					std::memcpy(record.position, entity.position, sizeof(record.position));
+					std::memcpy(record.rotation, entity.rotation, sizeof(record.rotation));
+					std::memcpy(record.scale, entity.scale, sizeof(record.scale));
+				}
+				writer.SetPtr(recordOffset + offsetof(SceneEntityRecord, name), writer.WriteString(entity.name));
+
+				const uint64_t componentsOffset = writer.Reserve(entity.components.size() * sizeof(SceneComponentRecord));
+				writer.SetPtr(recordOffset + offsetof(SceneEntityRecord, components), entity.components.empty() ? 0 : componentsOffset);
+				for (size_t c = 0; c < entity.components.size(); c++)
+				{
+					const ComponentDesc& component = entity.components[c];
+					const uint64_t		 componentOffset = componentsOffset + c * sizeof(SceneComponentRecord);
+					{
+						SceneComponentRecord& record = writer.At<SceneComponentRecord>(componentOffset);
+						record.type = StringId::Hash(component.type);
+						record.propertyCount = static_cast<uint32_t>(component.properties.size());
+					}
+					writer.SetPtr(componentOffset + offsetof(SceneComponentRecord, typeName), writer.WriteString(component.type));
+
+					const uint64_t propertiesOffset = writer.Reserve(component.properties.size() * sizeof(ScenePropertyRecord));
+					writer.SetPtr(componentOffset + offsetof(SceneComponentRecord, properties), component.properties.empty() ? 0 : propertiesOffset);
+					for (size_t p = 0; p < component.properties.size(); p++)
+					{
+						const PropertyDesc& property = component.properties[p];
+						const uint64_t		propertyOffset = propertiesOffset + p * sizeof(ScenePropertyRecord);
+						{
+							ScenePropertyRecord& record = writer.At<ScenePropertyRecord>(propertyOffset);
+							record.key = StringId::Hash(property.key);
+							record.type = property.type;
+							record.asset = property.asset;
+							std::memcpy(record.values, property.values, sizeof(record.values));
+						}
+						writer.SetPtr(propertyOffset + offsetof(ScenePropertyRecord, keyName), writer.WriteString(property.key));
+						if (property.type == SCENE_PROPERTY_STRING)
+						{
+							writer.SetPtr(propertyOffset + offsetof(ScenePropertyRecord, string), writer.WriteString(property.string));
+						}
+					}
+				}
+			}
+
+			const std::vector<char>& data = writer.Finish();
+
+			std::ofstream fileStream(binaryPath, std::ofstream::binary | std::ofstream::trunc);
+			fileStream.write(data.data(), static_cast<std::streamsize>(data.size()));
+			if (!fileStream.good())
+			{
+				LEI_ERROR("Failed to write scene file {0}", binaryPath);
+				return false;
+			}
+			return true;
+		}
+	} // namespace
+
+	const ScenePropertyRecord* SceneComponentRecord::FindProperty(StringId key, ScenePropertyType type) const
+	{
+		for (uint32_t i = 0; i < propertyCount; i++)
+		{
+			const ScenePropertyRecord& property = properties[i];
+			if (property.key == key.GetHash())
+			{
+				return property.type == type ? &property : nullptr;
+			}
+		}
+		return nullptr;
+	}
+
+	bool SceneFile::Open(const std::string& path)
+	{
+		Close();
+
+		if (!m_File.Open(path))
+		{
+			return false;
+		}
+
+		char* const	 base = m_File.Data();
+		const size_t size = m_File.Size();
+
+		const SceneFileHeader* header = reinterpret_cast<const SceneFileHeader*>(base);
+		if (size < sizeof(SceneFileHeader) || header->magic != SCENE_FILE_MAGIC)
+		{
+			LEI_ERROR("{0} is not a scene file", path);
+			m_File.Close();
+			return false;
+		}
+		if (header->version != SCENE_FILE_VERSION)
+		{
+			LEI_ERROR("{0} is scene file version {1}, but this build reads version {2}", path, header->version, SCENE_FILE_VERSION);
+			m_File.Close();
+			return false;
+		}
+		if (header->fileSize != size || header->relocationOffset % sizeof(uint64_t) != 0
+			|| header->relocationOffset + uint64_t(header->relocationCount) * sizeof(uint64_t) > size)
+		{
+			LEI_ERROR("{0} is truncated or corrupted", path);
+			m_File.Close();
+			return false;
+		}
+
+		// The pointer fixup: every offset in the file becomes an address inside the mapping.
+		const uint64_t* relocations = reinterpret_cast<const uint64_t*>(base + header->relocationOffset);
+		for (uint32_t i = 0; i < header->relocationCount; i++)
+		{
+			const uint64_t fieldOffset = relocations[i];
+			uint64_t*	   field = reinterpret_cast<uint64_t*>(base + fieldOffset);
+			if (fieldOffset % sizeof(uint64_t) != 0 || fieldOffset + sizeof(uint64_t) > size || *field >= size)
+			{
+				LEI_ERROR("{0} has a broken relocation table", path);
+				m_File.Close();
+				return false;
+			}
+			*field += reinterpret_cast<uintptr_t>(base);
+		}
+
+		m_Header = header;
+		return true;
+	}
+
+	void SceneFile::Close()
+	{
+		m_Header = nullptr;
+		m_File.Close();
+	}
+
+	bool SceneFile::IsSourceUnchanged(const std::string& textPath) const
+	{
+		return CheckSourceStamp(textPath, m_Header->source) != SOURCE_CHANGED;
+	}
+
+	bool SceneFile::Cook(const std::string& textPath, const std::string& binaryPath)
+	{
+		SourceStamp stamp;
+		if (!MakeSourceStamp(textPath, stamp))
+		{
+			return false;
+		}
+
+		SceneDesc scene;
+		if (!parseSceneText(textPath, scene))
+		{
+			return false;
+		}
+
+		if (!writeSceneBinary(scene, stamp, binaryPath))
+		{
+			return false;
+		}
+
+		LEI_INFO("Cooked {0} into {1} ({2} entities, {3} assets)", textPath, binaryPath, scene.entities.size(), scene.assets.size());
+		return true;
+	}
+
+	bool SceneFile::IsUpToDate(const std::string& textPath, const std::string& binaryPath)
+	{
+		std::error_code error;
+		if (!std::filesystem::exists(binaryPath, error))
+		{
+			return false;
+		}
+
+		SceneFile file;
+		if (!file.Open(binaryPath))
+		{
+			return false;
+		}
+
+		SourceStamp		  stamp;
+		const SourceState state = CheckSourceStamp(textPath, file.GetHeader().source, &stamp);
+		file.Close();
+		if (state == SOURCE_TOUCHED)
+		{
+			std::fstream fileStream(binaryPath, std::fstream::binary | std::fstream::in | std::fstream::out);
+			fileStream.seekp(offsetof(SceneFileHeader, source));
+			fileStream.write(reinterpret_cast<const char*>(&stamp), sizeof(stamp));
+		}
+		return state != SOURCE_CHANGED;
+	}
+} // namespace lei3d
@@ -0,0 +1,139 @@
+#pragma once
+
+#include "core/MappedFile.hpp"
+#include "core/SourceStamp.hpp"
+#include "core/StringId.hpp"
+
+#include <cstdint>
+#include <string>
+
+namespace lei3d
+{
+	/*
+	 * Scene files:
+	 * A scene is authored as text (Foo.lscene.txt, the version that gets diffed and reviewed) and cooked into a binary
+	 * twin (Foo.lscene) that the engine maps straight into memory. The binary is laid out exactly like the structs
+	 * below, with every pointer stored as an offset from the start of the file. A relocation table at the end lists
+	 * where those offsets are, so loading is one mmap plus one pass adding the base address to each of them.
+	 *
+	 * Text format, one statement per line (leading whitespace is ignored, # starts a comment):
+	 *     lscene 3                      Version, must come first.
+	 *     music <name>                  Optional, see AudioPlayer::PlayMusic.
+	 *     next <scene>                  Optional, the scene that usually follows this one, see Scene::GetPreloadHint.
+	 *     entity <name>                 Starts a new entity. Quote the name if it has leading/trailing spaces.
+	 *     parent <name>                 Entity statements (parent, position, rotation, yaw, scale) have to come
+	 *     position <x> <y> <z>          before the entity's first component.
+	 *     rotation <x> <y> <z> <w>      Quaternion.
+	 *     yaw <degrees>                 Shorthand for a rotation around the up axis.
+	 *     scale <x> <y> <z>
+	 *     component <type>              Starts a component of the entity, followed by its properties:
+	 *     <key> <value>                 One number (float), three numbers (vec3), @path (asset) or anything else (string).
+	 */
+
+	static constexpr uint32_t SCENE_FILE_MAGIC = 0x4E43534C; // "LSCN"
+	static constexpr uint32_t SCENE_FILE_VERSION = 3;
+
+	// A pointer stored as an offset into the file, until SceneFile::Open relocates it. 0 is nullptr in both forms.
+	template <typename T>
+	struct SceneFilePtr
+	{
+		uint64_t value;
+
+		T* Get() const { return reinterpret_cast<T*>(static_cast<uintptr_t>(value)); }
+		T& operator[](size_t i) const { return Get()[i]; }
+	};
+
+	enum ScenePropertyType : uint32_t
+	{
+		SCENE_PROPERTY_FLOAT,
+		SCENE_PROPERTY_VEC3,
+		SCENE_PROPERTY_STRING,
+		SCENE_PROPERTY_ASSET,
+	};
+
+	// All records only hold fixed size fields, ordered so there is no implicit padding.
+	struct SceneAssetRecord
+	{
+		uint64_t				 pathId; // StringId hash of path.
+		SceneFilePtr<const char> path;
+	};
+
+	struct ScenePropertyRecord
+	{
+		uint64_t				 key; // StringId hash of keyName.
+		SceneFilePtr<const char> keyName;
+		SceneFilePtr<const char> string; // SCENE_PROPERTY_STRING only.
+		uint32_t				 type;	 // ScenePropertyType
+		uint32_t				 asset;	 // SCENE_PROPERTY_ASSET only, index into the scene's assets.
+		float					 values[3];
+		uint32_t				 padding;
+	};
+
+	struct SceneComponentRecord
+	{
+		uint64_t								  type; // StringId hash of typeName.
+		SceneFilePtr<const char>				  typeName;
+		SceneFilePtr<const ScenePropertyRecord> properties;
+		uint32_t								  propertyCount;
+		uint32_t								  padding;
+
+		// nullptr if the component doesn't have the property, or has it with a different type.
+		const ScenePropertyRecord* FindProperty(StringId key, ScenePropertyType type) const;
+	};
+
+	struct SceneEntityRecord
+	{
+		SceneFilePtr<const char>				   name;
+		SceneFilePtr<const SceneComponentRecord> components;
+		uint32_t								   componentCount;
+		int32_t									   parent; // Index into the scene's entities, -1 for none.
+		float									   position[3];
+		float									   rotation[4]; // Quaternion as x, y, z, w.
+		float									   scale[3];
+	};
+
+	struct SceneFileHeader
+	{
+		uint32_t magic;
+		uint32_t version;
+		uint64_t fileSize;
+		uint64_t relocationOffset; // Array of relocationCount uint64_t file offsets, each pointing at a SceneFilePtr.
+		uint32_t relocationCount;
+		uint32_t entityCount;
+		uint32_t assetCount;
+		uint32_t padding;
+
+		SceneFilePtr<const SceneEntityRecord> entities;
+		SceneFilePtr<const SceneAssetRecord>  assets;
+		SceneFilePtr<const char>			  music;	 // nullptr if the scene has no music.
+		SceneFilePtr<const char>			  nextScene; // nullptr if the scene doesn't name one.
+		SourceStamp							  source;	 // Of the text it was cooked from.
+	};
+
+	class SceneFile
+	{
+	private:
+		MappedFile			   m_File;
+		const SceneFileHeader* m_Header = nullptr;
+
+	public:
+		// Maps a binary scene file and relocates its pointers. Returns false (and logs why) if it isn't a valid scene file.
+		bool Open(const std::string& path);
+		void Close();
+
+		bool				   IsOpen() const { return m_Header != nullptr; }
+		const SceneFileHeader& GetHeader() const { return *m_Header; }
+
+		// Whether the text it was cooked from is still the same (or isn't there to compare with).
+		bool IsSourceUnchanged(const std::string& textPath) const;
+
+		// Parses the text version of a scene and writes its binary twin. Returns false (and logs why) on failure.
+		static bool Cook(const std::string& textPath, const std::string& binaryPath);
+
+		/*
+		 * For lei3d_cook: whether the binary twin exists and is up to date. If the text was only touched (e.g. copied),
+		 * its recorded modification time is updated, so loading can tell without hashing the text again.
+		 */
+		static bool IsUpToDate(const std::string& textPath, const std::string& binaryPath);
+	};
+} // namespace lei3d
@@ -1,23 +1,26 @@
 #include "SceneManager.hpp"
 
+#include "core/AssetManager.hpp"
+
+#include "scenes/DataScene.hpp"
 #include "scenes/EmptyScene.hpp"
-#include "scenes/TestSceneKevin.hpp"
-#include "scenes/TestSceneLogan.hpp"
 
 #include "util/StringUtil.hpp"
 
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+
 namespace lei3d
 {
 	SceneManager* SceneManager::s_Instance = nullptr;
 
-	/* Need to implement these function pointers manually in TestScene.hpp / TestScene.cpp
+	/* Scenes that are still built in code, for things scene files can't describe yet.
+	 * Need to implement these function pointers manually in TestScene.hpp / TestScene.cpp
 	 * bc you can't cast from std::unique_ptr<TestBlaBlaScene> (*) () to std::unique_ptr<Scene> (*) ()
 	 * so we do this stinky boiler plate instead
 	 * */
-	std::unordered_map<std::string, std::unique_ptr<Scene> (*)()> SceneManager::s_SceneConstructors = {
-		{ "Test Kevin", MakeTestSceneKevin },
-		{ "Test Logan", MakeTestSceneLogan },
-	};
+	std::unordered_map<StringId, std::unique_ptr<Scene> (*)()> SceneManager::s_SceneConstructors = {};
 
 	SceneManager::SceneManager()
 	{
@@ -55,10 +58,32 @@ namespace lei3d
 
 			LEI_INFO(sceneName);
 
-			if (!sceneName.empty())
+			if (sceneName.empty())
 			{
-				m_AllScenes.push_back({ sceneName, s_SceneConstructors[sceneName]() });
+				continue;
 			}
+
+			// Only the descriptor is registered here, the scene gets created when it's first set active or preloaded.
+			// A scene file is named after the file (data/scenes/Foo.lscene is "Foo").
+			const std::filesystem::path scenePath(sceneName);
+			if (scenePath.extension() == ".lscene")
+			{
+				const std::string fileSceneName = scenePath.stem().string();
+				m_AllScenes.push_back({ StringId::Intern(fileSceneName), fileSceneName, [sceneName]() -> std::unique_ptr<Scene> {
+										   return std::make_unique<DataScene>(sceneName);
+									   } });
+				continue;
+			}
+
+			const StringId sceneId = StringId::Intern(sceneName);
+			auto		   constructor = s_SceneConstructors.find(sceneId);
+			if (constructor == s_SceneConstructors.end())
+			{
+				LEI_ERROR("No scene called {0} to build", sceneName);
+				continue;
+			}
+
+			m_AllScenes.push_back({ sceneId, sceneName, constructor->second });
 		}
 	}
 
@@ -77,73 +102,244 @@ namespace lei3d
 			return;
 		}
 
-		Scene* nextScene = scenes[sceneIndex].second.get();
-		s_Instance->SetNextScene(*nextScene);
+		s_Instance->m_NextIndex = sceneIndex;
 	}
 
-	void SceneManager::SetScene(std::string sceneName)
+	void SceneManager::SetScene(StringId sceneName)
 	{
-		// This is a structured binding. It allows us to unpack the scene name and object from an std::pair implicitly.
-		for (const auto& [currName, currScene] : s_Instance->m_AllScenes)
+		const int sceneIndex = s_Instance->FindScene(sceneName);
+		if (sceneIndex == NO_SCENE)
 		{
-			if (sceneName == currName)
-			{
-				s_Instance->SetNextScene(*currScene);
-				return;
-			}
+			LEI_ERROR("DID NOT FIND SCENE: {0}", sceneName.GetString());
+			return;
 		}
 
-		LEI_ERROR("DID NOT FIND SCENE: {0}", sceneName);
+		s_Instance->m_NextIndex = sceneIndex;
+	}
+
+	void SceneManager::PreloadScene(StringId sceneName)
+	{
+		const int sceneIndex = s_Instance->FindScene(sceneName);
+		if (sceneIndex == NO_SCENE)
+		{
+			LEI_WARN("Can't preload scene {0}, it isn't in the build", sceneName.GetString());
+			return;
+		}
+
+		s_Instance->m_PreloadIndex = sceneIndex;
 	}
 
 	std::vector<std::string> SceneManager::GetSceneNames()
 	{
 		std::vector<std::string> names;
-		for (const auto& [name, scene] : s_Instance->m_AllScenes)
+		for (const SceneEntry& entry : s_Instance->m_AllScenes)
 		{
-			names.push_back(name);
+			names.push_back(entry.name);
 		}
 
 		return names;
 	}
 
-	void SceneManager::SetNextScene(Scene& scene)
+	Scene& SceneManager::ActiveScene()
 	{
-		m_NextScene = &scene;
-		m_NeedsSceneSwitch = true;
+		LEI_ASSERT(s_Instance->m_ActiveScene, "Attempt to access active scene when there wasn't one.");
+		return *(s_Instance->m_ActiveScene);
 	}
 
-	Scene& SceneManager::ActiveScene()
+	bool SceneManager::HasActiveScene()
 	{
-		LEI_ASSERT(m_ActiveScene, "Attempt to access active scene when there wasn't one.");
-		return *(s_Instance->m_ActiveScene);
+		return s_Instance->m_ActiveScene != nullptr;
 	}
 
-	void SceneManager::LoadNextScene()
+	bool SceneManager::IsLoading()
 	{
-		if (m_NextScene == nullptr)
+		return s_Instance->m_NextIndex != NO_SCENE || (s_Instance->m_LoadingIndex != NO_SCENE && !s_Instance->m_LoadingIsPreload);
+	}
+
+	float SceneManager::GetLoadProgress()
+	{
+		// While a preload of some other scene finishes, the switch hasn't started yet.
+		const int target = s_Instance->m_NextIndex != NO_SCENE ? s_Instance->m_NextIndex : s_Instance->m_LoadingIndex;
+		return target == s_Instance->m_LoadingIndex ? s_Instance->m_LoadProgress.GetFraction() : 0.0f;
+	}
+
+	const std::string& SceneManager::GetLoadingSceneName()
+	{
+		static const std::string none;
+		const int				 target = s_Instance->m_NextIndex != NO_SCENE ? s_Instance->m_NextIndex : s_Instance->m_LoadingIndex;
+		return target == NO_SCENE ? none : s_Instance->m_AllScenes[target].name;
+	}
+
+	int SceneManager::GetMaxResidentScenes()
+	{
+		return s_Instance->m_MaxResidentScenes;
+	}
+
+	void SceneManager::SetMaxResidentScenes(int maxScenes)
+	{
+		s_Instance->m_MaxResidentScenes = std::max(maxScenes, 1);
+		s_Instance->EvictScenes();
+	}
+
+	int SceneManager::FindScene(StringId sceneName) const
+	{
+		for (int i = 0; i < m_AllScenes.size(); i++)
+		{
+			if (m_AllScenes[i].id == sceneName)
+			{
+				return i;
+			}
+		}
+		return NO_SCENE;
+	}
+
+	void SceneManager::UpdateLoading()
+	{
+		// Only one scene prepares at a time, anything else waits for it.
+		if (m_LoadingIndex != NO_SCENE)
+		{
+			if (m_LoadingTask.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+			{
+				return;
+			}
+
+			m_LoadingTask.get();
+			const int loadedIndex = m_LoadingIndex;
+			m_AllScenes[loadedIndex].prepared = true;
+			m_LoadingIndex = NO_SCENE;
+
+			if (!m_LoadingIsPreload)
+			{
+				Activate(loadedIndex);
+			}
+		}
+
+		if (m_NextIndex != NO_SCENE)
 		{
-			LEI_ERROR("Cannot load next scene because a scene was not set.");
+			const int nextIndex = m_NextIndex;
+			m_NextIndex = NO_SCENE;
+
+			// Preloaded already, all that's left is the upload.
+			if (m_AllScenes[nextIndex].prepared)
+			{
+				Activate(nextIndex);
+			}
+			else
+			{
+				StartPreparing(nextIndex, false);
+			}
 			return;
 		}
 
-		LoadScene(*m_NextScene);
-		m_NeedsSceneSwitch = false;
+		if (m_PreloadIndex != NO_SCENE)
+		{
+			const int preloadIndex = m_PreloadIndex;
+			m_PreloadIndex = NO_SCENE;
+
+			if (preloadIndex != m_ActiveIndex && !m_AllScenes[preloadIndex].prepared)
+			{
+				StartPreparing(preloadIndex, true);
+			}
+		}
 	}
 
-	bool SceneManager::NeedsSceneSwitch() const
+	void SceneManager::StartPreparing(int sceneIndex, bool preload)
 	{
-		return m_NeedsSceneSwitch;
+		SceneEntry& entry = m_AllScenes[sceneIndex];
+
+		// Reloading the active scene: it can't keep running while it prepares, so we go to the loading screen.
+		if (sceneIndex == m_ActiveIndex)
+		{
+			m_ActiveScene->Unload();
+			m_ActiveScene = nullptr;
+			m_ActiveIndex = NO_SCENE;
+		}
+
+		if (!entry.scene)
+		{
+			LEI_TRACE("Creating scene {0}", entry.name);
+			entry.scene = entry.create();
+		}
+		entry.lastUsed = ++m_UseCounter;
+
+		LEI_TRACE("{0} scene {1} in the background", preload ? "Preloading" : "Preparing", entry.name);
+		m_LoadingIndex = sceneIndex;
+		m_LoadingIsPreload = preload;
+		m_LoadProgress.completedSteps = 0;
+		m_LoadProgress.totalSteps = 0;
+
+		// Before starting the task, EvictScenes needs the loading thread to be idle.
+		EvictScenes();
+
+		Scene* scene = entry.scene.get();
+		m_LoadingTask = std::async(std::launch::async, [this, scene]() {
+			scene->Prepare(m_LoadProgress);
+		});
 	}
 
-	void SceneManager::LoadScene(Scene& scene)
+	void SceneManager::Activate(int sceneIndex)
 	{
+		SceneEntry& entry = m_AllScenes[sceneIndex];
+
 		if (m_ActiveScene != nullptr)
 		{
 			m_ActiveScene->Unload();
 		}
 
-		m_ActiveScene = &scene;
+		// Active before Load, components look the scene up through ActiveScene while they initialize.
+		m_ActiveIndex = sceneIndex;
+		m_ActiveScene = entry.scene.get();
+		entry.prepared = false;
+		entry.lastUsed = ++m_UseCounter;
 		m_ActiveScene->Load();
+
+		EvictScenes();
+
+		const StringId preloadHint = m_ActiveScene->GetPreloadHint();
+		if (preloadHint.IsValid())
+		{
+			PreloadScene(preloadHint);
+		}
+	}
+
+	void SceneManager::EvictScenes()
+	{
+		int residentScenes = 0;
+		for (const SceneEntry& entry : m_AllScenes)
+		{
+			residentScenes += entry.scene != nullptr;
+		}
+
+		// Inactive scenes are already unloaded (no entities), destroying them frees the rest: their pools, physics
+		// world and the asset handles a preload took, so AssetManager can evict those below.
+		while (residentScenes > m_MaxResidentScenes)
+		{
+			int leastRecent = NO_SCENE;
+			for (int i = 0; i < m_AllScenes.size(); i++)
+			{
+				const SceneEntry& entry = m_AllScenes[i];
+				if (entry.scene && i != m_ActiveIndex && i != m_LoadingIndex
+					&& (leastRecent == NO_SCENE || entry.lastUsed < m_AllScenes[leastRecent].lastUsed))
+				{
+					leastRecent = i;
+				}
+			}
+
+			if (leastRecent == NO_SCENE)
+			{
+				break;
+			}
+
+			LEI_TRACE("Destroying least recently used scene {0}", m_AllScenes[leastRecent].name);
+			m_AllScenes[leastRecent].scene.reset();
+			m_AllScenes[leastRecent].prepared = false;
+			residentScenes--;
+		}
+
+		// AssetManager can only measure its assets while nothing is preparing (the task has been collected).
+		if (!m_LoadingTask.valid())
+		{
+			AssetManager::EvictUnused();
+		}
 	}
-} // namespace lei3d
\ No newline at end of file
+} // namespace lei3d
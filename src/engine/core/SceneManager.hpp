@@ -2,6 +2,10 @@
 
 #include "Scene.hpp"
 
+#include "core/StringId.hpp"
+
+#include <functional>
+#include <future>
 #include <memory>
 #include <vector>
 
@@ -12,33 +16,81 @@ namespace lei3d
 	class SceneManager
 	{
 	private:
-		static SceneManager*												 s_Instance;
-		static std::unordered_map<std::string, std::unique_ptr<Scene> (*)()> s_SceneConstructors;
+		/*
+		 * Every scene in Build.config is registered as one of these at startup, but the Scene itself is only created
+		 * once it's needed (set active or preloaded), and destroyed again when it falls out of the LRU.
+		 */
+		struct SceneEntry
+		{
+			StringId								id;
+			std::string								name;
+			std::function<std::unique_ptr<Scene>()> create;
+			std::unique_ptr<Scene>					scene;			  // nullptr while not resident.
+			bool									prepared = false; // Prepare has run but Load hasn't yet (it was preloaded).
+			uint64_t								lastUsed = 0;	  // m_UseCounter when it was last activated or prepared.
+		};
+
+		static constexpr int NO_SCENE = -1;
+
+		static SceneManager*											  s_Instance;
+		static std::unordered_map<StringId, std::unique_ptr<Scene> (*)()> s_SceneConstructors;
+
+		std::vector<SceneEntry> m_AllScenes;
+		Scene*					m_ActiveScene = nullptr; // m_AllScenes[m_ActiveIndex].scene, cached for ActiveScene.
+		int						m_ActiveIndex = NO_SCENE;
+		int						m_NextIndex = NO_SCENE; // Set by SetScene, picked up by UpdateLoading.
+		int						m_PreloadIndex = NO_SCENE;
+		uint64_t				m_UseCounter = 0;
+		int						m_MaxResidentScenes = 2; // The active scene plus one preloaded or recently used.
 
-		std::vector<std::pair<std::string, std::unique_ptr<Scene>>> m_AllScenes;
-		Scene*														m_ActiveScene = nullptr;
-		Scene*														m_NextScene = nullptr;
-		bool														m_NeedsSceneSwitch = false;
+		// The scene being prepared on the loading thread, if any. Only one at a time. The task is declared last so its
+		// destructor waits for the loading thread before anything that thread writes to is destroyed.
+		int				  m_LoadingIndex = NO_SCENE;
+		bool			  m_LoadingIsPreload = false;
+		SceneLoadProgress m_LoadProgress;
+		std::future<void> m_LoadingTask;
 
 	public:
 		SceneManager();
 
 		static void SetScene(int sceneIndex);
-		static void SetScene(std::string sceneName);
+		static void SetScene(StringId sceneName);
+
+		/*
+		 * Prepares a scene on the loading thread without switching to it, so a later SetScene only has to do the
+		 * final GPU upload. Scenes can also ask for this themselves through Scene::GetPreloadHint.
+		 */
+		static void PreloadScene(StringId sceneName);
 
 		static Scene&					ActiveScene();
+		static bool						HasActiveScene(); // False until the first scene has loaded.
 		static std::vector<std::string> GetSceneNames();
 
 		static bool HasScenes();
 
+		// Loading progress of the scene being switched to, for a loading screen. Preloading doesn't count.
+		static bool				  IsLoading();
+		static float			  GetLoadProgress();
+		static const std::string& GetLoadingSceneName();
+
+		// How many scenes (active and inactive) may exist at once before the least recently used get destroyed.
+		static int	GetMaxResidentScenes();
+		static void SetMaxResidentScenes(int maxScenes);
+
 		void Init();
-		void LoadNextScene();
-		bool NeedsSceneSwitch() const;
+
+		/*
+		 * Called once per frame on the main thread. Starts preparing the scene set by SetScene on the loading thread,
+		 * and once that is done swaps it in for the active scene. The active scene keeps running in the meantime.
+		 */
+		void UpdateLoading();
 
 		void BuildScenesFromFile(std::string filepath);
 
 	private:
-		void SetNextScene(Scene& scene);
-		void LoadScene(Scene& scene);
+		int	 FindScene(StringId sceneName) const;
+		void StartPreparing(int sceneIndex, bool preload);
+		void Activate(int sceneIndex);
+		void EvictScenes();
 	};
-} // namespace lei3d
\ No newline at end of file
+} // namespace lei3d
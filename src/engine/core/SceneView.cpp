@@ -48,14 +48,14 @@ namespace lei3d
 		ActiveCamera(scene).PollCameraMovementInput(); //Kinda jank
 	}
 
-	void SceneView::ProcessKeyboardInput(GLFWwindow* window, int key, int scancode, int action, int mods)
+	void SceneView::ProcessKeyboardInput(const InputEvent& event)
 	{
-		if (key == GLFW_KEY_R && action == GLFW_PRESS)
+		if (event.code == GLFW_KEY_R && event.action == GLFW_PRESS)
 		{
 			Reset(SceneManager::ActiveScene());
 		}
 
-		if (key == GLFW_KEY_Q && action == GLFW_PRESS)
+		if (event.code == GLFW_KEY_Q && event.action == GLFW_PRESS)
 		{
 			TogglePlayPause(SceneManager::ActiveScene());
 		}
@@ -65,10 +65,7 @@ namespace lei3d
 	{
 		// SCENE CONTROL WIDGETS ----------------------------------------------
 
-		std::stringstream ss;
-		ss << "State: ";
-		ss << scene.StateToString();
-		ImGui::Text(ss.str().c_str());
+		ImGui::Text("State: %s", scene.StateToString().c_str());
 
 		if (ImGui::Button("Play/Pause"))
 		{
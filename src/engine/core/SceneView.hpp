@@ -1,6 +1,7 @@
 #pragma once
 
 #include "core/FlyCamera.hpp"
+#include "core/Input.hpp"
 #include "core/Scene.hpp"
 
 #include <memory>
@@ -39,7 +40,7 @@ namespace lei3d
 		Camera& ActiveCamera(const Scene& scene) const;
 
 		void OnImGuiRender(Scene& scene);
-		void ProcessKeyboardInput(GLFWwindow* window, int key, int scancode, int action, int mods);
+		void ProcessKeyboardInput(const InputEvent& event);
 	private:
 		void TogglePlayPause(Scene& scene);
 		void Reset(Scene& scene);
@@ -0,0 +1,99 @@
+#include "SourceStamp.hpp"
+
+#include "logging/Log.hpp"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+namespace lei3d
+{
+	namespace fs = std::filesystem;
+
+	static bool statSource(const std::string& sourcePath, uint64_t& size, int64_t& modified)
+	{
+		std::error_code error;
+		size = fs::file_size(sourcePath, error);
+		if (error)
+		{
+			return false;
+		}
+		const fs::file_time_type time = fs::last_write_time(sourcePath, error);
+		modified = time.time_since_epoch().count();
+		return !error;
+	}
+
+	static bool hashSource(const std::string& sourcePath, uint64_t& hash)
+	{
+		std::ifstream file(sourcePath, std::ifstream::binary);
+		if (!file)
+		{
+			return false;
+		}
+
+		constexpr uint64_t FNV_PRIME = 1099511628211ull;
+		std::vector<char>  buffer(1 << 20);
+		hash = 14695981039346656037ull;
+		while (file)
+		{
+			file.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+			const size_t read = static_cast<size_t>(file.gcount());
+			size_t		 i = 0;
+			for (; i + sizeof(uint64_t) <= read; i += sizeof(uint64_t))
+			{
+				uint64_t word;
+				std::memcpy(&word, buffer.data() + i, sizeof(word));
+				hash = (hash ^ word) * FNV_PRIME;
+			}
+			for (; i < read; i++)
+			{
+				hash = (hash ^ static_cast<unsigned char>(buffer[i])) * FNV_PRIME;
+			}
+		}
+		return file.eof();
+	}
+
+	bool MakeSourceStamp(const std::string& sourcePath, SourceStamp& stamp)
+	{
+		if (!statSource(sourcePath, stamp.size, stamp.modified) || !hashSource(sourcePath, stamp.hash))
+		{
+			LEI_ERROR("Failed to read {0}", sourcePath);
+			return false;
+		}
+		return true;
+	}
+
+	SourceState CheckSourceStamp(const std::string& sourcePath, const SourceStamp& stamp, SourceStamp* current)
+	{
+		uint64_t size;
+		int64_t	 modified;
+		if (!statSource(sourcePath, size, modified))
+		{
+			return SOURCE_MISSING;
+		}
+		if (size != stamp.size)
+		{
+			return SOURCE_CHANGED;
+		}
+		if (modified == stamp.modified)
+		{
+			if (current)
+			{
+				*current = stamp;
+			}
+			return SOURCE_UNCHANGED;
+		}
+
+		uint64_t hash;
+		if (!hashSource(sourcePath, hash) || hash != stamp.hash)
+		{
+			return SOURCE_CHANGED;
+		}
+		if (current)
+		{
+			*current = { size, modified, hash };
+		}
+		return SOURCE_TOUCHED;
+	}
+} // namespace lei3d
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace lei3d
+{
+	/*
+	 * Identifies the source file a cooked file was made from, so loading and cooking can tell whether the cooked file
+	 * is still up to date. Comparing modification times alone doesn't work: copying the data directory (the build does
+	 * with cmake -E copy_directory) gives every copy a new one, in whatever order the files happen to be copied.
+	 * So the cooked file records the source's size, modification time and a hash of its contents. Matching size and
+	 * time are taken as unchanged without reading the source, otherwise the contents decide.
+	 */
+	struct SourceStamp
+	{
+		uint64_t size;
+		int64_t	 modified; // last_write_time, in the file clock's ticks.
+		uint64_t hash;	   // Of the contents, 64 bit FNV-1a over 8 byte words.
+	};
+
+	enum SourceState
+	{
+		SOURCE_UNCHANGED,
+		SOURCE_TOUCHED, // Same contents, but a different modification time. Still up to date.
+		SOURCE_CHANGED,
+		SOURCE_MISSING, // Shipped without its sources, the cooked file is all there is.
+	};
+
+	// Reads the whole file to hash it. Returns false (and logs why) if it can't be read.
+	bool		MakeSourceStamp(const std::string& sourcePath, SourceStamp& stamp);
+	// current (optional) gets the source's stamp as of now, if its contents are unchanged.
+	SourceState CheckSourceStamp(const std::string& sourcePath, const SourceStamp& stamp, SourceStamp* current = nullptr);
+} // namespace lei3d
@@ -0,0 +1,49 @@
+#include "StringId.hpp"
+
+#include "logging/Log.hpp"
+
+#include <mutex>
+#include <unordered_map>
+
+namespace lei3d
+{
+	namespace
+	{
+		struct InternTable
+		{
+			std::mutex								  mutex;
+			std::unordered_map<uint64_t, std::string> strings; // Node based, so the c_str()s stay put.
+		};
+
+		// Function local so IDs can be interned from other statics' initializers.
+		InternTable& GetInternTable()
+		{
+			static InternTable s_Table;
+			return s_Table;
+		}
+	} // namespace
+
+	StringId StringId::Intern(std::string_view str)
+	{
+		const StringId id(str);
+
+		InternTable&				table = GetInternTable();
+		std::lock_guard<std::mutex> lock(table.mutex);
+
+		auto [it, inserted] = table.strings.try_emplace(id.m_Hash, str);
+		if (!inserted && it->second != str)
+		{
+			LEI_ERROR("StringId collision between \"{0}\" and \"{1}\"", it->second, std::string(str));
+		}
+		return id;
+	}
+
+	const char* StringId::GetString() const
+	{
+		InternTable&				table = GetInternTable();
+		std::lock_guard<std::mutex> lock(table.mutex);
+
+		auto it = table.strings.find(m_Hash);
+		return it != table.strings.end() ? it->second.c_str() : "<unknown>";
+	}
+} // namespace lei3d
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+
+namespace lei3d
+{
+	/*
+	 * A string reduced to its 64 bit FNV-1a hash, for names that get looked up or compared a lot (uniforms, entity
+	 * and scene names, sounds). Comparing and hashing a StringId is comparing and hashing one integer.
+	 *
+	 * Hashing is constexpr, so an ID made from a literal can cost nothing at runtime:
+	 *     constexpr StringId ALBEDO = "material.albedo"_sid;
+	 *
+	 * A StringId doesn't keep its string. Anything that should be readable later (in logs or the editor) has to go
+	 * through Intern once, which also catches hash collisions between interned strings.
+	 */
+	class StringId
+	{
+	private:
+		static constexpr uint64_t FNV_OFFSET_BASIS = 14695981039346656037ull;
+		static constexpr uint64_t FNV_PRIME = 1099511628211ull;
+
+		uint64_t m_Hash = 0; // 0 means no string at all, which no real string hashes to in practice.
+
+	public:
+		static constexpr uint64_t Hash(std::string_view str)
+		{
+			uint64_t hash = FNV_OFFSET_BASIS;
+			for (char c : str)
+			{
+				hash ^= static_cast<uint8_t>(c);
+				hash *= FNV_PRIME;
+			}
+			return hash;
+		}
+
+		constexpr StringId() = default;
+		constexpr StringId(const char* str)
+			: m_Hash(Hash(str))
+		{
+		}
+		constexpr StringId(std::string_view str)
+			: m_Hash(Hash(str))
+		{
+		}
+		StringId(const std::string& str)
+			: m_Hash(Hash(str))
+		{
+		}
+
+		// Hashes str and remembers it, so GetString works on the result. Thread safe.
+		static StringId Intern(std::string_view str);
+
+		// For hashes that were stored somewhere (e.g. a scene file) and are being read back.
+		static constexpr StringId FromHash(uint64_t hash)
+		{
+			StringId id;
+			id.m_Hash = hash;
+			return id;
+		}
+
+		constexpr uint64_t GetHash() const { return m_Hash; }
+		constexpr bool	   IsValid() const { return m_Hash != 0; }
+
+		// Reverse lookup through the intern table. Meant for debugging, it takes a lock.
+		// Returns "<unknown>" for IDs whose string was never interned.
+		const char* GetString() const;
+
+		constexpr bool operator==(const StringId& other) const = default;
+	};
+
+	consteval StringId operator""_sid(const char* str, size_t length)
+	{
+		return StringId(std::string_view(str, length));
+	}
+} // namespace lei3d
+
+template <>
+struct std::hash<lei3d::StringId>
+{
+	size_t operator()(const lei3d::StringId& id) const noexcept
+	{
+		// Already a good hash, nothing left to mix.
+		return static_cast<size_t>(id.GetHash());
+	}
+};
@@ -0,0 +1,125 @@
+#include "SystemRegistry.hpp"
+
+#include "core/JobSystem.hpp"
+#include "core/TransformSystem.hpp"
+
+#include "components/CharacterController.hpp"
+#include "components/FollowCameraController.hpp"
+#include "components/StaticCollider.hpp"
+
+#include <algorithm>
+
+namespace lei3d
+{
+	SystemRegistry& SystemRegistry::Get()
+	{
+		static SystemRegistry s_Registry = []() {
+			SystemRegistry registry;
+			registry.RegisterEngineSystems();
+			return registry;
+		}();
+		return s_Registry;
+	}
+
+	/*
+	 * The order here is the order hooks run in each frame.
+	 * Only register a component for the phases it overrides (Register static_asserts on this).
+	 * Everything here touches Bullet or the camera, so it all stays on the main thread for now.
+	 */
+	void SystemRegistry::RegisterEngineSystems()
+	{
+		// UPDATE -----------------------------------
+		// Character controller copies the camera yaw onto the player before the camera follows the player.
+		Register<CharacterController, PHASE_UPDATE>("CharacterController",
+			{ MakeComponentMask<FollowCameraController>(), MakeComponentMask<Transform>() });
+		Register<FollowCameraController, PHASE_UPDATE>("FollowCameraController",
+			{ {}, MakeComponentMask<Transform>() });
+
+		// PHYSICS UPDATE ---------------------------
+		Register<CharacterController, PHASE_PHYSICS_UPDATE>("CharacterController",
+			{ {}, MakeComponentMask<Transform>() });
+		Register<StaticCollider, PHASE_PHYSICS_UPDATE>("StaticCollider",
+			{ {}, MakeComponentMask<Transform>() });
+
+		// EDITOR UPDATE ----------------------------
+		// Nothing implements OnEditorUpdate yet.
+	}
+
+	void SystemRegistry::Run(SystemPhase phase, ComponentStorage& storage, JobSystem* jobs) const
+	{
+		const std::vector<System>& systems = m_Systems[phase];
+
+		if (!jobs)
+		{
+			for (const System& system : systems)
+			{
+				if (ComponentPoolBase* pool = storage.FindPool(system.typeID))
+				{
+					system.run(*pool, 0, UINT32_MAX);
+				}
+			}
+			return;
+		}
+
+		// Run consecutive systems that don't conflict with each other as one batch. Conflicting systems end up in
+		// different batches, so they still run in registration order.
+		size_t batchStart = 0;
+		while (batchStart < systems.size())
+		{
+			size_t batchEnd = batchStart + 1;
+			while (batchEnd < systems.size())
+			{
+				const bool conflicts = std::any_of(systems.begin() + batchStart, systems.begin() + batchEnd,
+					[&](const System& other) { return systems[batchEnd].access.ConflictsWith(other.access); });
+				if (conflicts)
+				{
+					break;
+				}
+				batchEnd++;
+			}
+
+			// Parallel systems go out to the workers first, then main thread systems run while they're busy.
+			JobCounter counter;
+			for (size_t i = batchStart; i < batchEnd; i++)
+			{
+				const System&	   system = systems[i];
+				ComponentPoolBase* pool = storage.FindPool(system.typeID);
+				if (!pool || !system.access.parallel)
+				{
+					continue;
+				}
+
+				constexpr uint32_t JOBS_PER_THREAD = 4;
+				const uint32_t	   chunkCount = pool->ChunkCount();
+				const uint32_t	   grainSize = std::max(1u, chunkCount / (jobs->ThreadCount() * JOBS_PER_THREAD));
+				for (uint32_t first = 0; first < chunkCount; first += grainSize)
+				{
+					const uint32_t last = std::min(chunkCount, first + grainSize);
+					jobs->Run([&system, pool, first, last]() { system.run(*pool, first, last); }, counter);
+				}
+			}
+
+			for (size_t i = batchStart; i < batchEnd; i++)
+			{
+				const System& system = systems[i];
+				if (system.access.parallel)
+				{
+					continue;
+				}
+
+				if (ComponentPoolBase* pool = storage.FindPool(system.typeID))
+				{
+					system.run(*pool, 0, UINT32_MAX);
+				}
+			}
+
+			jobs->Wait(counter);
+			batchStart = batchEnd;
+		}
+	}
+
+	const std::vector<SystemRegistry::System>& SystemRegistry::GetSystems(SystemPhase phase) const
+	{
+		return m_Systems[phase];
+	}
+} // namespace lei3d
@@ -0,0 +1,129 @@
+#pragma once
+
+#include "core/Component.hpp"
+#include "core/ComponentPool.hpp"
+#include "core/ComponentStorage.hpp"
+#include "core/ComponentType.hpp"
+
+#include <array>
+#include <type_traits>
+#include <vector>
+
+namespace lei3d
+{
+	class JobSystem;
+
+	enum SystemPhase
+	{
+		PHASE_UPDATE,
+		PHASE_PHYSICS_UPDATE,
+		PHASE_EDITOR_UPDATE,
+		PHASE_COUNT,
+	};
+
+	/*
+	 * What a system touches besides the components it updates, used to decide what can run at the same time.
+	 *
+	 * reads/writes are masks of component types (see MakeComponentMask). Things that aren't components can get a bit
+	 * too: GetComponentTypeID works for any type, e.g. Transform stands for the entity transforms.
+	 * The system's own component type is always counted as written.
+	 *
+	 * A parallel system gets its pool split across threads, so its hook may only write to its own component and its
+	 * own entity's transform (local values only, no parenting or world matrices). Anything that touches shared state
+	 * (Bullet, GL, ImGui, cameras, ...) has to stay on the main thread, which is the default.
+	 */
+	struct SystemAccess
+	{
+		ComponentMask reads;
+		ComponentMask writes;
+		bool		  parallel = false;
+
+		bool ConflictsWith(const SystemAccess& other) const
+		{
+			return (writes & (other.reads | other.writes)).any() || (other.writes & reads).any();
+		}
+	};
+
+	/*
+	 * Decides which component hooks run in each phase of the frame, and in what order.
+	 *
+	 * A component type only gets called in the phases it was registered for. Each registered system is one tight
+	 * loop over that type's pool, calling the hook non-virtually, so components that don't implement a hook
+	 * (ModelInstance, SkyBox, ...) cost nothing.
+	 *
+	 * Systems in a phase run in the order they were registered. With a JobSystem, consecutive systems whose accesses
+	 * don't conflict run at the same time, and parallel systems are split across threads chunk by chunk.
+	 * The engine's systems are registered in RegisterEngineSystems (SystemRegistry.cpp); add new component types there.
+	 */
+	class SystemRegistry
+	{
+	public:
+		// Runs the system over the pool's chunks [firstChunk, lastChunk).
+		using RunFn = void (*)(ComponentPoolBase& pool, uint32_t firstChunk, uint32_t lastChunk);
+
+		struct System
+		{
+			const char*		name;
+			ComponentTypeID typeID;
+			RunFn			run;
+			SystemAccess	access;
+		};
+
+	private:
+		std::array<std::vector<System>, PHASE_COUNT> m_Systems;
+
+	public:
+		SystemRegistry() = default;
+
+		static SystemRegistry& Get(); // The engine's systems.
+
+		template <typename C, SystemPhase Phase>
+		void Register(const char* name, SystemAccess access = {})
+		{
+			static_assert(std::is_convertible<C, Component>::value, "C must be a component type.");
+			// If one of these is hitting, the component is registered for a phase it doesn't implement a hook for.
+			if constexpr (Phase == PHASE_UPDATE)
+			{
+				static_assert(!std::is_same_v<decltype(&C::Update), decltype(&Component::Update)>, "C does not override Update.");
+			}
+			else if constexpr (Phase == PHASE_PHYSICS_UPDATE)
+			{
+				static_assert(!std::is_same_v<decltype(&C::PhysicsUpdate), decltype(&Component::PhysicsUpdate)>, "C does not override PhysicsUpdate.");
+			}
+			else if constexpr (Phase == PHASE_EDITOR_UPDATE)
+			{
+				static_assert(!std::is_same_v<decltype(&C::OnEditorUpdate), decltype(&Component::OnEditorUpdate)>, "C does not override OnEditorUpdate.");
+			}
+
+			access.writes.set(GetComponentTypeID<C>());
+			m_Systems[Phase].push_back({ name, GetComponentTypeID<C>(), &RunPhase<C, Phase>, access });
+		}
+
+		// Without a job system everything runs in order on the calling thread.
+		void Run(SystemPhase phase, ComponentStorage& storage, JobSystem* jobs = nullptr) const;
+
+		const std::vector<System>& GetSystems(SystemPhase phase) const;
+
+	private:
+		void RegisterEngineSystems();
+
+		template <typename C, SystemPhase Phase>
+		static void RunPhase(ComponentPoolBase& pool, uint32_t firstChunk, uint32_t lastChunk)
+		{
+			// Qualified calls so the compiler can skip the vtable and inline the hook.
+			auto& typedPool = static_cast<ComponentPool<C>&>(pool);
+			if constexpr (Phase == PHASE_UPDATE)
+			{
+				typedPool.ForEachInChunks(firstChunk, lastChunk, [](C& component) { component.C::Update(); });
+			}
+			else if constexpr (Phase == PHASE_PHYSICS_UPDATE)
+			{
+				typedPool.ForEachInChunks(firstChunk, lastChunk, [](C& component) { component.C::PhysicsUpdate(); });
+			}
+			else if constexpr (Phase == PHASE_EDITOR_UPDATE)
+			{
+				typedPool.ForEachInChunks(firstChunk, lastChunk, [](C& component) { component.C::OnEditorUpdate(); });
+			}
+		}
+	};
+} // namespace lei3d
@@ -0,0 +1,603 @@
+#include "TransformSystem.hpp"
+
+#include "logging/Log.hpp"
+
+#include <btBulletDynamicsCommon.h>
+
+#include <cmath>
+
+namespace lei3d
+{
+	float Transform::GetYawRotation() const
+	{
+		// atan2 of the rotated x axis in the xz plane, i.e. the same angle glm::rotate(yaw, up) would have been given.
+		const glm::quat& q = rotation;
+		return glm::degrees(std::atan2(2.0f * (q.x * q.z + q.w * q.y), 1.0f - 2.0f * (q.y * q.y + q.z * q.z)));
+	}
+
+	void Transform::SetYawRotation(float yawRotation)
+	{
+		rotation = glm::angleAxis(glm::radians(yawRotation), glm::vec3(0.0f, 1.0f, 0.0f));
+	}
+
+	// Removes the scale from a world matrix's basis, leaving only its rotation.
+	static glm::mat3 NormalizedBasis(const glm::mat4& matrix)
+	{
+		glm::mat3 basis;
+		basis[0] = glm::normalize(glm::vec3(matrix[0]));
+		basis[1] = glm::normalize(glm::vec3(matrix[1]));
+		basis[2] = glm::normalize(glm::vec3(matrix[2]));
+		return basis;
+	}
+
+	void TransformSystem::LocalTransforms::PushBack(const Transform& transform)
+	{
+		positionX.push_back(transform.position.x);
+		positionY.push_back(transform.position.y);
+		positionZ.push_back(transform.position.z);
+		rotationX.push_back(transform.rotation.x);
+		rotationY.push_back(transform.rotation.y);
+		rotationZ.push_back(transform.rotation.z);
+		rotationW.push_back(transform.rotation.w);
+		scaleX.push_back(transform.scale.x);
+		scaleY.push_back(transform.scale.y);
+		scaleZ.push_back(transform.scale.z);
+	}
+
+	Transform TransformSystem::LocalTransforms::Get(uint32_t i) const
+	{
+		Transform transform;
+		transform.position = glm::vec3(positionX[i], positionY[i], positionZ[i]);
+		transform.rotation = glm::quat(rotationW[i], rotationX[i], rotationY[i], rotationZ[i]);
+		transform.scale = glm::vec3(scaleX[i], scaleY[i], scaleZ[i]);
+		return transform;
+	}
+
+	void TransformSystem::LocalTransforms::Set(uint32_t i, const Transform& transform)
+	{
+		SetPosition(i, transform.position);
+		SetRotation(i, transform.rotation);
+		scaleX[i] = transform.scale.x;
+		scaleY[i] = transform.scale.y;
+		scaleZ[i] = transform.scale.z;
+	}
+
+	void TransformSystem::LocalTransforms::SetPosition(uint32_t i, const glm::vec3& position)
+	{
+		positionX[i] = position.x;
+		positionY[i] = position.y;
+		positionZ[i] = position.z;
+	}
+
+	void TransformSystem::LocalTransforms::SetRotation(uint32_t i, const glm::quat& rotation)
+	{
+		rotationX[i] = rotation.x;
+		rotationY[i] = rotation.y;
+		rotationZ[i] = rotation.z;
+		rotationW[i] = rotation.w;
+	}
+
+	void TransformSystem::LocalTransforms::Permute(const std::vector<uint32_t>& order, AlignedVector<float>& scratch)
+	{
+		// Swapping hands the old array to the next one as its scratch, so only the first resize can allocate.
+		for (AlignedVector<float>* array : { &positionX, &positionY, &positionZ, &rotationX, &rotationY, &rotationZ, &rotationW, &scaleX, &scaleY, &scaleZ })
+		{
+			scratch.resize(order.size());
+			for (size_t i = 0; i < order.size(); i++)
+			{
+				scratch[i] = (*array)[order[i]];
+			}
+			array->swap(scratch);
+		}
+	}
+
+	void TransformSystem::LocalTransforms::Clear()
+	{
+		for (AlignedVector<float>* array : { &positionX, &positionY, &positionZ, &rotationX, &rotationY, &rotationZ, &rotationW, &scaleX, &scaleY, &scaleZ })
+		{
+			array->clear();
+		}
+	}
+
+	void TransformSystem::Add(EntityHandle handle)
+	{
+		if (handle.index >= m_SparseToDense.size())
+		{
+			m_SparseToDense.resize(handle.index + 1, NONE);
+		}
+		LEI_ASSERT(m_SparseToDense[handle.index] == NONE, "Entity already has a transform.");
+
+		// New transforms are roots, so appending them keeps parents before children.
+		const Transform identity;
+		m_SparseToDense[handle.index] = static_cast<uint32_t>(m_Handles.size());
+		m_Handles.push_back(handle);
+		m_Parents.push_back(NONE);
+		m_Locals.PushBack(identity);
+		m_Previous.PushBack(identity);
+		m_LocalMatrices.push_back(glm::mat4(1.0f));
+		m_WorldMatrices.push_back(glm::mat4(1.0f));
+		m_RenderMatrices.push_back(glm::mat4(1.0f));
+		m_Flags.push_back(TRANSFORM_CLEAN);
+	}
+
+	void TransformSystem::Remove(EntityHandle handle)
+	{
+		// The row stays (parent link and matrices included) until ApplyRemovals, so its children still have a world
+		// transform to keep. RebuildOrder drops anything with an invalid handle.
+		const uint32_t dense = DenseIndex(handle);
+		m_SparseToDense[handle.index] = NONE;
+		m_Handles[dense] = EntityHandle{};
+		m_AnyRemoved = true;
+	}
+
+	void TransformSystem::ApplyRemovals()
+	{
+		if (m_AnyRemoved)
+		{
+			ReparentOrphans();
+			RebuildOrder();
+			m_AnyRemoved = false;
+		}
+	}
+
+	void TransformSystem::Clear()
+	{
+		m_SparseToDense.clear();
+		m_Handles.clear();
+		m_Parents.clear();
+		m_Locals.Clear();
+		m_Previous.Clear();
+		m_LocalMatrices.clear();
+		m_WorldMatrices.clear();
+		m_RenderMatrices.clear();
+		m_Flags.clear();
+		m_AnyDirty = false;
+		m_AnyInterpolating = false;
+		m_RenderDirty = false;
+		m_AnyRemoved = false;
+	}
+
+	Transform TransformSystem::GetLocal(EntityHandle handle) const
+	{
+		return m_Locals.Get(DenseIndex(handle));
+	}
+
+	void TransformSystem::SetLocal(EntityHandle handle, const Transform& transform)
+	{
+		const uint32_t dense = DenseIndex(handle);
+		m_Locals.Set(dense, transform);
+		if (!m_InFixedTick)
+		{
+			m_Previous.Set(dense, transform);
+		}
+		MarkDirty(dense);
+	}
+
+	void TransformSystem::SetPosition(EntityHandle handle, const glm::vec3& position)
+	{
+		const uint32_t dense = DenseIndex(handle);
+		m_Locals.SetPosition(dense, position);
+		if (!m_InFixedTick)
+		{
+			m_Previous.SetPosition(dense, position);
+		}
+		MarkDirty(dense);
+	}
+
+	void TransformSystem::SetRotation(EntityHandle handle, const glm::quat& rotation)
+	{
+		const uint32_t dense = DenseIndex(handle);
+		m_Locals.SetRotation(dense, glm::normalize(rotation));
+		if (!m_InFixedTick)
+		{
+			m_Previous.SetRotation(dense, glm::normalize(rotation));
+		}
+		MarkDirty(dense);
+	}
+
+	void TransformSystem::SetScale(EntityHandle handle, const glm::vec3& scale)
+	{
+		const uint32_t dense = DenseIndex(handle);
+		m_Locals.scaleX[dense] = scale.x;
+		m_Locals.scaleY[dense] = scale.y;
+		m_Locals.scaleZ[dense] = scale.z;
+		if (!m_InFixedTick)
+		{
+			m_Previous.scaleX[dense] = scale.x;
+			m_Previous.scaleY[dense] = scale.y;
+			m_Previous.scaleZ[dense] = scale.z;
+		}
+		MarkDirty(dense);
+	}
+
+	bool TransformSystem::SetParent(EntityHandle child, EntityHandle parent)
+	{
+		// The rebuild below would drop removed transforms without moving their children first.
+		ApplyRemovals();
+
+		const uint32_t childDense = DenseIndex(child);
+		const uint32_t parentDense = parent.IsValid() ? DenseIndex(parent) : NONE;
+
+		for (uint32_t ancestor = parentDense; ancestor != NONE; ancestor = m_Parents[ancestor])
+		{
+			if (ancestor == childDense)
+			{
+				LEI_WARN("Can't parent an entity to itself or one of its descendants.");
+				return false;
+			}
+		}
+
+		m_Parents[childDense] = parentDense;
+		MarkDirty(childDense);
+
+		// A parent that comes after its new child breaks the one pass update, so restore the order.
+		if (parentDense != NONE && parentDense > childDense)
+		{
+			RebuildOrder();
+		}
+		return true;
+	}
+
+	EntityHandle TransformSystem::GetParent(EntityHandle handle) const
+	{
+		const uint32_t parent = m_Parents[DenseIndex(handle)];
+		return parent != NONE ? m_Handles[parent] : EntityHandle{};
+	}
+
+	const glm::mat4& TransformSystem::GetLocalMatrix(EntityHandle handle)
+	{
+		if (m_AnyDirty)
+		{
+			Update();
+		}
+		return m_LocalMatrices[DenseIndex(handle)];
+	}
+
+	const glm::mat4& TransformSystem::GetWorldMatrix(EntityHandle handle)
+	{
+		if (m_AnyDirty)
+		{
+			Update();
+		}
+		return m_WorldMatrices[DenseIndex(handle)];
+	}
+
+	const glm::mat4& TransformSystem::GetRenderMatrix(EntityHandle handle)
+	{
+		Update();
+		return m_RenderMatrices[DenseIndex(handle)];
+	}
+
+	void TransformSystem::BeginFixedTick()
+	{
+		m_Previous = m_Locals;
+		m_InFixedTick = true;
+
+		// Whatever was interpolating has now fully arrived (previous == current), so its render matrix needs one more
+		// update to land exactly on the current transform.
+		if (m_AnyInterpolating)
+		{
+			for (uint8_t& flags : m_Flags)
+			{
+				if (flags & TRANSFORM_INTERPOLATING)
+				{
+					flags = (flags & ~TRANSFORM_INTERPOLATING) | TRANSFORM_LOCAL_DIRTY;
+				}
+			}
+			m_AnyInterpolating = false;
+			m_AnyDirty = true;
+		}
+	}
+
+	void TransformSystem::EndFixedTick()
+	{
+		m_InFixedTick = false;
+	}
+
+	void TransformSystem::SetInterpolationAlpha(float alpha)
+	{
+		if (alpha != m_InterpolationAlpha)
+		{
+			m_InterpolationAlpha = alpha;
+			m_RenderDirty = m_AnyInterpolating;
+		}
+	}
+
+	void TransformSystem::GetWorldBTTransforms(const EntityHandle* handles, uint32_t count, btTransform* out)
+	{
+		Update();
+
+		for (uint32_t i = 0; i < count; i++)
+		{
+			const glm::mat4& world = m_WorldMatrices[DenseIndex(handles[i])];
+			const glm::mat3	 basis = NormalizedBasis(world);
+
+			const btScalar openGLMatrix[16] = {
+				basis[0].x, basis[0].y, basis[0].z, 0.0f,
+				basis[1].x, basis[1].y, basis[1].z, 0.0f,
+				basis[2].x, basis[2].y, basis[2].z, 0.0f,
+				world[3].x, world[3].y, world[3].z, 1.0f
+			};
+			out[i].setFromOpenGLMatrix(openGLMatrix);
+		}
+	}
+
+	void TransformSystem::SetWorldFromBTTransforms(const EntityHandle* handles, const btTransform* transforms, uint32_t count)
+	{
+		for (uint32_t i = 0; i < count; i++)
+		{
+			const uint32_t	   dense = DenseIndex(handles[i]);
+			const btVector3&   origin = transforms[i].getOrigin();
+			const btQuaternion btRotation = transforms[i].getRotation();
+
+			glm::vec3 position(origin.x(), origin.y(), origin.z());
+			glm::quat rotation(btRotation.w(), btRotation.x(), btRotation.y(), btRotation.z());
+
+			// Bodies are usually roots, in which case world space is local space. Otherwise go into the parent's space.
+			const uint32_t parent = m_Parents[dense];
+			if (parent != NONE)
+			{
+				Update();
+				const glm::mat4& parentWorld = m_WorldMatrices[parent];
+				position = glm::vec3(glm::inverse(parentWorld) * glm::vec4(position, 1.0f));
+				rotation = glm::inverse(glm::quat_cast(NormalizedBasis(parentWorld))) * rotation;
+			}
+
+			m_Locals.SetPosition(dense, position);
+			m_Locals.SetRotation(dense, rotation);
+			if (!m_InFixedTick)
+			{
+				m_Previous.SetPosition(dense, position);
+				m_Previous.SetRotation(dense, rotation);
+			}
+			MarkDirty(dense);
+		}
+	}
+
+	void TransformSystem::GetWorldMatrices(const EntityHandle* handles, uint32_t count, glm::mat4* out)
+	{
+		Update();
+
+		for (uint32_t i = 0; i < count; i++)
+		{
+			out[i] = m_WorldMatrices[DenseIndex(handles[i])];
+		}
+	}
+
+	void TransformSystem::Update()
+	{
+		if (!m_AnyDirty && !m_RenderDirty)
+		{
+			return;
+		}
+
+		// Parents always come before their children, so by the time we reach a transform its parent's flags and
+		// matrices are already up to date for this pass.
+		const uint32_t count = static_cast<uint32_t>(m_Handles.size());
+		for (uint32_t i = 0; i < count; i++)
+		{
+			const uint8_t  flags = m_Flags[i];
+			const bool	   localDirty = flags & TRANSFORM_LOCAL_DIRTY;
+			const bool	   interpolating = flags & TRANSFORM_INTERPOLATING;
+			const uint32_t parent = m_Parents[i];
+			const uint8_t  parentFlags = parent != NONE ? m_Flags[parent] : TRANSFORM_CLEAN;
+
+			uint8_t newFlags = flags & TRANSFORM_INTERPOLATING;
+
+			if (localDirty)
+			{
+				ComputeLocalMatrix(i);
+			}
+
+			if (localDirty || (parentFlags & TRANSFORM_WORLD_CHANGED))
+			{
+				m_WorldMatrices[i] = parent != NONE ? m_WorldMatrices[parent] * m_LocalMatrices[i] : m_LocalMatrices[i];
+				newFlags |= TRANSFORM_WORLD_CHANGED;
+			}
+
+			if (localDirty || (parentFlags & TRANSFORM_RENDER_CHANGED) || (interpolating && m_RenderDirty))
+			{
+				glm::mat4 renderLocal;
+				if (interpolating)
+				{
+					ComputeInterpolatedMatrix(i, renderLocal);
+				}
+				else
+				{
+					renderLocal = m_LocalMatrices[i];
+				}
+
+				m_RenderMatrices[i] = parent != NONE ? m_RenderMatrices[parent] * renderLocal : renderLocal;
+				newFlags |= TRANSFORM_RENDER_CHANGED;
+			}
+
+			m_Flags[i] = newFlags;
+		}
+
+		m_AnyDirty = false;
+		m_RenderDirty = false;
+	}
+
+	uint32_t TransformSystem::DenseIndex(EntityHandle handle) const
+	{
+		LEI_ASSERT(handle.index < m_SparseToDense.size() && m_SparseToDense[handle.index] != NONE, "Entity has no transform.");
+		return m_SparseToDense[handle.index];
+	}
+
+	void TransformSystem::MarkDirty(uint32_t dense)
+	{
+		m_Flags[dense] |= m_InFixedTick ? (TRANSFORM_LOCAL_DIRTY | TRANSFORM_INTERPOLATING) : TRANSFORM_LOCAL_DIRTY;
+		if (m_InFixedTick && !m_AnyInterpolating.load(std::memory_order_relaxed))
+		{
+			m_AnyInterpolating.store(true, std::memory_order_relaxed);
+		}
+		// Check first so parallel systems don't all fight over the cache line once it's set.
+		if (!m_AnyDirty.load(std::memory_order_relaxed))
+		{
+			m_AnyDirty.store(true, std::memory_order_relaxed);
+		}
+	}
+
+	/*
+	 * Reorders the dense arrays breadth first (roots, then their children, then grandchildren, ...).
+	 * Also drops removed transforms.
+	 */
+	void TransformSystem::RebuildOrder()
+	{
+		const uint32_t count = static_cast<uint32_t>(m_Handles.size());
+
+		// Children of each transform, as ranges into one flat array (counting sort by parent).
+		std::vector<uint32_t>& childStart = m_ScratchChildStart;
+		childStart.assign(count + 1, 0);
+		for (uint32_t i = 0; i < count; i++)
+		{
+			if (m_Handles[i].IsValid() && m_Parents[i] != NONE)
+			{
+				childStart[m_Parents[i] + 1]++;
+			}
+		}
+		for (uint32_t i = 0; i < count; i++)
+		{
+			childStart[i + 1] += childStart[i];
+		}
+		std::vector<uint32_t>& children = m_ScratchChildren;
+		std::vector<uint32_t>& fill = m_ScratchFill;
+		children.resize(childStart[count]);
+		fill.assign(childStart.begin(), childStart.end() - 1);
+		for (uint32_t i = 0; i < count; i++)
+		{
+			if (m_Handles[i].IsValid() && m_Parents[i] != NONE)
+			{
+				children[fill[m_Parents[i]]++] = i;
+			}
+		}
+
+		std::vector<uint32_t>& order = m_ScratchOrder;
+		order.clear();
+		for (uint32_t i = 0; i < count; i++)
+		{
+			if (m_Handles[i].IsValid() && m_Parents[i] == NONE)
+			{
+				order.push_back(i);
+			}
+		}
+		for (size_t head = 0; head < order.size(); head++)
+		{
+			const uint32_t node = order[head];
+			order.insert(order.end(), children.begin() + childStart[node], children.begin() + childStart[node + 1]);
+		}
+
+		std::vector<uint32_t>& newIndex = m_ScratchNewIndex;
+		newIndex.assign(count, NONE);
+		for (uint32_t i = 0; i < order.size(); i++)
+		{
+			newIndex[order[i]] = i;
+		}
+
+		// Each array is permuted into its scratch and swapped with it, the old array becomes the scratch for next time.
+		const uint32_t newCount = static_cast<uint32_t>(order.size());
+		m_ScratchHandles.resize(newCount);
+		m_ScratchParents.resize(newCount);
+		m_ScratchFlags.resize(newCount);
+		for (uint32_t i = 0; i < newCount; i++)
+		{
+			const uint32_t old = order[i];
+			m_ScratchHandles[i] = m_Handles[old];
+			m_ScratchParents[i] = m_Parents[old] != NONE ? newIndex[m_Parents[old]] : NONE;
+			m_ScratchFlags[i] = m_Flags[old];
+			m_SparseToDense[m_ScratchHandles[i].index] = i;
+		}
+		m_Handles.swap(m_ScratchHandles);
+		m_Parents.swap(m_ScratchParents);
+		m_Flags.swap(m_ScratchFlags);
+
+		for (AlignedVector<glm::mat4>* matrices : { &m_LocalMatrices, &m_WorldMatrices, &m_RenderMatrices })
+		{
+			m_ScratchMatrices.resize(newCount);
+			for (uint32_t i = 0; i < newCount; i++)
+			{
+				m_ScratchMatrices[i] = (*matrices)[order[i]];
+			}
+			matrices->swap(m_ScratchMatrices);
+		}
+
+		m_Locals.Permute(order, m_ScratchFloats);
+		m_Previous.Permute(order, m_ScratchFloats);
+	}
+
+	/*
+	 * Moves the children of removed transforms to their closest remaining ancestor (or makes them roots). Their local
+	 * transform is recomputed from their world matrix so they stay where they are.
+	 */
+	void TransformSystem::ReparentOrphans()
+	{
+		// Removed rows still have their parent links, so the world matrices are those from before the removal.
+		Update();
+
+		const uint32_t count = static_cast<uint32_t>(m_Handles.size());
+		for (uint32_t i = 0; i < count; i++)
+		{
+			const uint32_t parent = m_Parents[i];
+			if (!m_Handles[i].IsValid() || parent == NONE || m_Handles[parent].IsValid())
+			{
+				continue;
+			}
+
+			uint32_t ancestor = parent;
+			while (ancestor != NONE && !m_Handles[ancestor].IsValid())
+			{
+				ancestor = m_Parents[ancestor];
+			}
+
+			const glm::mat4 local = ancestor != NONE ? glm::inverse(m_WorldMatrices[ancestor]) * m_WorldMatrices[i] : m_WorldMatrices[i];
+			const Transform transform = DecomposeMatrix(local);
+			m_Parents[i] = ancestor;
+			m_Locals.Set(i, transform);
+			m_Previous.Set(i, transform); // Not a move, so nothing to interpolate.
+			MarkDirty(i);
+		}
+	}
+
+	void TransformSystem::ComputeLocalMatrix(uint32_t i)
+	{
+		const glm::vec3 position(m_Locals.positionX[i], m_Locals.positionY[i], m_Locals.positionZ[i]);
+		const glm::quat rotation(m_Locals.rotationW[i], m_Locals.rotationX[i], m_Locals.rotationY[i], m_Locals.rotationZ[i]);
+		const glm::vec3 scale(m_Locals.scaleX[i], m_Locals.scaleY[i], m_Locals.scaleZ[i]);
+		ComposeMatrix(position, rotation, scale, m_LocalMatrices[i]);
+	}
+
+	void TransformSystem::ComputeInterpolatedMatrix(uint32_t i, glm::mat4& out) const
+	{
+		const Transform previous = m_Previous.Get(i);
+		const Transform current = m_Locals.Get(i);
+		const float		alpha = m_InterpolationAlpha;
+
+		ComposeMatrix(glm::mix(previous.position, current.position, alpha),
+			glm::slerp(previous.rotation, current.rotation, alpha),
+			glm::mix(previous.scale, current.scale, alpha),
+			out);
+	}
+
+	// Same as translate * mat4_cast(rotation) * scale, without building and multiplying three matrices.
+	void TransformSystem::ComposeMatrix(const glm::vec3& position, const glm::quat& rotation, const glm::vec3& scale, glm::mat4& out)
+	{
+		const float x = rotation.x;
+		const float y = rotation.y;
+		const float z = rotation.z;
+		const float w = rotation.w;
+
+		out[0] = glm::vec4((1.0f - 2.0f * (y * y + z * z)) * scale.x, 2.0f * (x * y + w * z) * scale.x, 2.0f * (x * z - w * y) * scale.x, 0.0f);
+		out[1] = glm::vec4(2.0f * (x * y - w * z) * scale.y, (1.0f - 2.0f * (x * x + z * z)) * scale.y, 2.0f * (y * z + w * x) * scale.y, 0.0f);
+		out[2] = glm::vec4(2.0f * (x * z + w * y) * scale.z, 2.0f * (y * z - w * x) * scale.z, (1.0f - 2.0f * (x * x + y * y)) * scale.z, 0.0f);
+		out[3] = glm::vec4(position, 1.0f);
+	}
+
+	Transform TransformSystem::DecomposeMatrix(const glm::mat4& matrix)
+	{
+		Transform transform;
+		transform.position = glm::vec3(matrix[3]);
+		transform.rotation = glm::normalize(glm::quat_cast(NormalizedBasis(matrix)));
+		transform.scale = glm::vec3(glm::length(glm::vec3(matrix[0])), glm::length(glm::vec3(matrix[1])), glm::length(glm::vec3(matrix[2])));
+		return transform;
+	}
+} // namespace lei3d
@@ -0,0 +1,162 @@
+#pragma once
+
+#include "core/EntityHandle.hpp"
+#include "util/AlignedAllocator.hpp"
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+class btTransform;
+
+namespace lei3d
+{
+	// Local transform of an entity, relative to its parent (or the world if it has none).
+	struct Transform
+	{
+		glm::vec3 position = glm::vec3(0.0f);
+		glm::quat rotation = glm::identity<glm::quat>();
+		glm::vec3 scale = glm::vec3(1.0f);
+
+		// Rotation around the up axis in degrees. Setting it replaces the whole rotation.
+		float GetYawRotation() const;
+		void  SetYawRotation(float yawRotation);
+	};
+
+	/*
+	 * Owns the transforms of every entity in a scene, along with their parent/child hierarchy.
+	 *
+	 * Local and world matrices are cached and only recomputed for transforms that were marked dirty (and their
+	 * descendants). Transforms are stored in dense arrays in breadth first order, so every parent comes before its
+	 * children and Update refreshes the whole hierarchy in one linear pass.
+	 * The order is rebuilt whenever the hierarchy changes, which should be rare compared to transforms moving. Removing
+	 * only marks the transform, ApplyRemovals drops everything removed since the last call in a single rebuild.
+	 *
+	 * Positions, rotations and scales are packed one component per array (SoA), 16 byte aligned, so the bulk loops
+	 * (matrix rebuilds, Bullet and GPU conversions) stream through memory and can be vectorized by the compiler.
+	 *
+	 * Interpolation: the simulation runs at a fixed tick rate, decoupled from rendering. Transforms changed during a
+	 * fixed tick (between BeginFixedTick and EndFixedTick) are rendered interpolated between their values from the last
+	 * two ticks, using the alpha from SetInterpolationAlpha. Changes outside of ticks (editor, per frame logic) are
+	 * treated as teleports and show up right away.
+	 */
+	class TransformSystem
+	{
+	private:
+		static constexpr uint32_t NONE = UINT32_MAX;
+
+		enum TransformFlags : uint8_t
+		{
+			TRANSFORM_CLEAN = 0,
+			TRANSFORM_LOCAL_DIRTY = 1 << 0,	  // Local transform changed since the last Update.
+			TRANSFORM_WORLD_CHANGED = 1 << 1, // World matrix was recomputed during the last Update, so children must be too.
+			TRANSFORM_INTERPOLATING = 1 << 2, // Moved during the last fixed tick, so it renders between m_Previous and m_Locals.
+			TRANSFORM_RENDER_CHANGED = 1 << 3, // Same as TRANSFORM_WORLD_CHANGED for the render matrix.
+		};
+
+		struct LocalTransforms
+		{
+			AlignedVector<float> positionX, positionY, positionZ;
+			AlignedVector<float> rotationX, rotationY, rotationZ, rotationW;
+			AlignedVector<float> scaleX, scaleY, scaleZ;
+
+			uint32_t  Size() const { return static_cast<uint32_t>(positionX.size()); }
+			void	  PushBack(const Transform& transform);
+			Transform Get(uint32_t i) const;
+			void	  Set(uint32_t i, const Transform& transform);
+			void	  SetPosition(uint32_t i, const glm::vec3& position);
+			void	  SetRotation(uint32_t i, const glm::quat& rotation);
+			void	  Permute(const std::vector<uint32_t>& order, AlignedVector<float>& scratch); // New element i is old element order[i].
+			void	  Clear();
+		};
+
+		std::vector<uint32_t> m_SparseToDense; // Indexed by EntityHandle::index.
+
+		// Dense arrays, all indexed the same way.
+		std::vector<EntityHandle> m_Handles;
+		std::vector<uint32_t>	  m_Parents; // Dense index of the parent, or NONE.
+		LocalTransforms			  m_Locals;
+		LocalTransforms			  m_Previous; // Local transforms as of the start of the last fixed tick.
+		AlignedVector<glm::mat4>  m_LocalMatrices;
+		AlignedVector<glm::mat4>  m_WorldMatrices;
+		AlignedVector<glm::mat4>  m_RenderMatrices; // Interpolated world matrices.
+		std::vector<uint8_t>	  m_Flags;
+
+		// Atomic because parallel systems move their own entities.
+		std::atomic<bool> m_AnyDirty = false;
+		std::atomic<bool> m_AnyInterpolating = false;
+
+		bool  m_InFixedTick = false;
+		bool  m_RenderDirty = false; // Alpha changed since the render matrices were computed.
+		bool  m_AnyRemoved = false;	 // Removed transforms are still in the dense arrays.
+		float m_InterpolationAlpha = 1.0f;
+
+		// RebuildOrder's working memory, kept so rebuilding doesn't allocate once it has grown to the scene's size.
+		std::vector<uint32_t>	  m_ScratchChildStart;
+		std::vector<uint32_t>	  m_ScratchChildren;
+		std::vector<uint32_t>	  m_ScratchFill;
+		std::vector<uint32_t>	  m_ScratchOrder;
+		std::vector<uint32_t>	  m_ScratchNewIndex;
+		std::vector<EntityHandle> m_ScratchHandles;
+		std::vector<uint32_t>	  m_ScratchParents;
+		AlignedVector<glm::mat4>  m_ScratchMatrices;
+		AlignedVector<float>	  m_ScratchFloats;
+		std::vector<uint8_t>	  m_ScratchFlags;
+
+	public:
+		// Only the local setters (SetLocal, SetPosition, ...) may be called from several threads at once,
+		// and only for different entities. Everything else is main thread only.
+		void Add(EntityHandle handle);
+		void Remove(EntityHandle handle);
+		void ApplyRemovals(); // Children of removed transforms move up to the closest remaining ancestor, keeping their world transform.
+		void Clear();
+
+		Transform GetLocal(EntityHandle handle) const;
+		void	  SetLocal(EntityHandle handle, const Transform& transform);
+		void	  SetPosition(EntityHandle handle, const glm::vec3& position);
+		void	  SetRotation(EntityHandle handle, const glm::quat& rotation);
+		void	  SetScale(EntityHandle handle, const glm::vec3& scale);
+
+		// Pass an invalid handle as the parent to make child a root again. Returns false if it would create a cycle.
+		bool		 SetParent(EntityHandle child, EntityHandle parent);
+		EntityHandle GetParent(EntityHandle handle) const;
+
+		// These bring the cached matrices up to date first if anything is dirty.
+		const glm::mat4& GetLocalMatrix(EntityHandle handle);
+		const glm::mat4& GetWorldMatrix(EntityHandle handle);
+		const glm::mat4& GetRenderMatrix(EntityHandle handle); // World matrix interpolated between the last two ticks.
+
+		void BeginFixedTick();
+		void EndFixedTick();
+		void SetInterpolationAlpha(float alpha); // 0 = previous tick, 1 = latest tick.
+
+		/*
+		 * Bulk conversions, for syncing many rigid bodies or filling instance buffers at once.
+		 * Bullet transforms are in world space and carry rotation and translation only. Scale belongs on the collision shape.
+		 * World matrices come out column major, ready to upload to the GPU.
+		 */
+		void GetWorldBTTransforms(const EntityHandle* handles, uint32_t count, btTransform* out);
+		void SetWorldFromBTTransforms(const EntityHandle* handles, const btTransform* transforms, uint32_t count);
+		void GetWorldMatrices(const EntityHandle* handles, uint32_t count, glm::mat4* out);
+
+		/*
+		 * Recomputes the matrices of every dirty transform and its descendants.
+		 * The scene calls this once per frame, so it's usually a no-op when something asks for a matrix.
+		 */
+		void Update();
+
+	private:
+		uint32_t DenseIndex(EntityHandle handle) const;
+		void	 MarkDirty(uint32_t dense);
+		void	 RebuildOrder();
+		void	 ReparentOrphans();
+		void	 ComputeLocalMatrix(uint32_t dense);
+		void	 ComputeInterpolatedMatrix(uint32_t dense, glm::mat4& out) const;
+
+		static void		 ComposeMatrix(const glm::vec3& position, const glm::quat& rotation, const glm::vec3& scale, glm::mat4& out);
+		static Transform DecomposeMatrix(const glm::mat4& matrix); // Drops any shear.
+	};
+} // namespace lei3d
@@ -1,8 +1,13 @@
 #include "EditorGUI.hpp"
 
+#include "core/AllocationTracker.hpp"
 #include "core/Application.hpp"
+#include "core/AssetManager.hpp"
 #include "core/SceneManager.hpp"
+#include "rendering/TextureResidency.hpp"
+#include "rendering/TextureStreamer.hpp"
 
+#include <algorithm>
 #include <string>
 
 namespace lei3d
@@ -76,7 +81,146 @@ namespace lei3d
 
 		if (ImGui::CollapsingHeader("Game Info"))
 		{
-			ImGui::Text("fps = %f", 1.0f / Application::DeltaTime());
+			FramePacer&			 pacer = Application::GetFramePacer();
+			const FrameTimeStats stats = pacer.GetStats();
+			ImGui::Text("fps = %.1f", stats.averageMs > 0.0f ? 1000.0f / stats.averageMs : 0.0f);
+			ImGui::Text("frame time p50 = %.2f ms, p99 = %.2f ms, max = %.2f ms", stats.p50Ms, stats.p99Ms, stats.maxMs);
+
+			const FrameAllocator& frameAllocator = Application::GetFrameAllocator();
+			ImGui::Text("frame arena = %.1f / %.1f KB", frameAllocator.BytesUsed() / 1024.0f, frameAllocator.Capacity() / 1024.0f);
+			if (AllocationTracker::IsEnabled())
+			{
+				ImGui::Text("heap allocations last frame = %llu", static_cast<unsigned long long>(Application::LastFrameAllocations()));
+			}
+			else
+			{
+				ImGui::TextDisabled("heap allocations: build with LEI_TRACK_ALLOCATIONS");
+			}
+
+			float targetFPS = pacer.GetTargetFPS();
+			if (ImGui::InputFloat("FPS cap (0 = off)", &targetFPS, 10.0f, 30.0f, "%.0f"))
+			{
+				pacer.SetTargetFPS(targetFPS);
+			}
+
+			bool lateInputSampling = pacer.LateInputSampling();
+			if (ImGui::Checkbox("Late input sampling", &lateInputSampling))
+			{
+				pacer.SetLateInputSampling(lateInputSampling);
+			}
+
+			ImGui::Text("physics tick = %.0f Hz", 1.0f / Application::FixedDeltaTime());
+
+			int maxCatchUpTicks = Application::GetMaxCatchUpTicks();
+			if (ImGui::InputInt("Max catch-up ticks", &maxCatchUpTicks))
+			{
+				Application::SetMaxCatchUpTicks(maxCatchUpTicks);
+			}
+		}
+
+		if (ImGui::CollapsingHeader("Pools"))
+		{
+			Scene& scene = SceneManager::ActiveScene();
+
+			auto poolRow = [](const char* name, const ObjectPoolStats& stats) {
+				const float occupancy = stats.capacity > 0 ? static_cast<float>(stats.live) / stats.capacity : 0.0f;
+				ImGui::Text("%-24s %5u / %5u (%u chunks)", name, stats.live, stats.capacity, stats.chunks);
+				ImGui::SameLine();
+				ImGui::ProgressBar(occupancy, ImVec2(80.0f, 0.0f));
+			};
+
+			poolRow("Entity", scene.GetEntityPoolStats());
+			for (const auto& pool : scene.GetComponentStorage().GetPools())
+			{
+				poolRow(pool->GetTypeName().c_str(), pool->GetStats());
+			}
+		}
+
+		if (ImGui::CollapsingHeader("Assets"))
+		{
+			const auto stats = AssetManager::GetStats();
+			size_t	   totalBytes = 0;
+			for (int type = 0; type < ASSET_TYPE_COUNT; type++)
+			{
+				const AssetTypeStats& typeStats = stats[type];
+				ImGui::Text("%-8s %3u (%u unused)  CPU %7.1f MB  GPU %7.1f MB", AssetManager::GetTypeName(static_cast<AssetType>(type)),
+					typeStats.count, typeStats.unused, typeStats.cpuBytes / (1024.0f * 1024.0f), typeStats.gpuBytes / (1024.0f * 1024.0f));
+				totalBytes += typeStats.cpuBytes + typeStats.gpuBytes;
+			}
+
+			// Requests that got an already loaded asset instead of loading (and for textures, uploading) another copy.
+			const AssetTypeStats& textureStats = stats[ASSET_TEXTURE];
+			ImGui::Text("textures: %u duplicate loads avoided, %.1f MB VRAM saved", textureStats.reused, textureStats.savedBytes / (1024.0f * 1024.0f));
+			for (int type = 0; type < ASSET_TYPE_COUNT; type++)
+			{
+				const AssetTypeStats& typeStats = stats[type];
+				if (type != ASSET_TEXTURE && typeStats.reused > 0)
+				{
+					ImGui::Text("%-8s %u reused, %.1f MB saved", AssetManager::GetTypeName(static_cast<AssetType>(type)), typeStats.reused,
+						typeStats.savedBytes / (1024.0f * 1024.0f));
+				}
+			}
+
+			const TextureStreamer::Stats streaming = TextureStreamer::GetStats();
+			ImGui::Text("streaming: %u textures, %.1f MB left, %.1f MB last frame, ring %.1f / %.1f MB%s", streaming.pendingRequests,
+				streaming.pendingBytes / (1024.0f * 1024.0f), streaming.lastFrameBytes / (1024.0f * 1024.0f), streaming.ringBytes / (1024.0f * 1024.0f),
+				streaming.ringCapacity / (1024.0f * 1024.0f), streaming.persistent ? " (persistent)" : "");
+			int streamKB = static_cast<int>(TextureStreamer::GetFrameBudget() / 1024);
+			if (ImGui::InputInt("Streaming per frame (KB)", &streamKB, 256, 1024))
+			{
+				TextureStreamer::SetFrameBudget(static_cast<size_t>(std::max(streamKB, 1)) * 1024);
+			}
+
+			const TextureResidency::Stats residency = TextureResidency::GetStats();
+			ImGui::Text("mip residency: %u textures (%u streaming), %.1f / %.1f MB resident, %.1f MB wanted, %u levels dropped for budget",
+				residency.textures, residency.streaming, residency.residentBytes / (1024.0f * 1024.0f), residency.fullChainBytes / (1024.0f * 1024.0f),
+				residency.wantedBytes / (1024.0f * 1024.0f), residency.bias);
+			int textureBudgetMB = static_cast<int>(TextureResidency::GetBudget() / (1024 * 1024));
+			if (ImGui::InputInt("Texture VRAM budget (MB)", &textureBudgetMB, 32, 128))
+			{
+				TextureResidency::SetBudget(static_cast<size_t>(std::max(textureBudgetMB, 0)) * 1024 * 1024);
+			}
+			float lodBias = TextureResidency::GetLodBias();
+			if (ImGui::SliderFloat("Texture LOD bias", &lodBias, -2.0f, 2.0f))
+			{
+				TextureResidency::SetLodBias(lodBias);
+			}
+
+			// Enforced on the next scene switch.
+			int budgetMB = static_cast<int>(AssetManager::GetMemoryBudget() / (1024 * 1024));
+			ImGui::Text("total = %.1f MB", totalBytes / (1024.0f * 1024.0f));
+			if (ImGui::InputInt("Budget (MB)", &budgetMB, 64, 256))
+			{
+				AssetManager::SetMemoryBudget(static_cast<size_t>(std::max(budgetMB, 0)) * 1024 * 1024);
+			}
+		}
+
+		if (ImGui::CollapsingHeader("Benchmarks"))
+		{
+			// Blocks the editor while it runs.
+			if (ImGui::Button("Job System (50k entities)"))
+			{
+				m_JobBenchmarkResults = RunJobSystemBenchmark();
+			}
+			for (const JobSystemBenchmarkResult& result : m_JobBenchmarkResults)
+			{
+				ImGui::Text("%2u threads: %.3f ms/frame (%.2fx)", result.threadCount, result.msPerFrame, result.speedup);
+			}
+
+			if (ImGui::Button("Model loading (data/models)"))
+			{
+				m_ModelLoadBenchmarkResults = RunModelLoadBenchmark();
+			}
+			for (const ModelLoadBenchmarkResult& result : m_ModelLoadBenchmarkResults)
+			{
+				ImGui::Text("%s", result.path.c_str());
+				ImGui::Text("  serial %.1f ms, parallel %.1f ms (%.2fx), upload %.1f ms", result.serialMs, result.parallelMs, result.speedup, result.uploadMs);
+				if (result.cookedMs >= 0.0)
+				{
+					ImGui::SameLine();
+					ImGui::Text(", cooked %.1f ms", result.cookedMs);
+				}
+			}
 		}
 
 		if (ImGui::CollapsingHeader("Shortcuts/Keybinds"))
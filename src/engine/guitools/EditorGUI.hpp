@@ -1,6 +1,10 @@
 #pragma once
 
+#include "benchmarks/JobSystemBenchmark.hpp"
+#include "benchmarks/ModelLoadBenchmark.hpp"
+
 #include <imgui.h>
+#include <vector>
 
 namespace lei3d
 {
@@ -9,6 +13,9 @@ namespace lei3d
 	private:
 		bool m_ShowDemoWindow = false;
 
+		std::vector<JobSystemBenchmarkResult> m_JobBenchmarkResults;
+		std::vector<ModelLoadBenchmarkResult> m_ModelLoadBenchmarkResults;
+
 	public:
 		void RenderUI(); // DON"T MAKE THIS CONST
 	};
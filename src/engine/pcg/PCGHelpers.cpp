@@ -42,7 +42,8 @@ namespace lei3d
 
 	std::vector<unsigned char> getElevationData()
 	{
-		stbi_set_flip_vertically_on_load(true);
+		// Per thread, textures may be decoding on other threads at the same time.
+		stbi_set_flip_vertically_on_load_thread(true);
 
 		int			   width, height, nrChannels;
 		unsigned char* data = stbi_load("./data/textures/elevation.png", &width, &height, &nrChannels, 0);
@@ -48,29 +48,30 @@ namespace lei3d
 
 		// Calculate
 		glm::vec3 wishdir{ 0.0f, 0.0f, 0.0f };
-		float	  yawRotationRadian = glm::radians(m_Controller.m_Entity.m_Transform.yawRotation);
+		float	  yawRotationRadian = glm::radians(m_Controller.m_Entity.GetYawRotation());
 
 		// here is where we apply our constraints during the update
-		GLFWwindow* window = Application::Window();
-		if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS)
+		// Read from the frame's input snapshot, so every substep of a frame sees the same keys.
+		const InputSnapshot& input = Application::GetInput().Snapshot();
+		if (input.IsKeyDown(GLFW_KEY_W))
 		{
 			//Same as Camera
 			glm::vec3 forwardVec = glm::normalize(glm::vec3(cos(yawRotationRadian), 0, sin(yawRotationRadian)));
 			wishdir = wishdir + forwardVec;
 		}
-		if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS)
+		if (input.IsKeyDown(GLFW_KEY_S))
 		{
 			//Same as Camera
 			glm::vec3 forwardVec = glm::normalize(glm::vec3(cos(yawRotationRadian), 0, sin(yawRotationRadian)));
 			wishdir = wishdir - forwardVec;
 		}
-		if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS)
+		if (input.IsKeyDown(GLFW_KEY_A))
 		{
 			//Same as Camera
 			glm::vec3 rightVec = glm::normalize(glm::vec3(-sin(yawRotationRadian), 0, cos(yawRotationRadian)));
 			wishdir = wishdir - rightVec;
 		}
-		if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS)
+		if (input.IsKeyDown(GLFW_KEY_D))
 		{
 			//Same as Camera
 			glm::vec3 rightVec = glm::normalize(glm::vec3(-sin(yawRotationRadian), 0, cos(yawRotationRadian)));
@@ -84,16 +85,16 @@ namespace lei3d
 
 		if (onGround)
 		{
-			glm::vec3 outputVel = GroundAcceleration(wishdir, prevVel);
+			glm::vec3 outputVel = GroundAcceleration(wishdir, prevVel, deltaTime);
 			v = btVector3(outputVel.x, outputVel.y, outputVel.z);
 		}
 		else
 		{
-			glm::vec3 outputVel = AirAcceleration(wishdir, prevVel);
+			glm::vec3 outputVel = AirAcceleration(wishdir, prevVel, deltaTime);
 			v = btVector3(outputVel.x, outputVel.y, outputVel.z);
 		}
 
-		if (glfwGetKey(window, GLFW_KEY_SPACE) == GLFW_PRESS && onGround)
+		if (input.IsKeyDown(GLFW_KEY_SPACE) && onGround)
 		{
 			v = v + btVector3(0, m_Controller.m_jumpPower, 0);
 		}
@@ -111,10 +112,10 @@ namespace lei3d
 		debugDrawer->drawSphere(center, radius, groundCheckColor);
 	}
 
-	glm::vec3 CharacterController::CharacterPhysicsUpdate::Accelerate(glm::vec3 wishDir, glm::vec3 prevVel, float acceleration, float maxVelocity)
+	glm::vec3 CharacterController::CharacterPhysicsUpdate::Accelerate(glm::vec3 wishDir, glm::vec3 prevVel, float acceleration, float maxVelocity, float deltaTime)
 	{
 		const float projectedSpeed = glm::dot(prevVel, wishDir);
-		float wishSpeed = acceleration * Application::DeltaTime(); // this is the wish speed (MIGHT NEED DELTA TIME TO FIX THIS????
+		float wishSpeed = acceleration * deltaTime; // this is the wish speed
 
 		// If necessary, truncate the new speed so it doesn't exceed max velocity
 		if (projectedSpeed + wishSpeed > maxVelocity)
@@ -125,21 +126,21 @@ namespace lei3d
 		return prevVel + wishDir * wishSpeed;
 	}
 
-	glm::vec3 CharacterController::CharacterPhysicsUpdate::AirAcceleration(glm::vec3 wishDir, glm::vec3 prevVelocity)
+	glm::vec3 CharacterController::CharacterPhysicsUpdate::AirAcceleration(glm::vec3 wishDir, glm::vec3 prevVelocity, float deltaTime)
 	{
-		return Accelerate(wishDir, prevVelocity, m_Controller.m_airAccel, m_Controller.m_maxAirSpeed);
+		return Accelerate(wishDir, prevVelocity, m_Controller.m_airAccel, m_Controller.m_maxAirSpeed, deltaTime);
 	}
 
-	glm::vec3 CharacterController::CharacterPhysicsUpdate::GroundAcceleration(glm::vec3 wishDir, glm::vec3 prevVelocity)
+	glm::vec3 CharacterController::CharacterPhysicsUpdate::GroundAcceleration(glm::vec3 wishDir, glm::vec3 prevVelocity, float deltaTime)
 	{
 		constexpr float EPSILON = 0.1f;
 		const float		speed = glm::length(prevVelocity);
 		if (speed != 0 && glm::length(wishDir) < EPSILON)	//Only factor in friction on deceleration.
 		{
-			const float drop = speed * m_Controller.m_friction * Application::DeltaTime(); // THIS MIGHT HAVE TO BE MULTIPLIED BY DELTA TIME??
+			const float drop = speed * m_Controller.m_friction * deltaTime;
 			prevVelocity *= std::max(speed - drop, 0.0f) / speed;					 // Friction fall off
 		}
 
-		return Accelerate(wishDir, prevVelocity, m_Controller.m_accel, m_Controller.m_maxSpeed);
+		return Accelerate(wishDir, prevVelocity, m_Controller.m_accel, m_Controller.m_maxSpeed, deltaTime);
 	}
 } // namespace lei3d
\ No newline at end of file
@@ -35,7 +35,8 @@ namespace lei3d
 
 	void PhysicsWorld::Step(float deltaTime)
 	{
-		m_dynamicsWorld->stepSimulation(deltaTime, 10);
+		// Exactly one internal step of deltaTime. The fixed tick loop in Application does the accumulating.
+		m_dynamicsWorld->stepSimulation(deltaTime, 1, deltaTime);
 
 		// Move every object
 		for (int j = m_dynamicsWorld->getNumCollisionObjects() - 1; j >= 0; j--)
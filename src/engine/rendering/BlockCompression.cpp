@@ -0,0 +1,271 @@
+#include "BlockCompression.hpp"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+
+namespace lei3d
+{
+	namespace
+	{
+		// Plain floats rather than glm, so the encoder has no dependencies for the cooker to drag along.
+		struct Color
+		{
+			float r = 0.0f, g = 0.0f, b = 0.0f;
+		};
+
+		float distanceSquared(const Color& a, const Color& b)
+		{
+			return (a.r - b.r) * (a.r - b.r) + (a.g - b.g) * (a.g - b.g) + (a.b - b.b) * (a.b - b.b);
+		}
+
+		Color lerp(const Color& a, const Color& b, float t)
+		{
+			return { a.r + (b.r - a.r) * t, a.g + (b.g - a.g) * t, a.b + (b.b - a.b) * t };
+		}
+
+		uint16_t packRGB565(const Color& color)
+		{
+			const uint16_t r = static_cast<uint16_t>(std::clamp(color.r, 0.0f, 255.0f) * 31.0f / 255.0f + 0.5f);
+			const uint16_t g = static_cast<uint16_t>(std::clamp(color.g, 0.0f, 255.0f) * 63.0f / 255.0f + 0.5f);
+			const uint16_t b = static_cast<uint16_t>(std::clamp(color.b, 0.0f, 255.0f) * 31.0f / 255.0f + 0.5f);
+			return static_cast<uint16_t>((r << 11) | (g << 5) | b);
+		}
+
+		// What the GPU turns a 565 colour back into (the top bits repeated into the bottom ones).
+		Color unpackRGB565(uint16_t packed)
+		{
+			const uint32_t r = (packed >> 11) & 31;
+			const uint32_t g = (packed >> 5) & 63;
+			const uint32_t b = packed & 31;
+			return { static_cast<float>((r << 3) | (r >> 2)), static_cast<float>((g << 2) | (g >> 4)), static_cast<float>((b << 3) | (b >> 2)) };
+		}
+
+		void writeLE(uint8_t* out, uint64_t value, int bytes)
+		{
+			for (int i = 0; i < bytes; i++)
+			{
+				out[i] = static_cast<uint8_t>(value >> (8 * i));
+			}
+		}
+
+		// 8 bytes: two 565 endpoints and 2 bit indices. Always uses the 4 colour mode (colour0 > colour1), as BC3 needs.
+		void encodeColorBlock(const uint8_t* rgba, uint8_t* out)
+		{
+			Color colors[16];
+			Color mean;
+			for (int i = 0; i < 16; i++)
+			{
+				colors[i] = { static_cast<float>(rgba[i * 4]), static_cast<float>(rgba[i * 4 + 1]), static_cast<float>(rgba[i * 4 + 2]) };
+				mean.r += colors[i].r / 16.0f;
+				mean.g += colors[i].g / 16.0f;
+				mean.b += colors[i].b / 16.0f;
+			}
+
+			// The endpoints go on the line through the colours that fits them best: the covariance's main eigenvector,
+			// found by power iteration.
+			float covariance[3][3] = {};
+			for (const Color& color : colors)
+			{
+				const float d[3] = { color.r - mean.r, color.g - mean.g, color.b - mean.b };
+				for (int row = 0; row < 3; row++)
+				{
+					for (int column = 0; column < 3; column++)
+					{
+						covariance[row][column] += d[row] * d[column];
+					}
+				}
+			}
+
+			// Starting from the channel that varies most. A fixed start like (1, 1, 1) can be orthogonal to all the variance
+			// (a red to green gradient), which would leave every pixel at the mean colour.
+			int widest = 0;
+			for (int channel = 1; channel < 3; channel++)
+			{
+				if (covariance[channel][channel] > covariance[widest][widest])
+				{
+					widest = channel;
+				}
+			}
+			float axis[3] = { 0.0f, 0.0f, 0.0f };
+			axis[widest] = 1.0f;
+			for (int iteration = 0; iteration < 8; iteration++)
+			{
+				float next[3];
+				for (int row = 0; row < 3; row++)
+				{
+					next[row] = covariance[row][0] * axis[0] + covariance[row][1] * axis[1] + covariance[row][2] * axis[2];
+				}
+
+				const float length = std::sqrt(next[0] * next[0] + next[1] * next[1] + next[2] * next[2]);
+				if (length < 1e-6f)
+				{
+					break; // Every pixel is the same colour.
+				}
+				for (int row = 0; row < 3; row++)
+				{
+					axis[row] = next[row] / length;
+				}
+			}
+
+			float minProjection = 0.0f;
+			float maxProjection = 0.0f;
+			for (const Color& color : colors)
+			{
+				const float projection = (color.r - mean.r) * axis[0] + (color.g - mean.g) * axis[1] + (color.b - mean.b) * axis[2];
+				minProjection = std::min(minProjection, projection);
+				maxProjection = std::max(maxProjection, projection);
+			}
+
+			auto	 alongAxis = [&](float t) { return Color{ mean.r + axis[0] * t, mean.g + axis[1] * t, mean.b + axis[2] * t }; };
+			uint16_t color0 = packRGB565(alongAxis(maxProjection));
+			uint16_t color1 = packRGB565(alongAxis(minProjection));
+			if (color0 < color1)
+			{
+				std::swap(color0, color1);
+			}
+
+			const Color endpoint0 = unpackRGB565(color0);
+			const Color endpoint1 = unpackRGB565(color1);
+			const Color palette[4] = { endpoint0, endpoint1, lerp(endpoint0, endpoint1, 1.0f / 3.0f), lerp(endpoint0, endpoint1, 2.0f / 3.0f) };
+
+			uint32_t indices = 0;
+			for (int i = 0; i < 16; i++)
+			{
+				uint32_t best = 0;
+				float	 bestDistance = FLT_MAX;
+				for (uint32_t p = 0; p < 4; p++)
+				{
+					const float distance = distanceSquared(colors[i], palette[p]);
+					if (distance < bestDistance)
+					{
+						best = p;
+						bestDistance = distance;
+					}
+				}
+				indices |= best << (2 * i);
+			}
+
+			writeLE(out, color0, 2);
+			writeLE(out + 2, color1, 2);
+			writeLE(out + 4, indices, 4);
+		}
+
+		// 8 bytes: two 8 bit endpoints and 3 bit indices, in the 8 value mode (value0 > value1).
+		void encodeValueBlock(const uint8_t* values, int stride, uint8_t* out)
+		{
+			uint8_t minValue = 255;
+			uint8_t maxValue = 0;
+			for (int i = 0; i < 16; i++)
+			{
+				minValue = std::min(minValue, values[i * stride]);
+				maxValue = std::max(maxValue, values[i * stride]);
+			}
+
+			float palette[8] = { static_cast<float>(maxValue), static_cast<float>(minValue) };
+			for (int k = 2; k < 8; k++)
+			{
+				palette[k] = ((8 - k) * palette[0] + (k - 1) * palette[1]) / 7.0f;
+			}
+
+			uint64_t indices = 0;
+			for (int i = 0; i < 16; i++)
+			{
+				uint64_t best = 0;
+				float	 bestDistance = FLT_MAX;
+				for (uint64_t p = 0; p < 8; p++)
+				{
+					const float distance = std::abs(values[i * stride] - palette[p]);
+					if (distance < bestDistance)
+					{
+						best = p;
+						bestDistance = distance;
+					}
+				}
+				indices |= best << (3 * i);
+			}
+
+			out[0] = maxValue;
+			out[1] = minValue;
+			writeLE(out + 2, indices, 6);
+		}
+	} // namespace
+
+	size_t GetBlockSize(BlockFormat format)
+	{
+		return format == BLOCK_FORMAT_BC1 || format == BLOCK_FORMAT_BC4 ? 8 : 16;
+	}
+
+	size_t GetCompressedSize(BlockFormat format, int width, int height)
+	{
+		const size_t blocksX = std::max(1, (width + 3) / 4);
+		const size_t blocksY = std::max(1, (height + 3) / 4);
+		return blocksX * blocksY * GetBlockSize(format);
+	}
+
+	const char* GetBlockFormatName(BlockFormat format)
+	{
+		switch (format)
+		{
+			case BLOCK_FORMAT_BC1:
+				return "BC1";
+			case BLOCK_FORMAT_BC3:
+				return "BC3";
+			case BLOCK_FORMAT_BC4:
+				return "BC4";
+			case BLOCK_FORMAT_BC5:
+				return "BC5";
+			default:
+				return "Unknown";
+		}
+	}
+
+	std::vector<uint8_t> CompressImage(const uint8_t* rgba, int width, int height, BlockFormat format)
+	{
+		std::vector<uint8_t> compressed(GetCompressedSize(format, width, height));
+		const size_t		 blockSize = GetBlockSize(format);
+		const int			 blocksX = std::max(1, (width + 3) / 4);
+		const int			 blocksY = std::max(1, (height + 3) / 4);
+
+		uint8_t block[16 * 4];
+		for (int by = 0; by < blocksY; by++)
+		{
+			for (int bx = 0; bx < blocksX; bx++)
+			{
+				for (int y = 0; y < 4; y++)
+				{
+					for (int x = 0; x < 4; x++)
+					{
+						const int px = std::min(bx * 4 + x, width - 1);
+						const int py = std::min(by * 4 + y, height - 1);
+						std::memcpy(block + (y * 4 + x) * 4, rgba + (static_cast<size_t>(py) * width + px) * 4, 4);
+					}
+				}
+
+				uint8_t* out = compressed.data() + (static_cast<size_t>(by) * blocksX + bx) * blockSize;
+				switch (format)
+				{
+					case BLOCK_FORMAT_BC1:
+						encodeColorBlock(block, out);
+						break;
+					case BLOCK_FORMAT_BC3:
+						encodeValueBlock(block + 3, 4, out);
+						encodeColorBlock(block, out + 8);
+						break;
+					case BLOCK_FORMAT_BC4:
+						encodeValueBlock(block, 4, out);
+						break;
+					case BLOCK_FORMAT_BC5:
+						encodeValueBlock(block, 4, out);
+						encodeValueBlock(block + 1, 4, out + 8);
+						break;
+					default:
+						break;
+				}
+			}
+		}
+
+		return compressed;
+	}
+} // namespace lei3d
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace lei3d
+{
+	/*
+	 * The block compressed formats textures get cooked into. Every format stores 4x4 pixel blocks in a fixed number of
+	 * bytes, which the GPU samples without decompressing first:
+	 *   BC1: RGB, 8 bytes per block (6:1 against RGB8). Colour textures without alpha.
+	 *   BC3: RGBA, 16 bytes per block (4:1 against RGBA8). Colour textures with alpha.
+	 *   BC4: one channel, 8 bytes per block. Greyscale maps (ambient occlusion, roughness, ...).
+	 *   BC5: two channels, 16 bytes per block. Two channel maps.
+	 */
+	enum BlockFormat : uint32_t
+	{
+		BLOCK_FORMAT_BC1,
+		BLOCK_FORMAT_BC3,
+		BLOCK_FORMAT_BC4,
+		BLOCK_FORMAT_BC5,
+		BLOCK_FORMAT_COUNT
+	};
+
+	size_t		GetBlockSize(BlockFormat format); // Bytes per 4x4 block.
+	size_t		GetCompressedSize(BlockFormat format, int width, int height);
+	const char* GetBlockFormatName(BlockFormat format);
+
+	/*
+	 * Compresses an RGBA8 image (4 bytes per pixel whatever the format uses). Sizes that aren't a multiple of 4 are
+	 * padded by repeating the last row and column. Meant for cooking: it's a straightforward encoder (endpoints from
+	 * the principal axis of each block), not a fast one.
+	 */
+	std::vector<uint8_t> CompressImage(const uint8_t* rgba, int width, int height, BlockFormat format);
+} // namespace lei3d
@@ -0,0 +1,101 @@
+#include "CubeMap.hpp"
+
+#include "core/JobSystem.hpp"
+#include "logging/GLDebug.hpp"
+#include "rendering/TextureStreamer.hpp"
+
+#include <glad/glad.h>
+
+namespace lei3d
+{
+	CubeMap::CubeMap(const std::vector<std::string>& facePaths, JobSystem* jobs)
+		: m_Faces(facePaths.size())
+	{
+		auto decode = [this, &facePaths](uint32_t begin, uint32_t end) {
+			for (uint32_t i = begin; i < end; i++)
+			{
+				m_Faces[i] = Image(facePaths[i], false);
+			}
+		};
+
+		const uint32_t faceCount = static_cast<uint32_t>(facePaths.size());
+		if (jobs)
+		{
+			jobs->ParallelFor(faceCount, 1, decode);
+		}
+		else
+		{
+			decode(0, faceCount);
+		}
+	}
+
+	CubeMap::~CubeMap()
+	{
+		if (m_Streaming)
+		{
+			TextureStreamer::Cancel(this);
+		}
+		if (m_Uploaded)
+		{
+			GLCall(glDeleteTextures(1, &m_TextureID));
+		}
+	}
+
+	void CubeMap::Upload()
+	{
+		GLCall(glGenTextures(1, &m_TextureID));
+		GLCall(glBindTexture(GL_TEXTURE_CUBE_MAP, m_TextureID));
+		GLCall(glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR));
+		GLCall(glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR));
+		GLCall(glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
+		GLCall(glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
+		GLCall(glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE));
+		m_Uploaded = true;
+
+		// Storage first, the faces stream in over the next frames (see TextureStreamer).
+		std::vector<TextureStreamImage> images;
+		for (unsigned int i = 0; i < m_Faces.size(); i++)
+		{
+			// Images that failed to decode already warned about it.
+			const Image& face = m_Faces[i];
+			if (face.IsValid())
+			{
+				static constexpr GLenum FORMATS[] = { GL_RED, GL_RG, GL_RGB, GL_RGBA };
+				const GLenum			format = FORMATS[face.GetChannels() - 1];
+				const GLenum target = GL_TEXTURE_CUBE_MAP_POSITIVE_X + i; // valid because the cube maps are internally indexed.
+				GLCall(glTexImage2D(target, 0, GL_RGB, face.GetWidth(), face.GetHeight(), 0, format, GL_UNSIGNED_BYTE, nullptr));
+				images.push_back({ target, 0, face.GetWidth(), face.GetHeight(), format, false, face.GetPixels(),
+					static_cast<size_t>(face.GetWidth()) * face.GetChannels(), face.GetHeight() });
+				m_GpuBytes += static_cast<size_t>(face.GetWidth()) * face.GetHeight() * 3;
+			}
+		}
+
+		m_Streaming = true;
+		if (TextureStreamer::Stream({ this, m_TextureID, GL_TEXTURE_CUBE_MAP, images, nullptr, [this]() { finishUpload(); } }))
+		{
+			return;
+		}
+
+		for (const TextureStreamImage& image : images)
+		{
+			TextureStreamer::UploadRows(image, 0, image.rowCount, image.data);
+		}
+		finishUpload();
+	}
+
+	void CubeMap::finishUpload()
+	{
+		m_Faces.clear();
+		m_Streaming = false;
+	}
+
+	size_t CubeMap::GetCpuBytes() const
+	{
+		size_t bytes = 0;
+		for (const Image& face : m_Faces)
+		{
+			bytes += face.GetByteSize();
+		}
+		return bytes;
+	}
+} // namespace lei3d
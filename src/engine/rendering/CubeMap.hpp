@@ -0,0 +1,44 @@
+#pragma once
+
+#include "rendering/Image.hpp"
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace lei3d
+{
+	class JobSystem;
+
+	/*
+	 * A cube map texture, e.g. a sky box. Like Model, the constructor only decodes the faces (any thread) and Upload
+	 * creates the texture (main thread). The faces then stream in over the next frames (see TextureStreamer), after
+	 * which the decoded pixels are freed.
+	 */
+	class CubeMap
+	{
+	private:
+		std::vector<Image> m_Faces; // Right, left, up, down, front, back. Empty once streamed in.
+		unsigned int	   m_TextureID = 0;
+		size_t			   m_GpuBytes = 0;
+		bool			   m_Uploaded = false;
+		bool			   m_Streaming = false;
+
+	public:
+		CubeMap(const std::vector<std::string>& facePaths, JobSystem* jobs = nullptr); // With jobs, the faces decode in parallel.
+		~CubeMap();
+
+		CubeMap(const CubeMap&) = delete;
+		CubeMap& operator=(const CubeMap&) = delete;
+
+		void		 Upload();
+		bool		 IsUploaded() const { return m_Uploaded; }
+		unsigned int GetTextureID() const { return m_TextureID; }
+
+		size_t GetCpuBytes() const;
+		size_t GetGpuBytes() const { return m_GpuBytes; }
+
+	private:
+		void finishUpload();
+	};
+} // namespace lei3d
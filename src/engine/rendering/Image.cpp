@@ -0,0 +1,55 @@
+#include "Image.hpp"
+
+#include "logging/Log.hpp"
+
+#include <stb_image.h>
+
+#include <utility>
+
+namespace lei3d
+{
+	Image::Image(const std::string& path, bool flipVertically)
+	{
+		// The per thread version, so decoding on several threads at once doesn't race on stb's global flag.
+		stbi_set_flip_vertically_on_load_thread(flipVertically);
+		m_Pixels = stbi_load(path.c_str(), &m_Width, &m_Height, &m_Channels, 0);
+		if (!m_Pixels)
+		{
+			LEI_WARN("Image failed to load at path: {0} ({1})", path, stbi_failure_reason());
+			m_Width = m_Height = m_Channels = 0;
+		}
+	}
+
+	Image::~Image()
+	{
+		Free();
+	}
+
+	Image::Image(Image&& other) noexcept
+	{
+		*this = std::move(other);
+	}
+
+	Image& Image::operator=(Image&& other) noexcept
+	{
+		if (this != &other)
+		{
+			Free();
+			std::swap(m_Pixels, other.m_Pixels);
+			std::swap(m_Width, other.m_Width);
+			std::swap(m_Height, other.m_Height);
+			std::swap(m_Channels, other.m_Channels);
+		}
+		return *this;
+	}
+
+	void Image::Free()
+	{
+		if (m_Pixels)
+		{
+			stbi_image_free(m_Pixels);
+		}
+		m_Pixels = nullptr;
+		m_Width = m_Height = m_Channels = 0;
+	}
+} // namespace lei3d
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace lei3d
+{
+	/*
+	 * Pixels decoded from an image file with stb_image.
+	 * Decoding doesn't touch OpenGL, so unlike creating a texture it can happen on any thread (e.g. while loading a
+	 * scene in the background). The pixels are freed with the Image, once they have been uploaded.
+	 */
+	class Image
+	{
+	private:
+		unsigned char* m_Pixels = nullptr;
+		int			   m_Width = 0;
+		int			   m_Height = 0;
+		int			   m_Channels = 0;
+
+	public:
+		Image() = default;
+		Image(const std::string& path, bool flipVertically); // Logs a warning and stays invalid if decoding fails.
+		~Image();
+
+		Image(const Image&) = delete;
+		Image& operator=(const Image&) = delete;
+		Image(Image&& other) noexcept;
+		Image& operator=(Image&& other) noexcept;
+
+		bool				 IsValid() const { return m_Pixels != nullptr; }
+		const unsigned char* GetPixels() const { return m_Pixels; }
+		int					 GetWidth() const { return m_Width; }
+		int					 GetHeight() const { return m_Height; }
+		int					 GetChannels() const { return m_Channels; }
+		size_t				 GetByteSize() const { return static_cast<size_t>(m_Width) * m_Height * m_Channels; } // 0 if invalid.
+
+		void Free();
+	};
+} // namespace lei3d
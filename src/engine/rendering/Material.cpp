@@ -2,80 +2,97 @@
 
 namespace lei3d
 {
+	// Looked up for every mesh drawn, so hash them at compile time.
+	static constexpr StringId ALBEDO = "material.albedo"_sid;
+	static constexpr StringId AMBIENT = "material.ambient"_sid;
+	static constexpr StringId METALLIC = "material.metallic"_sid;
+	static constexpr StringId ROUGHNESS = "material.roughness"_sid;
+	static constexpr StringId TEXTURE_ALBEDO = "material.texture_albedo"_sid;
+	static constexpr StringId TEXTURE_AO = "material.texture_ao"_sid;
+	static constexpr StringId TEXTURE_BUMP = "material.texture_bump"_sid;
+	static constexpr StringId TEXTURE_METALLIC = "material.texture_metallic"_sid;
+	static constexpr StringId TEXTURE_NORMAL = "material.texture_normal"_sid;
+	static constexpr StringId TEXTURE_ROUGHNESS = "material.texture_roughness"_sid;
+	static constexpr StringId USE_ALBEDO_MAP = "material.use_albedo_map"_sid;
+	static constexpr StringId USE_AO_MAP = "material.use_ao_map"_sid;
+	static constexpr StringId USE_BUMP_MAP = "material.use_bump_map"_sid;
+	static constexpr StringId USE_METALLIC_MAP = "material.use_metallic_map"_sid;
+	static constexpr StringId USE_NORMAL_MAP = "material.use_normal_map"_sid;
+	static constexpr StringId USE_ROUGHNESS_MAP = "material.use_roughness_map"_sid;
 
 	void Material::bind(Shader& shader, unsigned int tex_offset)
 	{
 		int curr_offset = 0;
 		if (!m_UseAlbedoMap)
 		{
-			shader.setVec3("material.albedo", m_Albedo);
+			shader.setVec3(ALBEDO, m_Albedo);
 		}
 		else
 		{
-			shader.setInt("material.texture_albedo", tex_offset + curr_offset);
+			shader.setInt(TEXTURE_ALBEDO, tex_offset + curr_offset);
 			glActiveTexture(GL_TEXTURE0 + tex_offset + curr_offset);
-			glBindTexture(GL_TEXTURE_2D, m_AlbedoTexture->id);
+			glBindTexture(GL_TEXTURE_2D, m_AlbedoTexture->GetID());
 			curr_offset++;
 		}
 		if (!m_UseMetallicMap)
 		{
-			shader.setFloat("material.metallic", m_Metallic);
+			shader.setFloat(METALLIC, m_Metallic);
 		}
 		else
 		{
-			shader.setInt("material.texture_metallic", tex_offset + curr_offset);
+			shader.setInt(TEXTURE_METALLIC, tex_offset + curr_offset);
 			glActiveTexture(GL_TEXTURE0 + tex_offset + curr_offset);
-			glBindTexture(GL_TEXTURE_2D, m_MetallicTexture->id);
+			glBindTexture(GL_TEXTURE_2D, m_MetallicTexture->GetID());
 			curr_offset++;
 		}
 		if (!m_UseRoughnessMap)
 		{
-			shader.setFloat("material.roughness", m_Roughness);
+			shader.setFloat(ROUGHNESS, m_Roughness);
 		}
 		else
 		{
-			shader.setInt("material.texture_roughness", tex_offset + curr_offset);
+			shader.setInt(TEXTURE_ROUGHNESS, tex_offset + curr_offset);
 			glActiveTexture(GL_TEXTURE0 + tex_offset + curr_offset);
-			glBindTexture(GL_TEXTURE_2D, m_RoughnessTexture->id);
+			glBindTexture(GL_TEXTURE_2D, m_RoughnessTexture->GetID());
 			curr_offset++;
 		}
 		if (!m_UseAmbientMap)
 		{
-			shader.setFloat("material.ambient", m_Ambient);
+			shader.setFloat(AMBIENT, m_Ambient);
 		}
 		else
 		{
-			shader.setInt("material.texture_ao", tex_offset + curr_offset);
+			shader.setInt(TEXTURE_AO, tex_offset + curr_offset);
 			glActiveTexture(GL_TEXTURE0 + tex_offset + curr_offset);
-			glBindTexture(GL_TEXTURE_2D, m_AmbientTexture->id);
+			glBindTexture(GL_TEXTURE_2D, m_AmbientTexture->GetID());
 			curr_offset++;
 		}
 
 		if (m_UseNormalMap)
 		{
-			shader.setInt("material.texture_normal", tex_offset + curr_offset);
+			shader.setInt(TEXTURE_NORMAL, tex_offset + curr_offset);
 			glActiveTexture(GL_TEXTURE0 + tex_offset + curr_offset);
-			glBindTexture(GL_TEXTURE_2D, m_NormalMap->id);
+			glBindTexture(GL_TEXTURE_2D, m_NormalMap->GetID());
 			curr_offset++;
 		}
 		if (m_UseBumpMap)
 		{
-			shader.setInt("material.texture_bump", tex_offset + curr_offset);
+			shader.setInt(TEXTURE_BUMP, tex_offset + curr_offset);
 			glActiveTexture(GL_TEXTURE0 + tex_offset + curr_offset);
-			glBindTexture(GL_TEXTURE_2D, m_BumpMap->id);
+			glBindTexture(GL_TEXTURE_2D, m_BumpMap->GetID());
 			curr_offset++;
 		}
 		glActiveTexture(GL_TEXTURE0);
 		texture_count = curr_offset;
 
 		///< if someone knows how to add shader defines instead, pls replace
-		shader.setBool("material.use_albedo_map", m_UseAlbedoMap);
-		shader.setBool("material.use_metallic_map", m_UseMetallicMap);
-		shader.setBool("material.use_roughness_map", m_UseRoughnessMap);
-		shader.setBool("material.use_ao_map", m_UseAmbientMap);
+		shader.setBool(USE_ALBEDO_MAP, m_UseAlbedoMap);
+		shader.setBool(USE_METALLIC_MAP, m_UseMetallicMap);
+		shader.setBool(USE_ROUGHNESS_MAP, m_UseRoughnessMap);
+		shader.setBool(USE_AO_MAP, m_UseAmbientMap);
 
-		shader.setBool("material.use_normal_map", m_UseNormalMap);
-		shader.setBool("material.use_bump_map", m_UseBumpMap);
+		shader.setBool(USE_NORMAL_MAP, m_UseNormalMap);
+		shader.setBool(USE_BUMP_MAP, m_UseBumpMap);
 	}
 
 	void Material::unbind(unsigned int tex_offset)
@@ -2,18 +2,12 @@
 
 #include <glm/glm.hpp>
 #include <rendering/Shader.hpp>
+#include <rendering/Texture.hpp>
 #include <memory>
 
 namespace lei3d
 {
 
-	struct Texture
-	{
-		unsigned int id;
-		std::string	 type;
-		std::string	 path;
-	};
-
 	class Material
 	{
 	public:
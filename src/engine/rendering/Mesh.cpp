@@ -2,6 +2,8 @@
 
 #include "logging/GLDebug.hpp"
 
+#include <cmath>
+
 namespace lei3d
 {
 
@@ -10,35 +12,127 @@ namespace lei3d
 		// ::clown emoticon::
 	}
 
-	Mesh::Mesh(std::vector<Vertex>& vertices, std::vector<unsigned int>& indices, Material* material)
+	Mesh::Mesh(std::vector<Vertex> vertices, std::vector<unsigned int> indices, Material* material)
+		: material(material)
+		, m_OwnedVertices(std::move(vertices))
+		, m_OwnedIndices(std::move(indices))
+		, m_Vertices(m_OwnedVertices)
+		, m_Indices(m_OwnedIndices)
 	{
-		this->vertices = vertices;
-		this->indices = indices;
-		this->material = material;
+		computeMetrics();
+	}
+
+	Mesh::Mesh(std::span<const Vertex> vertices, std::span<const unsigned int> indices, Material* material)
+		: material(material)
+		, m_Vertices(vertices)
+		, m_Indices(indices)
+	{
+		computeMetrics();
+	}
 
-		setupMesh();
+	Mesh::Mesh(Mesh&& other) noexcept
+	{
+		*this = std::move(other);
+	}
+
+	Mesh& Mesh::operator=(Mesh&& other) noexcept
+	{
+		if (this != &other)
+		{
+			std::swap(material, other.material);
+			std::swap(m_OwnedVertices, other.m_OwnedVertices);
+			std::swap(m_OwnedIndices, other.m_OwnedIndices);
+			std::swap(m_Vertices, other.m_Vertices);
+			std::swap(m_Indices, other.m_Indices);
+			std::swap(m_BoundsMin, other.m_BoundsMin);
+			std::swap(m_BoundsMax, other.m_BoundsMax);
+			std::swap(m_UVDensity, other.m_UVDensity);
+			std::swap(VAO, other.VAO);
+			std::swap(VBO, other.VBO);
+			std::swap(EBO, other.EBO);
+		}
+		return *this;
 	}
 
 	Mesh::~Mesh()
 	{
-		GLCall(glDeleteBuffers(1, &VAO));
-		GLCall(glDeleteBuffers(1, &EBO));
-		GLCall(glDeleteBuffers(1, &VBO));
+		// Meshes that never got uploaded may be destroyed on a loading thread, which has no GL context.
+		if (IsUploaded())
+		{
+			GLCall(glDeleteVertexArrays(1, &VAO));
+			GLCall(glDeleteBuffers(1, &EBO));
+			GLCall(glDeleteBuffers(1, &VBO));
+		}
+	}
+
+	void Mesh::GetBounds(glm::vec3& boundsMin, glm::vec3& boundsMax) const
+	{
+		boundsMin = m_BoundsMin;
+		boundsMax = m_BoundsMax;
+	}
+
+	void Mesh::computeMetrics()
+	{
+		if (m_Vertices.empty())
+		{
+			return;
+		}
+
+		m_BoundsMin = m_BoundsMax = m_Vertices[0].Position;
+		for (const Vertex& vertex : m_Vertices)
+		{
+			m_BoundsMin = glm::min(m_BoundsMin, vertex.Position);
+			m_BoundsMax = glm::max(m_BoundsMax, vertex.Position);
+		}
+
+		// Area weighted over all triangles, so a few stretched ones don't skew it.
+		double worldArea = 0.0;
+		double uvArea = 0.0;
+		for (size_t i = 0; i + 2 < m_Indices.size(); i += 3)
+		{
+			if (m_Indices[i] >= m_Vertices.size() || m_Indices[i + 1] >= m_Vertices.size() || m_Indices[i + 2] >= m_Vertices.size())
+			{
+				continue;
+			}
+
+			const Vertex& a = m_Vertices[m_Indices[i]];
+			const Vertex& b = m_Vertices[m_Indices[i + 1]];
+			const Vertex& c = m_Vertices[m_Indices[i + 2]];
+			worldArea += glm::length(glm::cross(b.Position - a.Position, c.Position - a.Position)) * 0.5;
+
+			const glm::vec2 uvAB = b.TexCoords - a.TexCoords;
+			const glm::vec2 uvAC = c.TexCoords - a.TexCoords;
+			uvArea += std::abs(uvAB.x * uvAC.y - uvAB.y * uvAC.x) * 0.5;
+		}
+
+		if (uvArea > 1e-12)
+		{
+			m_UVDensity = static_cast<float>(std::sqrt(worldArea / uvArea));
+		}
 	}
 
-	void Mesh::setupMesh()
+	bool Mesh::IsUploaded() const
 	{
+		return VAO != 0;
+	}
+
+	void Mesh::Upload()
+	{
+		if (IsUploaded())
+		{
+			return;
+		}
+
 		GLCall(glGenVertexArrays(1, &VAO));
 		GLCall(glGenBuffers(1, &VBO));
 		GLCall(glGenBuffers(1, &EBO));
 
 		GLCall(glBindVertexArray(VAO));
 		GLCall(glBindBuffer(GL_ARRAY_BUFFER, VBO));
-		GLCall(glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), vertices.data(), GL_STATIC_DRAW));
+		GLCall(glBufferData(GL_ARRAY_BUFFER, m_Vertices.size_bytes(), m_Vertices.data(), GL_STATIC_DRAW));
 
 		GLCall(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO));
-		GLCall(glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int),
-			&indices[0], GL_STATIC_DRAW));
+		GLCall(glBufferData(GL_ELEMENT_ARRAY_BUFFER, m_Indices.size_bytes(), m_Indices.data(), GL_STATIC_DRAW));
 
 		// vertex positions
 		GLCall(glEnableVertexAttribArray(0));
@@ -79,7 +173,7 @@ namespace lei3d
 
 		// actually draw the mesh now
 		glBindVertexArray(VAO);
-		glDrawElements(GL_TRIANGLES, static_cast<unsigned int>(indices.size()), GL_UNSIGNED_INT, nullptr);
+		glDrawElements(GL_TRIANGLES, static_cast<unsigned int>(m_Indices.size()), GL_UNSIGNED_INT, nullptr);
 		glBindVertexArray(0);
 
 		if (flags & RenderFlag::BindImages)
@@ -4,6 +4,7 @@
 #include "rendering/Shader.hpp"
 
 #include <glm/glm.hpp>
+#include <span>
 #include <string>
 #include <vector>
 
@@ -25,23 +26,52 @@ namespace lei3d
 		AlphaMask = 0x00000004
 	};
 
+	/*
+	 * Vertex and index data, either owned by the mesh (imported with Assimp) or a view into memory that outlives it
+	 * (a mapped cooked model, see ModelFile). Either way the GPU gets it as is.
+	 */
 	class Mesh
 	{
 	public:
-		std::vector<Vertex>		  vertices;
-		std::vector<unsigned int> indices;
-		Material* material;
+		Material* material = nullptr;
 
 		Mesh();
-		Mesh(std::vector<Vertex>& vertices, std::vector<unsigned int>& indices, Material* material);
+		// No GL calls, so any thread. The span version doesn't copy, see above.
+		Mesh(std::vector<Vertex> vertices, std::vector<unsigned int> indices, Material* material);
+		Mesh(std::span<const Vertex> vertices, std::span<const unsigned int> indices, Material* material);
 		~Mesh();
 
+		Mesh(const Mesh&) = delete;
+		Mesh& operator=(const Mesh&) = delete;
+		Mesh(Mesh&& other) noexcept;
+		Mesh& operator=(Mesh&& other) noexcept;
+
+		std::span<const Vertex>		  GetVertices() const { return m_Vertices; }
+		std::span<const unsigned int> GetIndices() const { return m_Indices; }
+		void						  GetBounds(glm::vec3& boundsMin, glm::vec3& boundsMax) const; // Zero if there are no vertices.
+
+		// World units one unit of texture coordinates covers on average (0 without texture coordinates), so a texture's
+		// texel density on screen can be worked out from how far away the mesh is. See TextureResidency.
+		float GetUVDensity() const { return m_UVDensity; }
+
+		void Upload(); // Creates the GL buffers. Main thread only, and before the first Draw.
+		bool IsUploaded() const;
+
 		void Draw(Shader& shader, RenderFlag flags, uint32_t bindLocation) const;
 
 	private:
-		unsigned int VAO, VBO, EBO;
+		std::vector<Vertex>			  m_OwnedVertices; // Empty for views.
+		std::vector<unsigned int>	  m_OwnedIndices;
+		std::span<const Vertex>		  m_Vertices; // Into m_OwnedVertices, or the view. Moving a vector keeps its buffer.
+		std::span<const unsigned int> m_Indices;
+
+		glm::vec3 m_BoundsMin = glm::vec3(0.0f);
+		glm::vec3 m_BoundsMax = glm::vec3(0.0f);
+		float	  m_UVDensity = 0.0f;
+
+		unsigned int VAO = 0, VBO = 0, EBO = 0;
 
-		void setupMesh();
+		void computeMetrics(); // Bounds and UV density, in the constructors. Goes over every triangle.
 	};
 
 } // namespace lei3d
\ No newline at end of file
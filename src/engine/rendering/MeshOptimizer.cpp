@@ -0,0 +1,418 @@
+#include "MeshOptimizer.hpp"
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+#include <unordered_map>
+
+namespace lei3d
+{
+	namespace
+	{
+		// Forsyth's tuning. The cache is modelled bigger than CACHE_SIZE, which works well for smaller ones too.
+		constexpr uint32_t FORSYTH_CACHE_SIZE = 32;
+		constexpr float	   CACHE_DECAY_POWER = 1.5f;
+		constexpr float	   LAST_TRIANGLE_SCORE = 0.75f;
+		constexpr float	   VALENCE_BOOST_SCALE = 2.0f;
+		constexpr float	   VALENCE_BOOST_POWER = 0.5f;
+
+		constexpr unsigned int UNUSED = ~0u;
+
+		// Vertices are only welded if every byte matches, so hashing the bytes is enough.
+		struct VertexHash
+		{
+			size_t operator()(const Vertex& vertex) const
+			{
+				const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&vertex);
+				uint64_t			 hash = 14695981039346656037ull; // FNV-1a
+				for (size_t i = 0; i < sizeof(Vertex); i++)
+				{
+					hash = (hash ^ bytes[i]) * 1099511628211ull;
+				}
+				return static_cast<size_t>(hash);
+			}
+		};
+
+		struct VertexEqual
+		{
+			bool operator()(const Vertex& a, const Vertex& b) const { return std::memcmp(&a, &b, sizeof(Vertex)) == 0; }
+		};
+
+		// A FIFO post-transform cache. A vertex is cached if it missed at most size misses ago.
+		class FifoCache
+		{
+		private:
+			std::vector<uint32_t> m_Timestamps;
+			uint32_t			  m_Size;
+			uint32_t			  m_Time;
+
+		public:
+			FifoCache(size_t vertexCount, uint32_t size)
+				: m_Timestamps(vertexCount, 0)
+				, m_Size(size)
+				, m_Time(size + 1)
+			{
+			}
+
+			void Reset() { m_Time += m_Size + 1; }
+
+			uint32_t Misses(const unsigned int* triangle)
+			{
+				uint32_t misses = 0;
+				for (int i = 0; i < 3; i++)
+				{
+					if (m_Time - m_Timestamps[triangle[i]] > m_Size)
+					{
+						m_Timestamps[triangle[i]] = m_Time++;
+						misses++;
+					}
+				}
+				return misses;
+			}
+		};
+
+		float vertexScore(int cachePosition, uint32_t remainingTriangles)
+		{
+			if (remainingTriangles == 0)
+			{
+				return -1.0f;
+			}
+
+			float score = 0.0f;
+			if (cachePosition >= 0)
+			{
+				// The last triangle's vertices get a fixed score, so the next triangle doesn't just reuse the same edge.
+				score = cachePosition < 3
+					? LAST_TRIANGLE_SCORE
+					: std::pow(1.0f - float(cachePosition - 3) / (FORSYTH_CACHE_SIZE - 3), CACHE_DECAY_POWER);
+			}
+			// Vertices with few triangles left get finished off, instead of leaving lone triangles for later.
+			return score + VALENCE_BOOST_SCALE * std::pow(float(remainingTriangles), -VALENCE_BOOST_POWER);
+		}
+	} // namespace
+
+	MeshOptimizationStats& MeshOptimizationStats::operator+=(const MeshOptimizationStats& other)
+	{
+		triangles += other.triangles;
+		verticesBefore += other.verticesBefore;
+		verticesAfter += other.verticesAfter;
+		transformsBefore += other.transformsBefore;
+		transformsAfter += other.transformsAfter;
+		return *this;
+	}
+
+	MeshOptimizationStats OptimizeMesh(std::vector<Vertex>& vertices, std::vector<unsigned int>& indices)
+	{
+		MeshOptimizationStats stats;
+		stats.triangles = indices.size() / 3;
+		stats.verticesBefore = vertices.size();
+		stats.transformsBefore = CountVertexTransforms(indices, vertices.size());
+
+		WeldVertices(vertices, indices);
+		OptimizeVertexCache(indices, vertices.size());
+		OptimizeOverdraw(indices, vertices);
+		OptimizeVertexFetch(vertices, indices);
+
+		stats.verticesAfter = vertices.size();
+		stats.transformsAfter = CountVertexTransforms(indices, vertices.size());
+		return stats;
+	}
+
+	void WeldVertices(std::vector<Vertex>& vertices, std::vector<unsigned int>& indices)
+	{
+		std::unordered_map<Vertex, unsigned int, VertexHash, VertexEqual> unique;
+		unique.reserve(vertices.size());
+
+		std::vector<unsigned int> remap(vertices.size());
+		std::vector<Vertex>		  welded;
+		welded.reserve(vertices.size());
+		for (size_t i = 0; i < vertices.size(); i++)
+		{
+			const auto [it, inserted] = unique.try_emplace(vertices[i], static_cast<unsigned int>(welded.size()));
+			if (inserted)
+			{
+				welded.push_back(vertices[i]);
+			}
+			remap[i] = it->second;
+		}
+
+		for (unsigned int& index : indices)
+		{
+			index = remap[index];
+		}
+		vertices.swap(welded);
+	}
+
+	void OptimizeVertexCache(std::vector<unsigned int>& indices, size_t vertexCount)
+	{
+		const size_t triangleCount = indices.size() / 3;
+		if (triangleCount == 0)
+		{
+			return;
+		}
+
+		// The triangles using each vertex, all in one array. remaining[v] of them from offsets[v] on aren't emitted yet.
+		std::vector<uint32_t> remaining(vertexCount, 0);
+		for (size_t i = 0; i < triangleCount * 3; i++)
+		{
+			remaining[indices[i]]++;
+		}
+		std::vector<uint32_t> offsets(vertexCount + 1, 0);
+		for (size_t v = 0; v < vertexCount; v++)
+		{
+			offsets[v + 1] = offsets[v] + remaining[v];
+		}
+		std::vector<uint32_t> adjacency(triangleCount * 3);
+		{
+			std::vector<uint32_t> next(offsets.begin(), offsets.end() - 1);
+			for (size_t i = 0; i < triangleCount * 3; i++)
+			{
+				adjacency[next[indices[i]]++] = static_cast<uint32_t>(i / 3);
+			}
+		}
+
+		std::vector<int>   cachePositions(vertexCount, -1);
+		std::vector<float> vertexScores(vertexCount);
+		for (size_t v = 0; v < vertexCount; v++)
+		{
+			vertexScores[v] = vertexScore(-1, remaining[v]);
+		}
+		std::vector<float> triangleScores(triangleCount);
+		for (size_t t = 0; t < triangleCount; t++)
+		{
+			triangleScores[t] = vertexScores[indices[t * 3]] + vertexScores[indices[t * 3 + 1]] + vertexScores[indices[t * 3 + 2]];
+		}
+
+		// Rescores a vertex and every triangle of it that's left.
+		auto updateVertex = [&](unsigned int v, int cachePosition) {
+			cachePositions[v] = cachePosition;
+			const float score = vertexScore(cachePosition, remaining[v]);
+			const float delta = score - vertexScores[v];
+			vertexScores[v] = score;
+			for (uint32_t i = offsets[v]; i < offsets[v] + remaining[v]; i++)
+			{
+				triangleScores[adjacency[i]] += delta;
+			}
+		};
+
+		std::vector<bool>		  emitted(triangleCount, false);
+		std::vector<unsigned int> cache, nextCache;
+		std::vector<unsigned int> result;
+		result.reserve(triangleCount * 3);
+		size_t deadEndCursor = 0; // No triangle before it is left.
+		size_t best = triangleCount;
+
+		while (result.size() < triangleCount * 3)
+		{
+			// None of the cached vertices has triangles left: start again from the first one in input order.
+			if (best == triangleCount)
+			{
+				while (emitted[deadEndCursor])
+				{
+					deadEndCursor++;
+				}
+				best = deadEndCursor;
+			}
+
+			const unsigned int* triangle = &indices[best * 3];
+			emitted[best] = true;
+			for (int k = 0; k < 3; k++)
+			{
+				const unsigned int v = triangle[k];
+				result.push_back(v);
+
+				uint32_t* begin = &adjacency[offsets[v]];
+				uint32_t* end = begin + remaining[v];
+				std::iter_swap(std::find(begin, end, static_cast<uint32_t>(best)), end - 1);
+				remaining[v]--;
+			}
+
+			// The triangle's vertices go to the front, what doesn't fit anymore falls out of the back.
+			nextCache.clear();
+			for (int k = 0; k < 3; k++)
+			{
+				if (std::find(nextCache.begin(), nextCache.end(), triangle[k]) == nextCache.end())
+				{
+					nextCache.push_back(triangle[k]);
+				}
+			}
+			for (unsigned int v : cache)
+			{
+				if (v != triangle[0] && v != triangle[1] && v != triangle[2])
+				{
+					nextCache.push_back(v);
+				}
+			}
+			for (size_t i = FORSYTH_CACHE_SIZE; i < nextCache.size(); i++)
+			{
+				updateVertex(nextCache[i], -1);
+			}
+			nextCache.resize(std::min<size_t>(nextCache.size(), FORSYTH_CACHE_SIZE));
+			cache.swap(nextCache);
+
+			// Only triangles of cached vertices can be the best next one, everything else scores lower.
+			for (size_t i = 0; i < cache.size(); i++)
+			{
+				updateVertex(cache[i], static_cast<int>(i));
+			}
+			best = triangleCount;
+			float bestScore = -1.0f;
+			for (unsigned int v : cache)
+			{
+				for (uint32_t i = offsets[v]; i < offsets[v] + remaining[v]; i++)
+				{
+					if (triangleScores[adjacency[i]] > bestScore)
+					{
+						bestScore = triangleScores[adjacency[i]];
+						best = adjacency[i];
+					}
+				}
+			}
+		}
+
+		indices.swap(result);
+	}
+
+	void OptimizeOverdraw(std::vector<unsigned int>& indices, std::span<const Vertex> vertices, float threshold)
+	{
+		const size_t triangleCount = indices.size() / 3;
+		if (triangleCount < 2)
+		{
+			return;
+		}
+
+		const size_t transforms = CountVertexTransforms(indices, vertices.size());
+		FifoCache	 cache(vertices.size(), MeshOptimizationStats::CACHE_SIZE);
+
+		// Hard boundaries: triangles all of whose vertices miss. The cache is cold there whatever comes before.
+		std::vector<size_t> hardClusters;
+		for (size_t t = 0; t < triangleCount; t++)
+		{
+			const uint32_t misses = cache.Misses(&indices[t * 3]);
+			if (t == 0 || misses == 3)
+			{
+				hardClusters.push_back(t);
+			}
+		}
+		hardClusters.push_back(triangleCount);
+
+		// Soft boundaries: within a hard cluster, wherever the part so far has an ACMR within the threshold of the
+		// whole cluster's even starting from a cold cache. The reordering can't make those parts much worse.
+		std::vector<size_t> clusters;
+		for (size_t c = 0; c + 1 < hardClusters.size(); c++)
+		{
+			const size_t start = hardClusters[c];
+			const size_t end = hardClusters[c + 1];
+
+			cache.Reset();
+			size_t clusterMisses = 0;
+			for (size_t t = start; t < end; t++)
+			{
+				clusterMisses += cache.Misses(&indices[t * 3]);
+			}
+			const float limit = threshold * float(clusterMisses) / float(end - start);
+
+			cache.Reset();
+			clusters.push_back(start);
+			size_t misses = 0;
+			for (size_t t = start; t + 1 < end; t++)
+			{
+				misses += cache.Misses(&indices[t * 3]);
+				if (float(misses) / float(t + 1 - clusters.back()) <= limit)
+				{
+					clusters.push_back(t + 1);
+					cache.Reset();
+					misses = 0;
+				}
+			}
+		}
+		clusters.push_back(triangleCount);
+
+		// Sort the clusters by how much they face away from the mesh's centre, outermost first.
+		const size_t		   clusterCount = clusters.size() - 1;
+		std::vector<glm::vec3> centroids(clusterCount, glm::vec3(0.0f));
+		std::vector<glm::vec3> normals(clusterCount, glm::vec3(0.0f));
+		std::vector<float>	   areas(clusterCount, 0.0f);
+		glm::vec3			   meshCentroid(0.0f);
+		float				   meshArea = 0.0f;
+		for (size_t c = 0; c < clusterCount; c++)
+		{
+			for (size_t t = clusters[c]; t < clusters[c + 1]; t++)
+			{
+				const glm::vec3& p0 = vertices[indices[t * 3]].Position;
+				const glm::vec3& p1 = vertices[indices[t * 3 + 1]].Position;
+				const glm::vec3& p2 = vertices[indices[t * 3 + 2]].Position;
+				const glm::vec3	 normal = glm::cross(p1 - p0, p2 - p0); // Twice the area long.
+				const float		 area = glm::length(normal);
+
+				centroids[c] += (p0 + p1 + p2) * (area / 3.0f);
+				normals[c] += normal;
+				areas[c] += area;
+			}
+			meshCentroid += centroids[c];
+			meshArea += areas[c];
+		}
+		if (meshArea > 0.0f)
+		{
+			meshCentroid /= meshArea;
+		}
+
+		std::vector<float> sortKeys(clusterCount, 0.0f);
+		for (size_t c = 0; c < clusterCount; c++)
+		{
+			const float normalLength = glm::length(normals[c]);
+			if (areas[c] > 0.0f && normalLength > 0.0f)
+			{
+				sortKeys[c] = glm::dot(centroids[c] / areas[c] - meshCentroid, normals[c] / normalLength);
+			}
+		}
+
+		std::vector<size_t> order(clusterCount);
+		std::iota(order.begin(), order.end(), size_t(0));
+		std::stable_sort(order.begin(), order.end(), [&sortKeys](size_t a, size_t b) { return sortKeys[a] > sortKeys[b]; });
+
+		std::vector<unsigned int> result;
+		result.reserve(indices.size());
+		for (size_t c : order)
+		{
+			result.insert(result.end(), indices.begin() + clusters[c] * 3, indices.begin() + clusters[c + 1] * 3);
+		}
+
+		// The last part of each hard cluster isn't bounded, so check the whole thing still is.
+		if (float(CountVertexTransforms(result, vertices.size())) <= threshold * float(transforms))
+		{
+			indices.swap(result);
+		}
+	}
+
+	void OptimizeVertexFetch(std::vector<Vertex>& vertices, std::vector<unsigned int>& indices)
+	{
+		std::vector<unsigned int> remap(vertices.size(), UNUSED);
+		std::vector<Vertex>		  ordered;
+		ordered.reserve(vertices.size());
+		for (unsigned int& index : indices)
+		{
+			if (remap[index] == UNUSED)
+			{
+				remap[index] = static_cast<unsigned int>(ordered.size());
+				ordered.push_back(vertices[index]);
+			}
+			index = remap[index];
+		}
+		vertices.swap(ordered);
+	}
+
+	size_t CountVertexTransforms(std::span<const unsigned int> indices, size_t vertexCount, uint32_t cacheSize)
+	{
+		FifoCache cache(vertexCount, cacheSize);
+		size_t	  misses = 0;
+		for (size_t i = 0; i + 3 <= indices.size(); i += 3)
+		{
+			misses += cache.Misses(&indices[i]);
+		}
+		return misses;
+	}
+} // namespace lei3d
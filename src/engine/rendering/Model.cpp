@@ -1,35 +1,155 @@
 #include "Model.hpp"
 
+#include "core/JobSystem.hpp"
 #include "logging/LogGLM.hpp"
 
+#include <algorithm>
+#include <filesystem>
+
 namespace lei3d
 {
 
-	Model::Model(const std::string& modelPath)
+	static_assert(sizeof(btScalar) == sizeof(float), "Collision meshes point Bullet straight at the Vertex positions");
+
+	// Texture pointers are set already, this turns on the ones that are there.
+	static void updateTextureFlags(Material& material)
+	{
+		material.m_UseAlbedoMap = material.m_AlbedoTexture != nullptr;
+		material.m_UseMetallicMap = material.m_MetallicTexture != nullptr;
+		material.m_UseRoughnessMap = material.m_RoughnessTexture != nullptr;
+		material.m_UseAmbientMap = material.m_AmbientTexture != nullptr;
+		material.m_UseNormalMap = material.m_NormalMap != nullptr;
+		material.m_UseBumpMap = material.m_BumpMap != nullptr;
+	}
+
+	// Runs job on jobs, or right away if there's no job system.
+	static void runJob(JobSystem* jobs, JobCounter& counter, JobSystem::Job job)
 	{
-		loadModel(modelPath);
+		if (jobs)
+		{
+			jobs->Run(std::move(job), counter);
+		}
+		else
+		{
+			job();
+		}
+	}
+
+	Model::Model(const std::string& modelPath, uint32_t flags, JobSystem* jobs)
+		: m_Directory(modelPath.substr(0, modelPath.find_last_of('/')))
+		, m_DecodeTextures(!(flags & MODEL_LOAD_NO_TEXTURES))
+		, m_CacheTextures(!(flags & MODEL_LOAD_NO_CACHE))
+		, m_Optimize(!(flags & MODEL_LOAD_NO_OPTIMIZE))
+	{
+		std::vector<MaterialTextures> materialTextures;
+		if (!(flags & MODEL_LOAD_IMPORT) && loadCooked(modelPath, materialTextures))
+		{
+			// The meshes are ready as they are, only the textures are left.
+			JobCounter counter;
+			loadTextures(jobs, counter);
+			if (jobs)
+			{
+				jobs->Wait(counter);
+			}
+		}
+		else
+		{
+			loadModel(modelPath, jobs, materialTextures);
+		}
+		bindTextures(materialTextures);
 	}
 
 	Model::~Model()
 	{
-		for (btTriangleMesh* mesh : m_BTMeshes)
+		for (btBvhTriangleMeshShape* shape : m_CollisionShapes)
+		{
+			delete shape;
+		}
+		for (btTriangleIndexVertexArray* mesh : m_CollisionMeshes)
 		{
 			delete mesh;
 		}
 	}
 
+	void Model::Upload()
+	{
+		for (Mesh& mesh : m_Meshes)
+		{
+			mesh.Upload();
+			m_GpuBytes += mesh.GetVertices().size_bytes() + mesh.GetIndices().size_bytes();
+		}
+
+		// Shared textures may have been uploaded by another model already, then this does nothing.
+		for (ModelTexture& texture : textures)
+		{
+			texture.texture->Upload();
+			if (!m_CacheTextures)
+			{
+				m_GpuBytes += texture.texture->GetGpuBytes();
+			}
+		}
+		m_Uploaded = true;
+	}
+
+	bool Model::IsUploaded() const
+	{
+		return m_Uploaded;
+	}
+
+	size_t Model::GetCpuBytes() const
+	{
+		size_t bytes = 0;
+		if (m_CookedFile.IsOpen())
+		{
+			// The meshes and BVHs are views into the mapping.
+			bytes += m_CookedFile.GetHeader().fileSize;
+		}
+		else
+		{
+			for (const Mesh& mesh : m_Meshes)
+			{
+				bytes += mesh.GetVertices().size_bytes() + mesh.GetIndices().size_bytes();
+
+				// Roughly one quantized BVH node per triangle.
+				if (!m_CollisionShapes.empty())
+				{
+					bytes += mesh.GetIndices().size() / 3 * 16;
+				}
+			}
+		}
+
+		if (!m_CacheTextures)
+		{
+			for (const ModelTexture& texture : textures)
+			{
+				bytes += texture.texture->GetCpuBytes();
+			}
+		}
+		return bytes;
+	}
+
+	size_t Model::GetGpuBytes() const
+	{
+		return m_GpuBytes;
+	}
+
 	void Model::Draw(Shader& shader, RenderFlag flags, uint32_t bindLocation)
 	{
+		if (!m_Uploaded)
+		{
+			Upload();
+		}
+
 		for (unsigned int i = 0; i < this->m_Meshes.size(); i++)
 		{
 			m_Meshes[i].Draw(shader, flags, bindLocation);
 		}
 	}
 
-	void Model::loadModel(const std::string& path)
+	void Model::loadModel(const std::string& path, JobSystem* jobs, std::vector<MaterialTextures>& materialTextures)
 	{
 		Assimp::Importer importer;
-		const aiScene*	 scene = importer.ReadFile(path, aiProcess_Triangulate | aiProcess_GenNormals | aiProcess_CalcTangentSpace | aiProcess_FlipUVs);
+		const aiScene*	 scene = importer.ReadFile(path, aiProcess_Triangulate | aiProcess_JoinIdenticalVertices | aiProcess_GenNormals | aiProcess_CalcTangentSpace | aiProcess_FlipUVs);
 
 		if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode)
 		{
@@ -37,37 +157,167 @@ namespace lei3d
 			LEI_WARN("ERROR::ASSIMP::" + errorString);
 			return;
 		}
-		m_Directory = path.substr(0, path.find_last_of('/'));
 
-		loadMaterials(scene);
-		processNode(scene->mRootNode, scene);
+		loadMaterials(scene, materialTextures);
+
+		// The textures decode while the meshes convert, all of them reading and writing only their own data.
+		JobCounter counter;
+		loadTextures(jobs, counter);
+
+		std::vector<const aiMesh*> sceneMeshes;
+		collectMeshes(scene->mRootNode, scene, sceneMeshes);
+
+		std::vector<std::vector<Vertex>>	   vertices(sceneMeshes.size());
+		std::vector<std::vector<unsigned int>> indices(sceneMeshes.size());
+		std::vector<MeshOptimizationStats>	   optimizationStats(sceneMeshes.size());
+		for (size_t i = 0; i < sceneMeshes.size(); i++)
+		{
+			runJob(jobs, counter, [this, &sceneMeshes, &vertices, &indices, &optimizationStats, i]() {
+				processMesh(sceneMeshes[i], vertices[i], indices[i]);
+				if (m_Optimize)
+				{
+					optimizationStats[i] = OptimizeMesh(vertices[i], indices[i]);
+				}
+			});
+		}
+		if (jobs)
+		{
+			jobs->Wait(counter);
+		}
+		for (const MeshOptimizationStats& stats : optimizationStats)
+		{
+			m_OptimizationStats += stats;
+		}
+
+		m_Meshes.reserve(sceneMeshes.size());
+		for (size_t i = 0; i < sceneMeshes.size(); i++)
+		{
+			const unsigned int materialIndex = sceneMeshes[i]->mMaterialIndex;
+			Material*		   material = materialIndex < materials.size() ? materials[materialIndex].get() : nullptr;
+			m_Meshes.emplace_back(std::move(vertices[i]), std::move(indices[i]), material);
+		}
+
+		for (size_t i = 0; i < m_Meshes.size(); i++)
+		{
+			glm::vec3 meshMin, meshMax;
+			m_Meshes[i].GetBounds(meshMin, meshMax);
+			m_BoundsMin = i == 0 ? meshMin : glm::min(m_BoundsMin, meshMin);
+			m_BoundsMax = i == 0 ? meshMax : glm::max(m_BoundsMax, meshMax);
+		}
+	}
+
+	bool Model::loadCooked(const std::string& path, std::vector<MaterialTextures>& materialTextures)
+	{
+		namespace fs = std::filesystem;
+
+		const std::string cookedPath = ModelFile::GetCookedPath(path);
+		std::error_code	  error;
+		if (!fs::exists(cookedPath, error))
+		{
+			return false;
+		}
+		if (!m_CookedFile.Open(cookedPath))
+		{
+			return false;
+		}
+		if (!m_CookedFile.IsSourceUnchanged(path))
+		{
+			// Imported instead, IsSourceUnchanged logged why.
+			m_CookedFile.Close();
+			return false;
+		}
+
+		const ModelFileHeader& header = m_CookedFile.GetHeader();
+		m_OptimizationStats = m_CookedFile.GetOptimizationStats();
+		for (uint32_t i = 0; i < header.textureCount; i++)
+		{
+			const ModelFileTexture& texture = m_CookedFile.GetTexture(i);
+			textures.push_back({ nullptr, m_CookedFile.GetString(texture.path), m_CookedFile.GetString(texture.type) });
+		}
+
+		for (uint32_t i = 0; i < header.materialCount; i++)
+		{
+			const ModelFileMaterial& record = m_CookedFile.GetMaterial(i);
+			Material*				 material = new Material();
+			material->m_Albedo = glm::vec3(record.albedo[0], record.albedo[1], record.albedo[2]);
+			material->m_Metallic = record.metallic;
+			material->m_Roughness = record.roughness;
+			materials.emplace_back(material);
+
+			MaterialTextures& slots = materialTextures.emplace_back();
+			std::copy(std::begin(record.textures), std::end(record.textures), slots.begin());
+		}
+
+		m_Meshes.reserve(header.meshCount);
+		for (uint32_t i = 0; i < header.meshCount; i++)
+		{
+			const ModelFileMesh& mesh = m_CookedFile.GetMesh(i);
+			m_Meshes.emplace_back(std::span<const Vertex>(m_CookedFile.At<Vertex>(mesh.vertices), mesh.vertexCount),
+				std::span<const unsigned int>(m_CookedFile.At<unsigned int>(mesh.indices), mesh.indexCount),
+				mesh.material == MODEL_FILE_NONE ? nullptr : materials[mesh.material].get());
+		}
+
+		m_BoundsMin = glm::vec3(header.boundsMin[0], header.boundsMin[1], header.boundsMin[2]);
+		m_BoundsMax = glm::vec3(header.boundsMax[0], header.boundsMax[1], header.boundsMax[2]);
+		return true;
+	}
+
+	void Model::loadTextures(JobSystem* jobs, JobCounter& counter)
+	{
+		// textures doesn't change size from here on, so every job can hold on to its entry.
+		for (ModelTexture& texture : textures)
+		{
+			const std::string path = m_Directory + '/' + texture.path;
+			if (!m_DecodeTextures)
+			{
+				texture.texture = std::make_shared<Texture>(path, false);
+				continue;
+			}
+
+			runJob(jobs, counter, [this, &texture, path]() {
+				texture.texture = m_CacheTextures ? AssetManager::GetTexture(path) : std::make_shared<Texture>(path);
+			});
+		}
+	}
+
+	void Model::bindTextures(const std::vector<MaterialTextures>& materialTextures)
+	{
+		for (size_t i = 0; i < materials.size(); i++)
+		{
+			for (uint32_t slot = 0; slot < MODEL_TEXTURE_SLOT_COUNT; slot++)
+			{
+				const uint32_t texture = materialTextures[i][slot];
+				MaterialTextureSlot(*materials[i], static_cast<ModelTextureSlot>(slot)) = texture == MODEL_FILE_NONE ? nullptr : textures[texture].texture.get();
+			}
+			updateTextureFlags(*materials[i]);
+		}
 	}
 
-	void Model::processNode(aiNode* node, const aiScene* scene)
+	// The meshes of node and its children, in the order they get drawn.
+	void Model::collectMeshes(const aiNode* node, const aiScene* scene, std::vector<const aiMesh*>& meshes)
 	{
 		// process node's meshes
 		for (unsigned int i = 0; i < node->mNumMeshes; i++)
 		{
-			aiMesh* mesh = scene->mMeshes[node->mMeshes[i]];
-			m_Meshes.push_back(processMesh(mesh, scene));
+			meshes.push_back(scene->mMeshes[node->mMeshes[i]]);
 		}
 
 		// process node children
 		for (unsigned int i = 0; i < node->mNumChildren; i++)
 		{
-			processNode(node->mChildren[i], scene);
+			collectMeshes(node->mChildren[i], scene, meshes);
 		}
 	}
 
 	/**
-	 * Given an mesh and the scene it belongs to, create our own representation of a mesh
-	 * object that we can render.
+	 * Given an assimp mesh, fill in the vertices and indices of our own representation of it.
+	 * Only reads the mesh, so several can be processed at once.
 	 *
 	 */
-	Mesh Model::processMesh(aiMesh* mesh, const aiScene* scene)
+	void Model::processMesh(const aiMesh* mesh, std::vector<Vertex>& vertices, std::vector<unsigned int>& indices)
 	{
-		std::vector<Vertex>		  vertices;
-		std::vector<unsigned int> indices;
+		vertices.reserve(mesh->mNumVertices);
+		indices.reserve(static_cast<size_t>(mesh->mNumFaces) * 3);
 
 		// process vertices from assimp to our own mesh component
 		for (unsigned int i = 0; i < mesh->mNumVertices; i++)
@@ -113,33 +363,21 @@ namespace lei3d
 		// we set all of our faces to be triangles, so it's easy to get the indices we need
 		for (unsigned int i = 0; i < mesh->mNumFaces; i++)
 		{
-			aiFace face = mesh->mFaces[i];
+			const aiFace& face = mesh->mFaces[i];
 			for (unsigned int j = 0; j < face.mNumIndices; j++)
 			{
 				indices.push_back(face.mIndices[j]);
 			}
 		}
-
-		// finally load all the materials we want
-		Material* material = nullptr;
-		if (mesh->mMaterialIndex >= 0)
-		{
-			material = materials[mesh->mMaterialIndex].get();
-		}
-
-		// return a mesh object created from the extracted mesh data
-		return { vertices, indices, material };
 	}
 
-	// get the materials that we want from the assimp mat and convert it to textures array that is returned
-	Texture* Model::loadMaterialTexture(const aiMaterial* mat, aiTextureType type, const std::string& typeName)
+	// get the index (into textures) of the first texture of a type the assimp mat has, or MODEL_FILE_NONE
+	uint32_t Model::loadMaterialTexture(const aiMaterial* mat, aiTextureType type, const std::string& typeName, std::unordered_map<std::string, uint32_t>& textureIndices)
 	{
-		Texture* texture;
-
 		if (mat->GetTextureCount(type) < 1)
 		{
 			// no textures of this type
-			return nullptr;
+			return MODEL_FILE_NONE;
 		}
 		if (mat->GetTextureCount(type) > 1)
 		{
@@ -150,68 +388,66 @@ namespace lei3d
 		aiString str;
 		mat->GetTexture(type, 0, &str);
 
-		bool skip = false;
-		for (const auto& tex : textures) // for every texture we've loaded so far
-		{
-			if (std::strcmp(str.C_Str(), tex->path.c_str()) == 0)
-			{
-				texture = tex.get();
-				skip = true;
-			}
-		}
-
-		if (!skip)
+		// Materials of this model sharing a file share the entry. Other models get the same Texture from the AssetManager.
+		auto [index, inserted] = textureIndices.try_emplace(str.C_Str(), static_cast<uint32_t>(textures.size()));
+		if (inserted)
 		{
-			texture = new Texture();
-			texture->id = TextureFromFile(str.C_Str(), m_Directory);
-			texture->type = typeName;
-			texture->path = str.C_Str();
-			textures.emplace_back(texture);
-			texture = textures.back().get();
+			textures.push_back({ nullptr, str.C_Str(), typeName });
 		}
-
-		return texture;
+		return index->second;
 	}
 
 	/**
 	 * @brief Creates collision meshes From Model object
 	 *
-	 * Requires the Model to have loaded it's meshes. Leverages the vertices and indices of each mesh to create a
-	 * btTriangleMesh for each Mesh.
+	 * Requires the Model to have loaded it's meshes. Each btTriangleIndexVertexArray is a view of a Mesh's own
+	 * vertices and indices, so nothing gets copied.
 	 *
-	 * @return std::vector<btTriangleMesh>
+	 * @return std::vector<btTriangleIndexVertexArray*>
 	 */
-	std::vector<btTriangleMesh*>& Model::GetCollisionMeshes()
+	std::vector<btTriangleIndexVertexArray*>& Model::GetCollisionMeshes()
 	{
-		if (m_BTMeshes.empty())
+		if (m_CollisionMeshes.empty())
 		{
 			for (const Mesh& mesh : m_Meshes)
 			{
-				btTriangleMesh* curCollisionMesh = new btTriangleMesh();
+				std::span<const Vertex>		  vertices = mesh.GetVertices();
+				std::span<const unsigned int> indices = mesh.GetIndices();
 
-				std::vector<Vertex>		  vertices = mesh.vertices;
-				std::vector<unsigned int> indices = mesh.indices;
+				// Bullet only reads through these.
+				m_CollisionMeshes.push_back(new btTriangleIndexVertexArray(static_cast<int>(indices.size() / 3),
+					reinterpret_cast<int*>(const_cast<unsigned int*>(indices.data())), 3 * sizeof(unsigned int),
+					static_cast<int>(vertices.size()), const_cast<btScalar*>(&vertices.data()->Position.x), sizeof(Vertex)));
+			}
+		}
+
+		return m_CollisionMeshes;
+	}
 
-				for (int i = 0; i < indices.size(); i += 3)
+	std::vector<btBvhTriangleMeshShape*>& Model::GetCollisionShapes()
+	{
+		if (m_CollisionShapes.empty())
+		{
+			std::vector<btTriangleIndexVertexArray*>& meshes = GetCollisionMeshes();
+			for (uint32_t i = 0; i < meshes.size(); i++)
+			{
+				// Cooked BVHs just need fixing up in place, the rest get built here.
+				btOptimizedBvh*			bvh = m_CookedFile.IsOpen() ? m_CookedFile.LoadBvh(i) : nullptr;
+				btBvhTriangleMeshShape* shape = new btBvhTriangleMeshShape(meshes[i], true, bvh == nullptr);
+				if (bvh)
 				{
-					glm::vec3 vert1 = vertices[indices[i]].Position;
-					btVector3 bvert1(vert1.x, vert1.y, vert1.z);
-					glm::vec3 vert2 = vertices[indices[i + 1]].Position;
-					btVector3 bvert2(vert2.x, vert2.y, vert2.z);
-					glm::vec3 vert3 = vertices[indices[i + 2]].Position;
-					btVector3 bvert3(vert3.x, vert3.y, vert3.z);
-
-					curCollisionMesh->addTriangle(bvert1, bvert2, bvert3);
+					shape->setOptimizedBvh(bvh);
 				}
-				m_BTMeshes.push_back(curCollisionMesh);
+				m_CollisionShapes.push_back(shape);
 			}
 		}
 
-		return m_BTMeshes;
+		return m_CollisionShapes;
 	}
 
-	void Model::loadMaterials(const aiScene* scene)
+	void Model::loadMaterials(const aiScene* scene, std::vector<MaterialTextures>& materialTextures)
 	{
+		std::unordered_map<std::string, uint32_t> textureIndices;
 		for (size_t i = 0; i < scene->mNumMaterials; i++)
 		{
 			const aiMaterial* aimaterial = scene->mMaterials[i];
@@ -240,64 +476,18 @@ namespace lei3d
 				}
 			}
 
-			newMaterial->m_AlbedoTexture = loadMaterialTexture(aimaterial, aiTextureType_DIFFUSE, "texture_diffuse");
-			newMaterial->m_MetallicTexture = loadMaterialTexture(aimaterial, aiTextureType_METALNESS, "texture_metallic");
-			newMaterial->m_RoughnessTexture = loadMaterialTexture(aimaterial, aiTextureType_DIFFUSE_ROUGHNESS, "texture_roughness");
-			newMaterial->m_AmbientTexture = loadMaterialTexture(aimaterial, aiTextureType_AMBIENT_OCCLUSION, "texture_ao");
+			// The Texture pointers are set by bindTextures, once the textures are loaded.
+			MaterialTextures& slots = materialTextures.emplace_back();
+			slots[MODEL_TEXTURE_ALBEDO] = loadMaterialTexture(aimaterial, aiTextureType_DIFFUSE, "texture_diffuse", textureIndices);
+			slots[MODEL_TEXTURE_METALLIC] = loadMaterialTexture(aimaterial, aiTextureType_METALNESS, "texture_metallic", textureIndices);
+			slots[MODEL_TEXTURE_ROUGHNESS] = loadMaterialTexture(aimaterial, aiTextureType_DIFFUSE_ROUGHNESS, "texture_roughness", textureIndices);
+			slots[MODEL_TEXTURE_AMBIENT] = loadMaterialTexture(aimaterial, aiTextureType_AMBIENT_OCCLUSION, "texture_ao", textureIndices);
 
-			newMaterial->m_NormalMap = loadMaterialTexture(aimaterial, aiTextureType_NORMALS, "texture_normal");
-			newMaterial->m_BumpMap = loadMaterialTexture(aimaterial, aiTextureType_HEIGHT, "texture_bump");
-
-			newMaterial->m_UseAlbedoMap = newMaterial->m_AlbedoTexture != nullptr;
-			newMaterial->m_UseMetallicMap = newMaterial->m_MetallicTexture != nullptr;
-			newMaterial->m_UseRoughnessMap = newMaterial->m_RoughnessTexture != nullptr;
-			newMaterial->m_UseAmbientMap = newMaterial->m_AmbientTexture != nullptr;
-			newMaterial->m_UseNormalMap = newMaterial->m_NormalMap != nullptr;
-			newMaterial->m_UseBumpMap = newMaterial->m_BumpMap != nullptr;
+			slots[MODEL_TEXTURE_NORMAL] = loadMaterialTexture(aimaterial, aiTextureType_NORMALS, "texture_normal", textureIndices);
+			slots[MODEL_TEXTURE_BUMP] = loadMaterialTexture(aimaterial, aiTextureType_HEIGHT, "texture_bump", textureIndices);
 
 			materials.emplace_back(newMaterial);
 		}
 	}
 
-	// from https://learnopengl.com/code_viewer_gh.php?code=includes/learnopengl/model.h
-	unsigned int TextureFromFile(const char* path, const std::string& directory, bool gamma)
-	{
-		std::string filename = std::string(path);
-		filename = directory + '/' + filename;
-
-		unsigned int textureID;
-		glGenTextures(1, &textureID);
-
-		int			   width, height, nrComponents;
-		unsigned char* data = stbi_load(filename.c_str(), &width, &height, &nrComponents, 0);
-		if (data)
-		{
-			GLenum format;
-			if (nrComponents == 1)
-				format = GL_RED;
-			else if (nrComponents == 3)
-				format = GL_RGB;
-			else if (nrComponents == 4)
-				format = GL_RGBA;
-
-			glBindTexture(GL_TEXTURE_2D, textureID);
-			glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-			glGenerateMipmap(GL_TEXTURE_2D);
-
-			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-			stbi_image_free(data);
-		}
-		else
-		{
-			LEI_WARN("Texture failed to load at path: " + std::string(path));
-			stbi_image_free(data);
-		}
-
-		return textureID;
-	}
-
 } // namespace lei3d
\ No newline at end of file
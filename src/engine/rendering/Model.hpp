@@ -3,54 +3,130 @@
 #include <assimp/postprocess.h>
 #include <assimp/scene.h>
 
+#include <array>
 #include <assimp/Importer.hpp>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #ifndef STB_IMAGE_IMPLEMENTATION
 	#include <stb_image.h>
 #endif
 
-#include "BulletCollision/CollisionShapes/btTriangleMesh.h"
+#include "BulletCollision/CollisionShapes/btBvhTriangleMeshShape.h"
+#include "BulletCollision/CollisionShapes/btTriangleIndexVertexArray.h"
+#include "core/AssetManager.hpp"
 #include "logging/Log.hpp"
 #include "rendering/Mesh.hpp"
+#include "rendering/MeshOptimizer.hpp"
+#include "rendering/ModelFile.hpp"
 #include "rendering/Shader.hpp"
 
 namespace lei3d
 {
 
 	class Component;
+	class JobSystem;
+	struct JobCounter;
 
+	enum ModelLoadFlags : uint32_t
+	{
+		MODEL_LOAD_DEFAULT = 0,
+		MODEL_LOAD_IMPORT = 1 << 0,		 // Import the source with Assimp even if there's a cooked twin.
+		MODEL_LOAD_NO_TEXTURES = 1 << 1, // Don't decode the textures, e.g. for cooking.
+		MODEL_LOAD_NO_CACHE = 1 << 2,	 // Load the textures just for this model instead of sharing them through the AssetManager.
+		MODEL_LOAD_NO_OPTIMIZE = 1 << 3, // Keep the imported meshes in Assimp's order instead of running OptimizeMesh on them.
+	};
+
+	// One of the texture files a model uses.
+	struct ModelTexture
+	{
+		AssetHandle<Texture> texture; // Usually shared with every other model using the same file.
+		std::string			 path;	  // Relative to the model's directory, as the model file names it.
+		std::string			 type;	  // e.g. "texture_diffuse".
+	};
+
+	/*
+	 * Loading is split in two so the slow part can happen on a loading thread:
+	 * the constructor parses the file, builds the meshes and decodes the textures without touching OpenGL,
+	 * and Upload (main thread) creates the GL buffers and textures from that.
+	 * Given a JobSystem, the constructor converts the meshes and decodes the textures as jobs (one per mesh, one per
+	 * texture), so only Assimp's import itself and Upload stay serial.
+	 * Imported meshes are also welded and reordered for the vertex cache in their job (see OptimizeMesh), which is
+	 * what cooking stores too.
+	 * Textures come from the AssetManager, so a file used by several models is only decoded and uploaded once.
+	 *
+	 * If lei3d_cook has cooked the model (see ModelFile), the constructor maps that instead of importing the source,
+	 * and the meshes point straight into the mapping. Sources without an up to date cooked twin fall back to Assimp.
+	 */
 	class Model
 	{
 	private:
+		// For each material, the index into textures of each ModelTextureSlot, or MODEL_FILE_NONE. Only while loading.
+		using MaterialTextures = std::array<uint32_t, MODEL_TEXTURE_SLOT_COUNT>;
+
 		// model data
-		std::vector<Mesh>	 m_Meshes;
-		std::string			 m_Directory;
-		std::vector<Texture> m_TexturesLoaded;
+		std::vector<Mesh> m_Meshes;
+		std::string		  m_Directory;
+		bool			  m_Uploaded = false;
+		bool			  m_DecodeTextures = true;
+		bool			  m_CacheTextures = true;
+		bool			  m_Optimize = true;
+		size_t			  m_GpuBytes = 0; // Counted by Upload. Shared textures are the AssetManager's, not counted here.
+		glm::vec3		  m_BoundsMin = glm::vec3(0.0f);
+		glm::vec3		  m_BoundsMax = glm::vec3(0.0f);
+
+		MeshOptimizationStats m_OptimizationStats; // All meshes together. Cooked models have the ones from cooking.
 
-		std::vector<btTriangleMesh*> m_BTMeshes; // NEED TO DEALLOCATE THIS IN DESTRUCTOR!
+		ModelFile m_CookedFile; // Open for the model's lifetime if it was cooked, the meshes and BVHs live in it.
+
+		// Bullet's view of the meshes' own vertex and index data (no copies), deleted in the destructor.
+		std::vector<btTriangleIndexVertexArray*> m_CollisionMeshes;
+		std::vector<btBvhTriangleMeshShape*>	 m_CollisionShapes; // One per entry of m_CollisionMeshes. Also deleted in the destructor.
 
 	public:
-		std::vector<std::unique_ptr<Texture>>  textures;
+		std::vector<ModelTexture>			   textures;
 		std::vector<std::unique_ptr<Material>> materials;
 
-		Model(const std::string& modelPath);
+		// No GL calls, so any thread. flags are ModelLoadFlags. Without jobs everything runs on the calling thread.
+		Model(const std::string& modelPath, uint32_t flags = MODEL_LOAD_DEFAULT, JobSystem* jobs = nullptr);
 		~Model();
 
+		void Upload(); // Main thread only. Draw does it if nobody did, but that stalls whatever frame it happens in.
+		bool IsUploaded() const;
+
 		void Draw(Shader& shader, RenderFlag flags, uint32_t bindLocation);
 
-		std::vector<btTriangleMesh*>& GetCollisionMeshes();
+		const std::vector<Mesh>& GetMeshes() const { return m_Meshes; }
+		const glm::vec3&		 GetBoundsMin() const { return m_BoundsMin; }
+		const glm::vec3&		 GetBoundsMax() const { return m_BoundsMax; }
+		bool					 IsCooked() const { return m_CookedFile.IsOpen(); }
+
+		// What OptimizeMesh did to the meshes when importing, or when lei3d_cook imported them for cooked models.
+		const MeshOptimizationStats& GetOptimizationStats() const { return m_OptimizationStats; }
+
+		std::vector<btTriangleIndexVertexArray*>& GetCollisionMeshes();
+
+		/*
+		 * Unscaled BVH shapes of the collision meshes, for StaticCollider to share between all its instances.
+		 * Building the BVH is the slow part of setting up a collider, so it's done once per model, on whatever
+		 * thread calls this first (cooked models load it from the file instead). Not thread safe itself.
+		 */
+		std::vector<btBvhTriangleMeshShape*>& GetCollisionShapes();
+
+		// Memory held by the model, for AssetManager's budget and stats. The collision part is an estimate.
+		size_t GetCpuBytes() const;
+		size_t GetGpuBytes() const;
 
 	private:
-		void					 loadMaterials(const aiScene* scene);
-		void					 loadModel(const std::string& path);
-		void					 processNode(aiNode* node, const aiScene* scene);
-		Mesh					 processMesh(aiMesh* mesh, const aiScene* scene);
-		Texture* loadMaterialTexture(const aiMaterial* mat, aiTextureType type, const std::string& typeName);
+		bool	 loadCooked(const std::string& path, std::vector<MaterialTextures>& materialTextures);
+		void	 loadMaterials(const aiScene* scene, std::vector<MaterialTextures>& materialTextures);
+		void	 loadModel(const std::string& path, JobSystem* jobs, std::vector<MaterialTextures>& materialTextures);
+		void	 loadTextures(JobSystem* jobs, JobCounter& counter);
+		void	 bindTextures(const std::vector<MaterialTextures>& materialTextures);
+		void	 collectMeshes(const aiNode* node, const aiScene* scene, std::vector<const aiMesh*>& meshes);
+		void	 processMesh(const aiMesh* mesh, std::vector<Vertex>& vertices, std::vector<unsigned int>& indices);
+		uint32_t loadMaterialTexture(const aiMaterial* mat, aiTextureType type, const std::string& typeName, std::unordered_map<std::string, uint32_t>& textureIndices);
 	};
 
-	// TODO: Use Abstract Texture in "Texture.cpp"
-	unsigned int TextureFromFile(const char* path, const std::string& directory, bool gamma = false);
-
 } // namespace lei3d
\ No newline at end of file
@@ -0,0 +1,364 @@
+#include "ModelFile.hpp"
+
+#include "logging/Log.hpp"
+#include "rendering/MeshOptimizer.hpp"
+#include "rendering/Model.hpp"
+
+#include "BulletCollision/CollisionShapes/btOptimizedBvh.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <unordered_map>
+#include <vector>
+
+namespace lei3d
+{
+	static_assert(sizeof(ModelFileTexture) == 16, "Model file records must not change size without bumping MODEL_FILE_VERSION");
+	static_assert(sizeof(ModelFileMaterial) == 48, "Model file records must not change size without bumping MODEL_FILE_VERSION");
+	static_assert(sizeof(ModelFileMesh) == 64, "Model file records must not change size without bumping MODEL_FILE_VERSION");
+	static_assert(sizeof(ModelFileHeader) == 152, "Model file records must not change size without bumping MODEL_FILE_VERSION");
+	static_assert(sizeof(Vertex) == 44, "Cooked vertex data is Vertex as is, changing it needs a MODEL_FILE_VERSION bump");
+
+	namespace
+	{
+		// Bullet wants in-place BVHs 16 byte aligned. Everything else gets 8.
+		constexpr size_t BVH_ALIGNMENT = 16;
+
+		// Like the scene file writer, but the offsets stay offsets.
+		class ModelFileWriter
+		{
+		private:
+			std::vector<char> m_Data;
+
+		public:
+			uint64_t Reserve(size_t size, size_t alignment = 8)
+			{
+				const uint64_t offset = (m_Data.size() + alignment - 1) & ~uint64_t(alignment - 1);
+				m_Data.resize(offset + size);
+				return offset;
+			}
+
+			template <typename T>
+			T& At(uint64_t offset)
+			{
+				return *reinterpret_cast<T*>(m_Data.data() + offset);
+			}
+
+			char* Data(uint64_t offset) { return m_Data.data() + offset; }
+
+			uint64_t Write(const void* data, size_t size, size_t alignment = 8)
+			{
+				const uint64_t offset = Reserve(size, alignment);
+				std::memcpy(m_Data.data() + offset, data, size);
+				return offset;
+			}
+
+			uint64_t WriteString(const std::string& str) { return Write(str.c_str(), str.size() + 1, 1); }
+
+			const std::vector<char>& Finish()
+			{
+				At<ModelFileHeader>(0).fileSize = m_Data.size();
+				return m_Data;
+			}
+		};
+
+		bool inFile(uint64_t offset, uint64_t count, size_t elementSize, size_t fileSize)
+		{
+			return offset <= fileSize && count <= (fileSize - offset) / elementSize;
+		}
+	} // namespace
+
+	Texture*& MaterialTextureSlot(Material& material, ModelTextureSlot slot)
+	{
+		switch (slot)
+		{
+			case MODEL_TEXTURE_METALLIC:
+				return material.m_MetallicTexture;
+			case MODEL_TEXTURE_ROUGHNESS:
+				return material.m_RoughnessTexture;
+			case MODEL_TEXTURE_AMBIENT:
+				return material.m_AmbientTexture;
+			case MODEL_TEXTURE_NORMAL:
+				return material.m_NormalMap;
+			case MODEL_TEXTURE_BUMP:
+				return material.m_BumpMap;
+			case MODEL_TEXTURE_ALBEDO:
+			default:
+				return material.m_AlbedoTexture;
+		}
+	}
+
+	bool ModelFile::Open(const std::string& path)
+	{
+		Close();
+
+		if (!m_File.Open(path))
+		{
+			return false;
+		}
+
+		const size_t		   size = m_File.Size();
+		const ModelFileHeader* header = reinterpret_cast<const ModelFileHeader*>(m_File.Data());
+		if (size < sizeof(ModelFileHeader) || header->magic != MODEL_FILE_MAGIC)
+		{
+			LEI_ERROR("{0} is not a cooked model", path);
+			m_File.Close();
+			return false;
+		}
+		if (header->version != MODEL_FILE_VERSION)
+		{
+			LEI_ERROR("{0} is model file version {1}, but this build reads version {2}", path, header->version, MODEL_FILE_VERSION);
+			m_File.Close();
+			return false;
+		}
+
+		// Everything the tables point at has to be inside the file, so nothing later has to check.
+		bool valid = header->fileSize == size
+			&& inFile(header->meshes, header->meshCount, sizeof(ModelFileMesh), size)
+			&& inFile(header->materials, header->materialCount, sizeof(ModelFileMaterial), size)
+			&& inFile(header->textures, header->textureCount, sizeof(ModelFileTexture), size);
+
+		const char* base = m_File.Data();
+		for (uint32_t i = 0; valid && i < header->meshCount; i++)
+		{
+			const ModelFileMesh& mesh = reinterpret_cast<const ModelFileMesh*>(base + header->meshes)[i];
+			valid = inFile(mesh.vertices, mesh.vertexCount, sizeof(Vertex), size) && mesh.vertices % alignof(Vertex) == 0
+				&& inFile(mesh.indices, mesh.indexCount, sizeof(uint32_t), size) && mesh.indices % alignof(uint32_t) == 0
+				&& inFile(mesh.bvh, mesh.bvhSize, 1, size) && mesh.bvh % BVH_ALIGNMENT == 0
+				&& (mesh.material == MODEL_FILE_NONE || mesh.material < header->materialCount);
+		}
+		for (uint32_t i = 0; valid && i < header->materialCount; i++)
+		{
+			const ModelFileMaterial& material = reinterpret_cast<const ModelFileMaterial*>(base + header->materials)[i];
+			for (uint32_t texture : material.textures)
+			{
+				valid = valid && (texture == MODEL_FILE_NONE || texture < header->textureCount);
+			}
+		}
+		for (uint32_t i = 0; valid && i < header->textureCount; i++)
+		{
+			const ModelFileTexture& texture = reinterpret_cast<const ModelFileTexture*>(base + header->textures)[i];
+			valid = texture.path < size && texture.type < size && std::memchr(base + texture.path, '\0', size - texture.path)
+				&& std::memchr(base + texture.type, '\0', size - texture.type);
+		}
+
+		if (!valid)
+		{
+			LEI_ERROR("{0} is truncated or corrupted", path);
+			m_File.Close();
+			return false;
+		}
+
+		m_Header = header;
+		return true;
+	}
+
+	void ModelFile::Close()
+	{
+		m_Header = nullptr;
+		m_File.Close();
+	}
+
+	bool ModelFile::IsSourceUnchanged(const std::string& sourcePath) const
+	{
+		if (CheckSourceStamp(sourcePath, m_Header->source) == SOURCE_CHANGED)
+		{
+			LEI_WARN("{0} changed since it was cooked. Run lei3d_cook to update it.", sourcePath);
+			return false;
+		}
+		return true;
+	}
+
+	bool ModelFile::IsUpToDate(const std::string& sourcePath, const std::string& cookedPath)
+	{
+		std::error_code error;
+		if (!std::filesystem::exists(cookedPath, error))
+		{
+			return false;
+		}
+
+		ModelFile file;
+		if (!file.Open(cookedPath))
+		{
+			return false;
+		}
+
+		SourceStamp		  stamp;
+		const SourceState state = CheckSourceStamp(sourcePath, file.GetHeader().source, &stamp);
+		file.Close();
+		if (state == SOURCE_TOUCHED)
+		{
+			std::fstream fileStream(cookedPath, std::fstream::binary | std::fstream::in | std::fstream::out);
+			fileStream.seekp(offsetof(ModelFileHeader, source));
+			fileStream.write(reinterpret_cast<const char*>(&stamp), sizeof(stamp));
+		}
+		return state != SOURCE_CHANGED;
+	}
+
+	MeshOptimizationStats ModelFile::GetOptimizationStats() const
+	{
+		MeshOptimizationStats stats;
+		stats.triangles = m_Header->triangles;
+		stats.verticesBefore = m_Header->verticesBefore;
+		stats.verticesAfter = m_Header->verticesAfter;
+		stats.transformsBefore = m_Header->transformsBefore;
+		stats.transformsAfter = m_Header->transformsAfter;
+		return stats;
+	}
+
+	btOptimizedBvh* ModelFile::LoadBvh(uint32_t meshIndex)
+	{
+		const ModelFileMesh& mesh = GetMesh(meshIndex);
+		if (mesh.bvhSize == 0 || m_Header->bvhScalarSize != sizeof(btScalar) || m_Header->bvhPointerSize != sizeof(void*))
+		{
+			return nullptr;
+		}
+
+		return btOptimizedBvh::deSerializeInPlace(m_File.Data() + mesh.bvh, mesh.bvhSize, false);
+	}
+
+	std::string ModelFile::GetCookedPath(const std::string& sourcePath)
+	{
+		return sourcePath + ".lmesh";
+	}
+
+	bool ModelFile::IsModelSource(const std::string& path)
+	{
+		static const std::vector<std::string> extensions = { ".obj", ".gltf", ".glb", ".fbx", ".dae" };
+
+		const size_t dot = path.find_last_of('.');
+		if (dot == std::string::npos)
+		{
+			return false;
+		}
+
+		std::string extension = path.substr(dot);
+		std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return std::tolower(c); });
+		return std::find(extensions.begin(), extensions.end(), extension) != extensions.end();
+	}
+
+	bool ModelFile::Cook(const std::string& sourcePath, const std::string& cookedPath, JobSystem* jobs)
+	{
+		SourceStamp stamp;
+		if (!MakeSourceStamp(sourcePath, stamp))
+		{
+			return false;
+		}
+
+		// Textures stay separate files, only their paths are needed.
+		Model model(sourcePath, MODEL_LOAD_IMPORT | MODEL_LOAD_NO_TEXTURES, jobs);
+		if (model.GetMeshes().empty())
+		{
+			LEI_ERROR("{0} has no meshes to cook", sourcePath);
+			return false;
+		}
+
+		const std::vector<Mesh>&			  meshes = model.GetMeshes();
+		std::vector<btBvhTriangleMeshShape*>& shapes = model.GetCollisionShapes();
+
+		ModelFileWriter writer;
+		const uint64_t	headerOffset = writer.Reserve(sizeof(ModelFileHeader));
+		{
+			ModelFileHeader& header = writer.At<ModelFileHeader>(headerOffset);
+			header.magic = MODEL_FILE_MAGIC;
+			header.version = MODEL_FILE_VERSION;
+			header.meshCount = static_cast<uint32_t>(meshes.size());
+			header.materialCount = static_cast<uint32_t>(model.materials.size());
+			header.textureCount = static_cast<uint32_t>(model.textures.size());
+			header.bvhScalarSize = sizeof(btScalar);
+			header.bvhPointerSize = sizeof(void*);
+			std::memcpy(header.boundsMin, &model.GetBoundsMin(), sizeof(header.boundsMin));
+			std::memcpy(header.boundsMax, &model.GetBoundsMax(), sizeof(header.boundsMax));
+			header.source = stamp;
+
+			const MeshOptimizationStats& stats = model.GetOptimizationStats();
+			header.triangles = stats.triangles;
+			header.verticesBefore = stats.verticesBefore;
+			header.verticesAfter = stats.verticesAfter;
+			header.transformsBefore = stats.transformsBefore;
+			header.transformsAfter = stats.transformsAfter;
+		}
+
+		std::unordered_map<const Texture*, uint32_t> textureIndices;
+		const uint64_t								 texturesOffset = writer.Reserve(model.textures.size() * sizeof(ModelFileTexture));
+		writer.At<ModelFileHeader>(headerOffset).textures = texturesOffset;
+		for (uint32_t i = 0; i < model.textures.size(); i++)
+		{
+			const ModelTexture& texture = model.textures[i];
+			textureIndices[texture.texture.get()] = i;
+
+			const uint64_t pathOffset = writer.WriteString(texture.path);
+			const uint64_t typeOffset = writer.WriteString(texture.type);
+			ModelFileTexture& record = writer.At<ModelFileTexture>(texturesOffset + i * sizeof(ModelFileTexture));
+			record.path = pathOffset;
+			record.type = typeOffset;
+		}
+
+		std::unordered_map<const Material*, uint32_t> materialIndices;
+		const uint64_t								  materialsOffset = writer.Reserve(model.materials.size() * sizeof(ModelFileMaterial));
+		writer.At<ModelFileHeader>(headerOffset).materials = materialsOffset;
+		for (uint32_t i = 0; i < model.materials.size(); i++)
+		{
+			Material& material = *model.materials[i];
+			materialIndices[&material] = i;
+
+			ModelFileMaterial& record = writer.At<ModelFileMaterial>(materialsOffset + i * sizeof(ModelFileMaterial));
+			std::memcpy(record.albedo, &material.m_Albedo, sizeof(record.albedo));
+			record.metallic = material.m_Metallic;
+			record.roughness = material.m_Roughness;
+			for (uint32_t slot = 0; slot < MODEL_TEXTURE_SLOT_COUNT; slot++)
+			{
+				const Texture* texture = MaterialTextureSlot(material, static_cast<ModelTextureSlot>(slot));
+				record.textures[slot] = texture ? textureIndices.at(texture) : MODEL_FILE_NONE;
+			}
+		}
+
+		const uint64_t meshesOffset = writer.Reserve(meshes.size() * sizeof(ModelFileMesh));
+		writer.At<ModelFileHeader>(headerOffset).meshes = meshesOffset;
+		for (uint32_t i = 0; i < meshes.size(); i++)
+		{
+			const Mesh&	   mesh = meshes[i];
+			const uint64_t verticesOffset = writer.Write(mesh.GetVertices().data(), mesh.GetVertices().size_bytes());
+			const uint64_t indicesOffset = writer.Write(mesh.GetIndices().data(), mesh.GetIndices().size_bytes());
+
+			// Serialized straight into the file buffer, which is where Bullet wants to find it again.
+			btOptimizedBvh* bvh = shapes[i]->getOptimizedBvh();
+			const unsigned	bvhSize = bvh ? bvh->calculateSerializeBufferSize() : 0;
+			const uint64_t	bvhOffset = bvhSize ? writer.Reserve(bvhSize, BVH_ALIGNMENT) : 0;
+			if (bvh && !bvh->serializeInPlace(writer.Data(bvhOffset), bvhSize, false))
+			{
+				LEI_ERROR("Failed to serialize the collision BVH of {0} mesh {1}", sourcePath, i);
+				return false;
+			}
+
+			ModelFileMesh& record = writer.At<ModelFileMesh>(meshesOffset + i * sizeof(ModelFileMesh));
+			record.vertices = verticesOffset;
+			record.indices = indicesOffset;
+			record.bvh = bvhOffset;
+			record.vertexCount = static_cast<uint32_t>(mesh.GetVertices().size());
+			record.indexCount = static_cast<uint32_t>(mesh.GetIndices().size());
+			record.bvhSize = bvhSize;
+			record.material = mesh.material ? materialIndices.at(mesh.material) : MODEL_FILE_NONE;
+
+			glm::vec3 boundsMin, boundsMax;
+			mesh.GetBounds(boundsMin, boundsMax);
+			std::memcpy(record.boundsMin, &boundsMin, sizeof(record.boundsMin));
+			std::memcpy(record.boundsMax, &boundsMax, sizeof(record.boundsMax));
+		}
+
+		const std::vector<char>& data = writer.Finish();
+
+		std::ofstream fileStream(cookedPath, std::ofstream::binary | std::ofstream::trunc);
+		fileStream.write(data.data(), static_cast<std::streamsize>(data.size()));
+		if (!fileStream.good())
+		{
+			LEI_ERROR("Failed to write cooked model {0}", cookedPath);
+			return false;
+		}
+		return true;
+	}
+} // namespace lei3d
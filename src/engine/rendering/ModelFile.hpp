@@ -0,0 +1,158 @@
+#pragma once
+
+#include "core/MappedFile.hpp"
+#include "core/SourceStamp.hpp"
+
+#include <cstdint>
+#include <string>
+
+class btOptimizedBvh;
+
+namespace lei3d
+{
+	class JobSystem;
+	struct MeshOptimizationStats;
+	class Material;
+	class Texture;
+
+	/*
+	 * Cooked models:
+	 * lei3d_cook imports a source model (obj, gltf, fbx, ...) with Assimp once and writes a binary twin next to it
+	 * (backpack.obj -> backpack.obj.lmesh). Model maps that file and hands its vertex and index blobs straight to the
+	 * GPU, so at runtime there's no importing, post-processing or converting into Vertex arrays left to do. The meshes
+	 * are stored already welded and reordered (see OptimizeMesh), and the header keeps the vertex cache stats from that.
+	 *
+	 * Everything is stored as offsets from the start of the file (there are few enough that relocating isn't worth
+	 * it): a header, a table of meshes, materials and textures, then the data. Vertex data is the Vertex struct as is.
+	 *
+	 * Each mesh can also have its collision BVH, in Bullet's in-place serialization format. That format depends on
+	 * btScalar and the pointer size, so the header records both and Model rebuilds the BVH if they don't match.
+	 */
+
+	static constexpr uint32_t MODEL_FILE_MAGIC = 0x48534D4C; // "LMSH"
+	static constexpr uint32_t MODEL_FILE_VERSION = 3;
+	static constexpr uint32_t MODEL_FILE_NONE = UINT32_MAX; // For texture and material indices.
+
+	// The texture slots of a Material, in the order ModelFileMaterial stores them.
+	enum ModelTextureSlot : uint32_t
+	{
+		MODEL_TEXTURE_ALBEDO,
+		MODEL_TEXTURE_METALLIC,
+		MODEL_TEXTURE_ROUGHNESS,
+		MODEL_TEXTURE_AMBIENT,
+		MODEL_TEXTURE_NORMAL,
+		MODEL_TEXTURE_BUMP,
+		MODEL_TEXTURE_SLOT_COUNT
+	};
+
+	// The Material member for a slot.
+	Texture*& MaterialTextureSlot(Material& material, ModelTextureSlot slot);
+
+	// All records only hold fixed size fields, ordered so there is no implicit padding.
+	struct ModelFileTexture
+	{
+		uint64_t path; // Offset of a null terminated string, relative to the model's directory.
+		uint64_t type; // Offset of a null terminated string, e.g. "texture_diffuse".
+	};
+
+	struct ModelFileMaterial
+	{
+		float	 albedo[3];
+		float	 metallic;
+		float	 roughness;
+		uint32_t textures[MODEL_TEXTURE_SLOT_COUNT]; // Index into the textures, or MODEL_FILE_NONE.
+		uint32_t padding;
+	};
+
+	struct ModelFileMesh
+	{
+		uint64_t vertices; // Offset of vertexCount Vertex.
+		uint64_t indices;  // Offset of indexCount uint32_t.
+		uint64_t bvh;	   // Offset of the serialized btOptimizedBvh (16 byte aligned), 0 if there is none.
+		uint32_t vertexCount;
+		uint32_t indexCount;
+		uint32_t bvhSize;
+		uint32_t material; // Index into the materials, or MODEL_FILE_NONE.
+		float	 boundsMin[3];
+		float	 boundsMax[3];
+	};
+
+	struct ModelFileHeader
+	{
+		uint32_t	magic;
+		uint32_t	version;
+		uint64_t	fileSize;
+		uint32_t	meshCount;
+		uint32_t	materialCount;
+		uint32_t	textureCount;
+		uint32_t	bvhScalarSize;	// sizeof(btScalar) the BVHs were cooked with.
+		uint32_t	bvhPointerSize; // sizeof(void*) the BVHs were cooked with.
+		uint32_t	padding;
+		float		boundsMin[3];
+		float		boundsMax[3];
+		uint64_t	meshes;	   // Offset of meshCount ModelFileMesh.
+		uint64_t	materials; // Offset of materialCount ModelFileMaterial.
+		uint64_t	textures;  // Offset of textureCount ModelFileTexture.
+		SourceStamp source;	   // Of the model it was cooked from.
+
+		// What OptimizeMesh did to all the meshes together, see MeshOptimizationStats.
+		uint64_t	triangles;
+		uint64_t	verticesBefore;
+		uint64_t	verticesAfter;
+		uint64_t	transformsBefore;
+		uint64_t	transformsAfter;
+	};
+
+	class ModelFile
+	{
+	private:
+		MappedFile			   m_File;
+		const ModelFileHeader* m_Header = nullptr;
+
+	public:
+		// Maps a cooked model and checks that everything it points to is inside the file. Returns false (and logs why) if it isn't valid.
+		bool Open(const std::string& path);
+		void Close();
+
+		bool				   IsOpen() const { return m_Header != nullptr; }
+		const ModelFileHeader& GetHeader() const { return *m_Header; }
+
+		// Whether the model it was cooked from is still the same. Logs why not if it isn't.
+		bool IsSourceUnchanged(const std::string& sourcePath) const;
+
+		MeshOptimizationStats GetOptimizationStats() const; // As recorded when cooking.
+
+		const ModelFileMesh&	 GetMesh(uint32_t i) const { return At<ModelFileMesh>(m_Header->meshes)[i]; }
+		const ModelFileMaterial& GetMaterial(uint32_t i) const { return At<ModelFileMaterial>(m_Header->materials)[i]; }
+		const ModelFileTexture&	 GetTexture(uint32_t i) const { return At<ModelFileTexture>(m_Header->textures)[i]; }
+		const char*				 GetString(uint64_t offset) const { return At<char>(offset); }
+
+		template <typename T>
+		const T* At(uint64_t offset) const
+		{
+			return reinterpret_cast<const T*>(m_File.Data() + offset);
+		}
+
+		/*
+		 * Turns the mesh's cooked BVH into a btOptimizedBvh that lives in the mapping (Bullet fixes it up in place, the
+		 * mapping being copy-on-write makes that fine). Call once per mesh, and keep the file open as long as the BVH is
+		 * used. nullptr if the mesh has none, or it was cooked for a different btScalar or pointer size.
+		 */
+		btOptimizedBvh* LoadBvh(uint32_t meshIndex);
+
+		// Where the cooked twin of a source model goes.
+		static std::string GetCookedPath(const std::string& sourcePath);
+
+		/*
+		 * For lei3d_cook: whether the cooked twin exists and is up to date. If the source was only touched (e.g. copied),
+		 * its recorded modification time is updated, so loading can tell without hashing the source again.
+		 */
+		static bool IsUpToDate(const std::string& sourcePath, const std::string& cookedPath);
+
+		// Whether path is a model format Assimp imports for us (by extension).
+		static bool IsModelSource(const std::string& path);
+
+		// Imports a source model with Assimp and writes its cooked twin. Returns false (and logs why) on failure.
+		static bool Cook(const std::string& sourcePath, const std::string& cookedPath, JobSystem* jobs = nullptr);
+	};
+} // namespace lei3d
@@ -4,6 +4,12 @@
 
 namespace lei3d
 {
+	// Set for every primitive drawn, so hash them at compile time.
+	static constexpr StringId PROJ = "u_Proj"_sid;
+	static constexpr StringId VIEW = "u_View"_sid;
+	static constexpr StringId MODEL = "u_Model"_sid;
+	static constexpr StringId COLOR = "u_Color"_sid;
+
 	PrimitiveRenderer::PrimitiveRenderer()
 	{
 	}
@@ -53,13 +59,13 @@ namespace lei3d
 	void PrimitiveRenderer::drawAll(Camera& camera)
 	{
 		m_PrimitiveShader.bind();
-		m_PrimitiveShader.setUniformMat4("u_Proj", camera.GetProj());
-		m_PrimitiveShader.setUniformMat4("u_View", camera.GetView());
-		m_PrimitiveShader.setUniformMat4("u_Model", glm::identity<glm::mat4>());
+		m_PrimitiveShader.setUniformMat4(PROJ, camera.GetProj());
+		m_PrimitiveShader.setUniformMat4(VIEW, camera.GetView());
+		m_PrimitiveShader.setUniformMat4(MODEL, glm::identity<glm::mat4>());
 		while (!m_DrawCalls.empty())
 		{
 			DrawData& data = m_DrawCalls.front();
-			m_PrimitiveShader.setVec3("u_Color", data.u_Color);
+			m_PrimitiveShader.setVec3(COLOR, data.u_Color);
 			draw(*data.m_VAO, *data.m_IBO);
 			m_DrawCalls.pop();
 		}
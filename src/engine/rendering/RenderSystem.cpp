@@ -1,14 +1,43 @@
 #include "RenderSystem.hpp"
 
+#include "core/Application.hpp"
+
 #include "components/ModelInstance.hpp"
 #include "components/SkyBox.hpp"
 #include "logging/GLDebug.hpp"
+#include "rendering/TextureResidency.hpp"
 
 #include "glm/gtc/type_ptr.hpp"
 #include <array>
 
 namespace lei3d
 {
+	// Set every frame, so hash them at compile time.
+	static constexpr StringId PROJECTION = "projection"_sid;
+	static constexpr StringId VIEW = "view"_sid;
+	static constexpr StringId MODEL = "model"_sid;
+	static constexpr StringId CAM_POS = "camPos"_sid;
+	static constexpr StringId DIR_LIGHT_DIRECTION = "dirLight.direction"_sid;
+	static constexpr StringId DIR_LIGHT_COLOR = "dirLight.color"_sid;
+	static constexpr StringId DIR_LIGHT_INTENSITY = "dirLight.intensity"_sid;
+	static constexpr StringId DIR_LIGHT_FAR_PLANE = "dirLight.farPlane"_sid;
+	static constexpr StringId SHADOW_DEPTH = "shadowDepth"_sid;
+	static constexpr StringId SKYBOX_CUBEMAP = "skyboxCubemap"_sid;
+	static constexpr StringId RAW_FINAL_IMAGE = "RawFinalImage"_sid;
+	static constexpr StringId SATURATION_MASK = "SaturationMask"_sid;
+
+	// Spelled out so setting the array uniforms doesn't build and hash new strings every draw.
+	static constexpr std::array<StringId, DirectionalLight::CASCADE_COUNT> CASCADE_DISTANCE_UNIFORMS = {
+		"dirLight.cascadeDistances[0]"_sid,
+		"dirLight.cascadeDistances[1]"_sid,
+		"dirLight.cascadeDistances[2]"_sid,
+	};
+	static constexpr std::array<StringId, DirectionalLight::CASCADE_COUNT + 1> LIGHT_SPACE_MATRIX_UNIFORMS = {
+		"lightSpaceMatrices[0]"_sid,
+		"lightSpaceMatrices[1]"_sid,
+		"lightSpaceMatrices[2]"_sid,
+		"lightSpaceMatrices[3]"_sid,
+	};
 
 	void RenderSystem::initialize(int width, int height)
 	{
@@ -85,7 +114,7 @@ namespace lei3d
 //		glUniformBlockBinding(forwardShader.getShaderID(), lightMatsIdx, 1);
 	}
 
-	void RenderSystem::draw(const Scene& scene, const SceneView& view)
+	void RenderSystem::draw(Scene& scene, const SceneView& view)
 	{
 		// clear the blit image
 		glBindFramebuffer(GL_DRAW_FRAMEBUFFER, FBO);
@@ -96,18 +125,17 @@ namespace lei3d
 
 		Camera& camera = view.ActiveCamera(scene);
 		SkyBox* skyBox = nullptr;
-		std::vector<ModelInstance*> modelEntities;
-		for (auto& entity : scene.m_Entities)
+		FrameVector<ModelInstance*> modelEntities(Application::GetFrameAllocator());
+		if (ComponentPool<ModelInstance>* pool = scene.GetComponentStorage().FindPool<ModelInstance>())
 		{
-			if (auto mi = entity->GetComponent<ModelInstance>())
-			{
-				modelEntities.push_back(mi);
-			}
-			if (auto sb = entity->GetComponent<SkyBox>())
-			{
-				skyBox = sb;
-			}
+			modelEntities.reserve(pool->Count());
 		}
+		scene.View<ModelInstance>().ForEach([&modelEntities](Entity&, ModelInstance& mi) {
+			modelEntities.push_back(&mi);
+		});
+		scene.View<SkyBox>().ForEach([&skyBox](Entity&, SkyBox& sb) {
+			skyBox = &sb;
+		});
 		DirectionalLight* dirLight = scene.m_DirectionalLight.get();
 
 		genShadowPass(modelEntities, dirLight, camera);
@@ -119,7 +147,7 @@ namespace lei3d
 		postprocessPass();
 	}
 
-	void RenderSystem::lightingPass(const std::vector<ModelInstance*>& objects, const DirectionalLight* light, Camera& camera)
+	void RenderSystem::lightingPass(const FrameVector<ModelInstance*>& objects, const DirectionalLight* light, Camera& camera)
 	{
 		forwardShader.bind();
 
@@ -133,34 +161,40 @@ namespace lei3d
 		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
 		glm::mat4 projection = camera.GetProj();
-		forwardShader.setUniformMat4("projection", projection);
+		forwardShader.setUniformMat4(PROJECTION, projection);
 		glm::mat4 view = camera.GetView();
-		forwardShader.setUniformMat4("view", view);
+		forwardShader.setUniformMat4(VIEW, view);
 
-		forwardShader.setVec3("camPos", camera.GetPosition());
+		forwardShader.setVec3(CAM_POS, camera.GetPosition());
 
-		forwardShader.setVec3("dirLight.direction", light->direction);
-		forwardShader.setVec3("dirLight.color", light->color);
-		forwardShader.setFloat("dirLight.intensity", light->intensity);
-		forwardShader.setFloat("dirLight.farPlane", camera.GetFarPlane());
+		forwardShader.setVec3(DIR_LIGHT_DIRECTION, light->direction);
+		forwardShader.setVec3(DIR_LIGHT_COLOR, light->color);
+		forwardShader.setFloat(DIR_LIGHT_INTENSITY, light->intensity);
+		forwardShader.setFloat(DIR_LIGHT_FAR_PLANE, camera.GetFarPlane());
 		for (int i = 0; i < light->cascadeLevels.size(); i++)
 		{
-			forwardShader.setFloat(("dirLight.cascadeDistances[" + std::to_string(i) + "]"), light->cascadeLevels[i]);
+			forwardShader.setFloat(CASCADE_DISTANCE_UNIFORMS[i], light->cascadeLevels[i]);
 		}
 //		glBindBufferBase(GL_UNIFORM_BUFFER, 1, light->lsmUBO);
 
 		for (int i = 0; i < light->lightSpaceMatrices.size(); i++)
 		{
-			forwardShader.setUniformMat4(("lightSpaceMatrices[" + std::to_string(i) + "]"), light->lightSpaceMatrices[i]);
+			forwardShader.setUniformMat4(LIGHT_SPACE_MATRIX_UNIFORMS[i], light->lightSpaceMatrices[i]);
 		}
 
-		forwardShader.setInt("shadowDepth", 1);
+		forwardShader.setInt(SHADOW_DEPTH, 1);
 		glActiveTexture(GL_TEXTURE1);
 		glBindTexture(GL_TEXTURE_2D_ARRAY, shadowDepth);
 
+		// Whatever gets drawn here tells the TextureResidency which mips of its textures are needed.
+		TextureResidency::BeginFrame(camera, scheight);
 		for (auto& obj : objects)
 		{
 			obj->Draw(&forwardShader, RenderFlag::BindImages, 2);
+			if (obj->m_Model)
+			{
+				TextureResidency::Track(*obj->m_Model, obj->GetEntity().GetInterpolatedModelMat());
+			}
 		}
 
 		glDepthMask(GL_FALSE);
@@ -172,18 +206,18 @@ namespace lei3d
 		glEnable(GL_DEPTH_TEST);
 		GLCall(glDepthFunc(GL_LEQUAL)); // we change the depth function here to it passes when testing depth value is equal
 										// to what is current stored
-		skyBox.skyboxShader.bind();
+		skyBox.skyboxShader->bind();
 		glm::mat4 view = glm::mat4(glm::mat3(camera.GetView()));
-		skyBox.skyboxShader.setUniformMat4("view", view);
+		skyBox.skyboxShader->setUniformMat4(VIEW, view);
 		glm::mat4 projection = glm::perspective(glm::radians(45.0f), (float)scwidth / (float)scheight, 0.1f, 400.0f);
-		skyBox.skyboxShader.setUniformMat4("projection", projection);
+		skyBox.skyboxShader->setUniformMat4(PROJECTION, projection);
 		glm::mat4 model = glm::identity<glm::mat4>();
-		skyBox.skyboxShader.setUniformMat4("model", model);
-		skyBox.skyboxShader.setInt("skyboxCubemap", 0);
+		skyBox.skyboxShader->setUniformMat4(MODEL, model);
+		skyBox.skyboxShader->setInt(SKYBOX_CUBEMAP, 0);
 		// -- render the skybox cube
 		GLCall(glBindVertexArray(skyBox.skyboxVAO));
 		GLCall(glActiveTexture(GL_TEXTURE0)); //! could be the problem
-		GLCall(glBindTexture(GL_TEXTURE_CUBE_MAP, skyBox.cubeMapTexture));
+		GLCall(glBindTexture(GL_TEXTURE_CUBE_MAP, skyBox.cubeMap->GetTextureID()));
 		GLCall(glDrawArrays(GL_TRIANGLES, 0, 36));
 		GLCall(glBindVertexArray(0));
 		GLCall(glDepthFunc(GL_LESS)); // set depth function back to normal
@@ -201,8 +235,8 @@ namespace lei3d
 		glBindTexture(GL_TEXTURE_2D, rawTexture);	   // 0
 		glActiveTexture(GL_TEXTURE1);
 		glBindTexture(GL_TEXTURE_2D, saturationMask);  // 1
-		postprocessShader.setInt("RawFinalImage", 0);
-		postprocessShader.setInt("SaturationMask", 1); // match active texture bindings
+		postprocessShader.setInt(RAW_FINAL_IMAGE, 0);
+		postprocessShader.setInt(SATURATION_MASK, 1); // match active texture bindings
 
 		glBindVertexArray(dummyVAO);
 		glDrawArrays(GL_TRIANGLES, 0, 3);
@@ -216,7 +250,7 @@ namespace lei3d
 		glBlitFramebuffer(0, 0, scwidth, scheight, 0, 0, scwidth, scheight, GL_COLOR_BUFFER_BIT, GL_LINEAR);
 	}
 
-	void RenderSystem::genShadowPass(const std::vector<ModelInstance*>& objects, DirectionalLight* light, Camera& camera)
+	void RenderSystem::genShadowPass(const FrameVector<ModelInstance*>& objects, DirectionalLight* light, Camera& camera)
 	{
 		shadowCSMShader.bind();
 
@@ -228,10 +262,10 @@ namespace lei3d
 		glEnable(GL_DEPTH_TEST); // enable drawing to depth mask and depth testing
 		glClear(GL_DEPTH_BUFFER_BIT);
 
-		light->lightSpaceMatrices = getLightSpaceMatrices(light, camera);
+		updateLightSpaceMatrices(light, camera);
 		for (int i = 0; i < light->lightSpaceMatrices.size(); i++)
 		{
-			shadowCSMShader.setUniformMat4(("lightSpaceMatrices[" + std::to_string(i) + "]"), light->lightSpaceMatrices[i]);
+			shadowCSMShader.setUniformMat4(LIGHT_SPACE_MATRIX_UNIFORMS[i], light->lightSpaceMatrices[i]);
 		}
 		// TODO: figure out why UBOs not working later
 	//		glBindBuffer(GL_UNIFORM_BUFFER, light->lsmUBO);
@@ -250,10 +284,11 @@ namespace lei3d
 		glViewport(0, 0, scwidth, scheight);
 	}
 
-	std::vector<glm::vec4> RenderSystem::getFrustumCornersWS(const glm::mat4& projection, const glm::mat4& view)
+	std::array<glm::vec4, 8> RenderSystem::getFrustumCornersWS(const glm::mat4& projection, const glm::mat4& view)
 	{
 		glm::mat4 invVP = glm::inverse(projection * view);
-		std::vector<glm::vec4> corners;
+		std::array<glm::vec4, 8> corners;
+		int cornerI = 0;
 		for (int x = 0; x < 2; x++)
 		{
 			for (int y = 0; y < 2; y++)
@@ -261,7 +296,7 @@ namespace lei3d
 				for (int z = 0; z < 2; z++)
 				{
 					glm::vec4 c = invVP * glm::vec4{ 2.0f * x - 1.0f, 2.0f * y - 1.0f, 2.0f * z - 1.0f, 1.0f };
-					corners.push_back(c / c.w);
+					corners[cornerI++] = c / c.w;
 				}
 			}
 		}
@@ -271,7 +306,7 @@ namespace lei3d
 	glm::mat4 RenderSystem::getLightSpaceMatrix(DirectionalLight* light, float nearPlane, float farPlane, Camera& camera)
 	{
 		const glm::mat4 projection = glm::perspective(glm::radians(camera.GetFOV()), (float)scwidth / (float)scheight, nearPlane, farPlane);
-		const std::vector<glm::vec4> corners = getFrustumCornersWS(projection, camera.GetView());
+		const std::array<glm::vec4, 8> corners = getFrustumCornersWS(projection, camera.GetView());
 
 		glm::vec3 center = glm::vec3(0.f);
 		for (const auto& c : corners)
@@ -319,26 +354,23 @@ namespace lei3d
 		return lightProj * lightView;
 	}
 
-	std::vector<glm::mat4> RenderSystem::getLightSpaceMatrices(DirectionalLight* light, Camera& camera)
+	void RenderSystem::updateLightSpaceMatrices(DirectionalLight* light, Camera& camera)
 	{
-		std::vector<glm::mat4> matrices;
-		matrices.reserve(light->cascadeLevels.size() + 1);
 		for (int i = 0; i < light->cascadeLevels.size() + 1; i++)
 		{
 			if (i == 0)
 			{
-				matrices.push_back(getLightSpaceMatrix(light, camera.GetNearPlane(), light->cascadeLevels[i], camera));
+				light->lightSpaceMatrices[i] = getLightSpaceMatrix(light, camera.GetNearPlane(), light->cascadeLevels[i], camera);
 			}
 			else if (i < light->cascadeLevels.size())
 			{
-				matrices.push_back(getLightSpaceMatrix(light, light->cascadeLevels[i - 1], light->cascadeLevels[i], camera));
+				light->lightSpaceMatrices[i] = getLightSpaceMatrix(light, light->cascadeLevels[i - 1], light->cascadeLevels[i], camera);
 			}
 			else
 			{
-				matrices.push_back(getLightSpaceMatrix(light, light->cascadeLevels[i - 1], camera.GetFarPlane(), camera));
+				light->lightSpaceMatrices[i] = getLightSpaceMatrix(light, light->cascadeLevels[i - 1], camera.GetFarPlane(), camera);
 			}
 		}
-		return matrices;
 	}
 
 } // namespace lei3d
\ No newline at end of file
@@ -2,11 +2,14 @@
 
 #include "core/Camera.hpp"
 #include "core/Component.hpp"
+#include "core/FrameAllocator.hpp"
 #include "core/Scene.hpp"
 #include "core/SceneView.hpp" 
 
 #include "rendering/Shader.hpp"
 
+#include <array>
+
 namespace lei3d
 {
 
@@ -29,17 +32,17 @@ namespace lei3d
 
 		void initialize(int width, int height);
 
-		void draw(const Scene& scene, const SceneView& view);
+		void draw(Scene& scene, const SceneView& view);
 
 	private:
-		void lightingPass(const std::vector<ModelInstance*>& objects, const DirectionalLight* light, Camera& camera);
+		void lightingPass(const FrameVector<ModelInstance*>& objects, const DirectionalLight* light, Camera& camera);
 		void environmentPass(const SkyBox& skyBox, Camera& camera);
 		void postprocessPass();
 
-		void genShadowPass(const std::vector<ModelInstance*>& objects, DirectionalLight* light, Camera& camera);
-		std::vector<glm::vec4> getFrustumCornersWS(const glm::mat4& projection, const glm::mat4& view);
+		void genShadowPass(const FrameVector<ModelInstance*>& objects, DirectionalLight* light, Camera& camera);
+		std::array<glm::vec4, 8> getFrustumCornersWS(const glm::mat4& projection, const glm::mat4& view);
 		glm::mat4 getLightSpaceMatrix(DirectionalLight* light, float nearPlane, float farPlane, Camera& camera);
-		std::vector<glm::mat4> getLightSpaceMatrices(DirectionalLight* light, Camera& camera);
+		void updateLightSpaceMatrices(DirectionalLight* light, Camera& camera); // Fills light->lightSpaceMatrices.
 
 		// offscreen render target objects
 		unsigned int FBO;
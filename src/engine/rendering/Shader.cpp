@@ -2,6 +2,8 @@
 
 #include "logging/GLDebug.hpp"
 
+#include <algorithm>
+
 namespace lei3d
 {
 
@@ -136,6 +138,7 @@ namespace lei3d
 			glGetProgramInfoLog(m_ShaderID, 512, NULL, infoLog);
 			LEI_ERROR("SHADER PROGRAM LINKING FAILED\n\n" + std::string(infoLog));
 		}
+		glGetProgramiv(m_ShaderID, GL_PROGRAM_BINARY_LENGTH, &m_ProgramBinarySize);
 
 		glDeleteShader(vertexShaderID);
 		glDeleteShader(fragmentShaderID);
@@ -143,6 +146,43 @@ namespace lei3d
 		{
 			glDeleteShader(geometryShaderID);
 		}
+
+		cacheUniformLocations();
+	}
+
+	void Shader::cacheUniformLocations()
+	{
+		GLint uniformCount = 0;
+		GLint maxNameLength = 0;
+		glGetProgramiv(m_ShaderID, GL_ACTIVE_UNIFORMS, &uniformCount);
+		glGetProgramiv(m_ShaderID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxNameLength);
+
+		std::string nameBuffer(std::max(maxNameLength, 1), '\0');
+		for (GLint i = 0; i < uniformCount; i++)
+		{
+			GLsizei nameLength = 0;
+			GLint	arraySize = 0;
+			GLenum	type = 0;
+			glGetActiveUniform(m_ShaderID, i, maxNameLength, &nameLength, &arraySize, &type, nameBuffer.data());
+			std::string name(nameBuffer.data(), nameLength);
+
+			// Arrays are only listed once, as "name[0]". Add every element, and the bare name which GL also accepts.
+			const std::string arraySuffix = "[0]";
+			if (name.size() > arraySuffix.size() && name.compare(name.size() - arraySuffix.size(), arraySuffix.size(), arraySuffix) == 0)
+			{
+				const std::string baseName = name.substr(0, name.size() - arraySuffix.size());
+				for (GLint element = 0; element < arraySize; element++)
+				{
+					const std::string elementName = baseName + "[" + std::to_string(element) + "]";
+					m_UniformLocations[StringId::Intern(elementName)] = glGetUniformLocation(m_ShaderID, elementName.c_str());
+				}
+				m_UniformLocations[StringId::Intern(baseName)] = glGetUniformLocation(m_ShaderID, name.c_str());
+			}
+			else
+			{
+				m_UniformLocations[StringId::Intern(name)] = glGetUniformLocation(m_ShaderID, name.c_str());
+			}
+		}
 	}
 
 	/**
@@ -158,50 +198,48 @@ namespace lei3d
 		GLCall(glUseProgram(0));
 	}
 
-	void Shader::setUniformMat4(const std::string& name, const glm::mat4& matrix) const
+	void Shader::setUniformMat4(StringId name, const glm::mat4& matrix) const
 	{
 		GLCall(glUniformMatrix4fv(getUniformLocation(name), 1, GL_FALSE, glm::value_ptr(matrix)));
 	}
 
-	void Shader::setInt(const std::string& name, int value) const
+	void Shader::setInt(StringId name, int value) const
 	{
 		GLCall(glUniform1i(getUniformLocation(name), value));
 	}
 
-	void Shader::setBool(const std::string& name, bool value) const
+	void Shader::setBool(StringId name, bool value) const
 	{
 		GLCall(glUniform1i(getUniformLocation(name), static_cast<int>(value)));
 	}
 
-	void Shader::setFloat(const std::string& name, float value) const
+	void Shader::setFloat(StringId name, float value) const
 	{
 		GLCall(glUniform1f(getUniformLocation(name), value));
 	}
 
-	void Shader::setVec3(const std::string& name, const glm::vec3& value) const
+	void Shader::setVec3(StringId name, const glm::vec3& value) const
 	{
 		GLCall(glUniform3f(getUniformLocation(name), value.x, value.y, value.z));
 	}
 
-	void Shader::setVec2(const std::string& name, const glm::vec2& value) const
+	void Shader::setVec2(StringId name, const glm::vec2& value) const
 	{
 		GLCall(glUniform2f(getUniformLocation(name), value.x, value.y));
 	}
 
-	int Shader::getUniformLocation(const std::string& name) const
+	int Shader::getUniformLocation(StringId name) const
 	{
-		auto it = m_UniformLocationCache.find(name);
-		if (it != m_UniformLocationCache.end())
+		auto it = m_UniformLocations.find(name);
+		if (it != m_UniformLocations.end())
 		{
 			return it->second;
 		}
 
-		GLCall(const int location = glGetUniformLocation(m_ShaderID, name.c_str()));
-		if (location == -1)
-		{
-			LEI_ERROR("Uniform does not exist: " + name);
-		}
-		return location;
+		// Not active in the program. Either it doesn't exist or the compiler optimized it out.
+		LEI_ERROR("Uniform does not exist: {0} ({1:#x})", name.GetString(), name.GetHash());
+		m_UniformLocations.emplace(name, -1);
+		return -1;
 	}
 
 } // namespace lei3d
\ No newline at end of file
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "core/StringId.hpp"
+
 #include <glad/glad.h>
 
 #include <fstream>
@@ -17,8 +19,11 @@ namespace lei3d
 	{
 	private:
 		unsigned int m_ShaderID;
+		int			 m_ProgramBinarySize = 0; // The closest thing to a memory size GL tells us about a program.
 
-		std::unordered_map<std::string, int> m_UniformLocationCache;
+		// Every active uniform, filled in right after linking. Names that turn out to be missing get added as -1 the
+		// first time they're set, so the error is only logged once.
+		mutable std::unordered_map<StringId, int> m_UniformLocations;
 
 	public:
 		Shader();
@@ -28,18 +33,20 @@ namespace lei3d
 		void bind() const;
 		void unbind() const;
 
-		void setBool(const std::string& name, bool value) const;
-		void setInt(const std::string& name, int value) const; // set string value in shader to an int
-		void setFloat(const std::string& name, float value) const;
+		void setBool(StringId name, bool value) const;
+		void setInt(StringId name, int value) const; // set string value in shader to an int
+		void setFloat(StringId name, float value) const;
 
-		void setVec2(const std::string& name, const glm::vec2& value) const;
-		void setVec3(const std::string& name, const glm::vec3& value) const;
-		void setUniformMat4(const std::string& name, const glm::mat4& matrix) const;
+		void setVec2(StringId name, const glm::vec2& value) const;
+		void setVec3(StringId name, const glm::vec3& value) const;
+		void setUniformMat4(StringId name, const glm::mat4& matrix) const;
 
 		unsigned int getShaderID() const { return m_ShaderID; }
+		int			 getProgramBinarySize() const { return m_ProgramBinarySize; }
 
 	private:
-		int getUniformLocation(const std::string& name) const;
+		void cacheUniformLocations();
+		int	 getUniformLocation(StringId name) const;
 	};
 
 } // namespace lei3d
\ No newline at end of file
@@ -0,0 +1,278 @@
+#include "Texture.hpp"
+
+#include "logging/GLDebug.hpp"
+#include "logging/Log.hpp"
+#include "rendering/TextureResidency.hpp"
+#include "rendering/TextureStreamer.hpp"
+
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <vector>
+
+namespace lei3d
+{
+	static GLenum getCompressedFormat(BlockFormat format)
+	{
+		switch (format)
+		{
+			case BLOCK_FORMAT_BC3:
+				return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+			case BLOCK_FORMAT_BC4:
+				return GL_COMPRESSED_RED_RGTC1;
+			case BLOCK_FORMAT_BC5:
+				return GL_COMPRESSED_RG_RGTC2;
+			case BLOCK_FORMAT_BC1:
+			default:
+				return GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+		}
+	}
+
+	Texture::Texture(const std::string& path, bool decode)
+		: m_Path(path)
+	{
+		if (!decode || loadCooked())
+		{
+			return;
+		}
+
+		m_Image = Image(path, true);
+		m_Width = m_Image.GetWidth();
+		m_Height = m_Image.GetHeight();
+		m_Channels = m_Image.GetChannels();
+		m_UploadedBytes = m_Image.GetByteSize() * 4 / 3; // Plus a third for the mip chain.
+	}
+
+	Texture::~Texture()
+	{
+		if (m_Streaming)
+		{
+			TextureStreamer::Cancel(this);
+		}
+		if (m_Managed)
+		{
+			TextureResidency::Unregister(*this);
+		}
+		if (m_Uploaded)
+		{
+			GLCall(glDeleteTextures(1, &m_ID));
+		}
+	}
+
+	bool Texture::loadCooked()
+	{
+		namespace fs = std::filesystem;
+
+		const std::string cookedPath = TextureFile::GetCookedPath(m_Path);
+		std::error_code	  error;
+		if (!fs::exists(cookedPath, error))
+		{
+			return false;
+		}
+		if (!m_CookedFile.Open(cookedPath))
+		{
+			return false;
+		}
+		if (!m_CookedFile.IsSourceUnchanged(m_Path))
+		{
+			// Decoded instead, IsSourceUnchanged logged why.
+			m_CookedFile.Close();
+			return false;
+		}
+
+		// RGTC (BC4, BC5) is core, S3TC (BC1, BC3) is an extension every desktop driver has. Just in case one doesn't.
+		const BlockFormat format = m_CookedFile.GetFormat();
+		if ((format == BLOCK_FORMAT_BC1 || format == BLOCK_FORMAT_BC3) && !GLAD_GL_EXT_texture_compression_s3tc)
+		{
+			LEI_WARN("No S3TC support, decoding {0} instead of using its {1} cooked twin", m_Path, GetBlockFormatName(format));
+			m_CookedFile.Close();
+			return false;
+		}
+
+		m_Width = m_CookedFile.GetMip(0).width;
+		m_Height = m_CookedFile.GetMip(0).height;
+		for (uint32_t level = 0; level < m_CookedFile.GetMipCount(); level++)
+		{
+			m_UploadedBytes += m_CookedFile.GetMip(level).size;
+		}
+		return true;
+	}
+
+	void Texture::Upload()
+	{
+		if (m_Uploaded)
+		{
+			return;
+		}
+
+		GLCall(glGenTextures(1, &m_ID));
+		GLCall(glBindTexture(GL_TEXTURE_2D, m_ID));
+		GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT));
+		GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT));
+		GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR));
+		GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR));
+		m_Uploaded = true;
+
+		// Storage first, the data goes in through the TextureStreamer over the next frames.
+		if (m_CookedFile.IsOpen())
+		{
+			// Levels get allocated as they're streamed in. Until the first one arrives the base level is past the last,
+			// which samples black. Under a TextureResidency only the small mips load now, the rest once they're seen.
+			const uint32_t mipCount = m_CookedFile.GetMipCount();
+			m_ResidentLevel = mipCount;
+			m_AllocatedLevel = mipCount;
+			GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, mipCount));
+			GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, mipCount - 1));
+
+			m_Managed = TextureResidency::Register(*this);
+			StreamLevels(m_Managed ? TextureResidency::GetTailLevel(*this) : 0);
+			return;
+		}
+
+		// Images that failed to decode already warned about it, and stay an empty texture.
+		std::vector<TextureStreamImage> images;
+		if (m_Image.IsValid())
+		{
+			GLenum format = GL_RGBA;
+			if (m_Channels == 1)
+				format = GL_RED;
+			else if (m_Channels == 2)
+				format = GL_RG;
+			else if (m_Channels == 3)
+				format = GL_RGB;
+
+			// The mips get generated once level 0 is in, until then the texture is incomplete and samples black.
+			GLCall(glTexImage2D(GL_TEXTURE_2D, 0, format, m_Width, m_Height, 0, format, GL_UNSIGNED_BYTE, nullptr));
+			images.push_back({ GL_TEXTURE_2D, 0, m_Width, m_Height, format, false, m_Image.GetPixels(), static_cast<size_t>(m_Width) * m_Channels, m_Height });
+		}
+
+		m_Streaming = true;
+		if (TextureStreamer::Stream({ this, m_ID, GL_TEXTURE_2D, images, nullptr, [this]() { finishUpload(); } }))
+		{
+			return;
+		}
+
+		// No streamer, or rows too big for its ring: all of it right now.
+		for (const TextureStreamImage& image : images)
+		{
+			TextureStreamer::UploadRows(image, 0, image.rowCount, image.data);
+		}
+		finishUpload();
+	}
+
+	uint32_t Texture::GetMipCount() const
+	{
+		return m_CookedFile.IsOpen() ? m_CookedFile.GetMipCount() : 1;
+	}
+
+	size_t Texture::GetLevelBytes(uint32_t firstLevel) const
+	{
+		if (!m_CookedFile.IsOpen())
+		{
+			return m_UploadedBytes;
+		}
+
+		size_t bytes = 0;
+		for (uint32_t level = firstLevel; level < m_CookedFile.GetMipCount(); level++)
+		{
+			bytes += m_CookedFile.GetMip(level).size;
+		}
+		return bytes;
+	}
+
+	void Texture::StreamLevels(uint32_t finestLevel)
+	{
+		if (!m_Uploaded || !m_CookedFile.IsOpen() || m_Streaming || finestLevel >= m_ResidentLevel)
+		{
+			return;
+		}
+
+		// The mips were made offline, the GPU copies each level as is. Smallest first, and the texture samples the
+		// finest level in so far.
+		const BlockFormat format = m_CookedFile.GetFormat();
+		const GLenum	  internalFormat = getCompressedFormat(format);
+		GLCall(glBindTexture(GL_TEXTURE_2D, m_ID));
+		for (uint32_t level = finestLevel; level < m_AllocatedLevel; level++)
+		{
+			const TextureFile::MipLevel& mip = m_CookedFile.GetMip(level);
+			GLCall(glCompressedTexImage2D(GL_TEXTURE_2D, level, internalFormat, mip.width, mip.height, 0, static_cast<GLsizei>(mip.size), nullptr));
+		}
+		m_AllocatedLevel = std::min(m_AllocatedLevel, finestLevel);
+
+		std::vector<TextureStreamImage> images;
+		for (uint32_t level = m_ResidentLevel; level-- > finestLevel;)
+		{
+			const TextureFile::MipLevel& mip = m_CookedFile.GetMip(level);
+			const int					 blocksX = std::max(1, (mip.width + 3) / 4);
+			const int					 blocksY = std::max(1, (mip.height + 3) / 4);
+			images.push_back({ GL_TEXTURE_2D, static_cast<int>(level), mip.width, mip.height, internalFormat, true, mip.data, blocksX * GetBlockSize(format), blocksY });
+		}
+
+		auto onImageUploaded = [this](const TextureStreamImage& image) {
+			m_ResidentLevel = static_cast<uint32_t>(image.level);
+			GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, image.level));
+		};
+
+		m_Streaming = true;
+		if (TextureStreamer::Stream({ this, m_ID, GL_TEXTURE_2D, images, onImageUploaded, [this]() { finishUpload(); } }))
+		{
+			return;
+		}
+
+		for (const TextureStreamImage& image : images)
+		{
+			TextureStreamer::UploadRows(image, 0, image.rowCount, image.data);
+			onImageUploaded(image);
+		}
+		finishUpload();
+	}
+
+	void Texture::EvictLevels(uint32_t finestLevel)
+	{
+		if (!m_Uploaded || !m_CookedFile.IsOpen())
+		{
+			return;
+		}
+
+		finestLevel = std::min(finestLevel, m_CookedFile.GetMipCount() - 1);
+		if (finestLevel <= m_AllocatedLevel)
+		{
+			return;
+		}
+
+		// Whatever was still streaming in is dropped with the levels it was going into.
+		if (m_Streaming)
+		{
+			TextureStreamer::Cancel(this);
+			m_Streaming = false;
+		}
+
+		// Respecifying a level as empty frees it. Levels below the base level don't count towards completeness.
+		const GLenum internalFormat = getCompressedFormat(m_CookedFile.GetFormat());
+		GLCall(glBindTexture(GL_TEXTURE_2D, m_ID));
+		for (uint32_t level = m_AllocatedLevel; level < finestLevel; level++)
+		{
+			GLCall(glCompressedTexImage2D(GL_TEXTURE_2D, level, internalFormat, 0, 0, 0, 0, nullptr));
+		}
+		m_AllocatedLevel = finestLevel;
+		m_ResidentLevel = std::max(m_ResidentLevel, finestLevel);
+		GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, m_ResidentLevel));
+	}
+
+	void Texture::finishUpload()
+	{
+		if (!m_CookedFile.IsOpen() && m_Image.IsValid())
+		{
+			GLCall(glGenerateMipmap(GL_TEXTURE_2D));
+		}
+
+		// Textures under a TextureResidency keep their cooked file mapped, to stream levels in again after evicting them.
+		m_Image.Free();
+		if (!m_Managed)
+		{
+			m_CookedFile.Close();
+		}
+		m_Streaming = false;
+	}
+} // namespace lei3d
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "rendering/Image.hpp"
+#include "rendering/TextureFile.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+
+namespace lei3d
+{
+	/*
+	 * A 2D texture loaded from an image file. Like CubeMap, the constructor only decodes (any thread) and Upload
+	 * creates the GL texture (main thread). Its data then streams in over the next frames (see TextureStreamer), after
+	 * which the decoded pixels are freed.
+	 * If lei3d_cook has compressed the image (see TextureFile), the constructor maps that instead and Upload hands the
+	 * GPU its compressed mips as they are. Images without an up to date cooked twin are decoded and get their mips
+	 * generated at upload.
+	 * Cooked textures can also have their finer mips loaded and evicted while in use, see TextureResidency.
+	 *
+	 * Textures are shared: models get theirs from the AssetManager, so every material using the same file binds the
+	 * same GL texture. Only the AssetManager (or whoever owns an uncached one) destroys them, on the main thread.
+	 */
+	class Texture
+	{
+	private:
+		std::string	 m_Path;
+		Image		 m_Image;		// Freed once uploaded.
+		TextureFile	 m_CookedFile;	// Open until uploaded if the texture was cooked, or for good if it's managed.
+		unsigned int m_ID = 0;
+		int			 m_Width = 0;
+		int			 m_Height = 0;
+		int			 m_Channels = 0;
+		size_t		 m_UploadedBytes = 0;
+		bool		 m_Uploaded = false;
+		bool		 m_Streaming = false; // Uploaded, but the data isn't all in yet.
+
+		// Mip residency, cooked textures only. Levels from m_AllocatedLevel on have storage, from m_ResidentLevel on
+		// also have their data and get sampled (GL_TEXTURE_BASE_LEVEL). Both are the mip count when nothing is in.
+		bool	 m_Managed = false; // Registered with the TextureResidency.
+		uint32_t m_ResidentLevel = 0;
+		uint32_t m_AllocatedLevel = 0;
+		uint32_t m_RequestedLevel = NO_REQUEST;
+
+	public:
+		static constexpr uint32_t NO_REQUEST = ~0u;
+
+		// decode false only keeps the path, e.g. for cooking, where nothing gets drawn.
+		explicit Texture(const std::string& path, bool decode = true);
+		~Texture();
+
+		Texture(const Texture&) = delete;
+		Texture& operator=(const Texture&) = delete;
+
+		void Upload(); // Does nothing if it already is, so every model using the texture can call it.
+		bool IsUploaded() const { return m_Uploaded; }
+		bool IsStreaming() const { return m_Streaming; }
+
+		unsigned int	   GetID() const { return m_ID; } // 0 until uploaded.
+		const std::string& GetPath() const { return m_Path; }
+
+		int	   GetWidth() const { return m_Width; }
+		int	   GetHeight() const { return m_Height; }
+		size_t GetCpuBytes() const { return m_Image.GetByteSize() + (m_CookedFile.IsOpen() ? m_CookedFile.GetFileSize() : 0); }
+		size_t GetGpuBytes() const { return m_Uploaded ? (m_Managed ? GetLevelBytes(m_AllocatedLevel) : m_UploadedBytes) : 0; }
+		size_t GetUploadedBytes() const { return m_UploadedBytes; } // What it takes on the GPU once uploaded, mip chain included. Known after decoding.
+
+		// Mip residency, see TextureResidency. Only cooked textures have levels to stream, the others are always complete.
+		uint32_t GetMipCount() const;
+		uint32_t GetResidentLevel() const { return m_ResidentLevel; }
+		uint32_t GetAllocatedLevel() const { return m_AllocatedLevel; }
+		size_t	 GetLevelBytes(uint32_t firstLevel) const; // VRAM for the levels from firstLevel to the smallest.
+		void	 RequestLevel(uint32_t level) { m_RequestedLevel = std::min(m_RequestedLevel, level); } // While drawing.
+		uint32_t TakeRequestedLevel() { return std::exchange(m_RequestedLevel, NO_REQUEST); }		   // Once per frame.
+		void	 StreamLevels(uint32_t finestLevel); // Starts streaming in the levels down to finestLevel, if it isn't busy.
+		void	 EvictLevels(uint32_t finestLevel);	 // Frees the levels finer than finestLevel right away.
+
+	private:
+		bool loadCooked();
+		void finishUpload(); // Once all the data is in. Texture bound.
+	};
+} // namespace lei3d
@@ -0,0 +1,296 @@
+#include "TextureFile.hpp"
+
+#include "logging/Log.hpp"
+
+#include <stb_image.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+namespace lei3d
+{
+	static_assert(sizeof(DDSPixelFormat) == 32, "DDS_PIXELFORMAT is 32 bytes");
+	static_assert(sizeof(DDSHeader) == 124, "DDS_HEADER is 124 bytes");
+
+	namespace
+	{
+		constexpr uint32_t makeFourCC(char a, char b, char c, char d)
+		{
+			return static_cast<uint32_t>(a) | (static_cast<uint32_t>(b) << 8) | (static_cast<uint32_t>(c) << 16) | (static_cast<uint32_t>(d) << 24);
+		}
+
+		constexpr uint32_t FOURCCS[BLOCK_FORMAT_COUNT] = {
+			makeFourCC('D', 'X', 'T', '1'), // BC1
+			makeFourCC('D', 'X', 'T', '5'), // BC3
+			makeFourCC('A', 'T', 'I', '1'), // BC4
+			makeFourCC('A', 'T', 'I', '2'), // BC5
+		};
+
+		// reserved1[0] marks a header with a SourceStamp, which follows it.
+		constexpr uint32_t SOURCE_STAMP_MARKER = makeFourCC('L', '3', 'D', 'S');
+		constexpr size_t   SOURCE_STAMP_OFFSET = sizeof(DDS_MAGIC) + offsetof(DDSHeader, reserved1) + sizeof(uint32_t);
+		static_assert(sizeof(SourceStamp) + sizeof(uint32_t) <= sizeof(DDSHeader::reserved1), "The source stamp has to fit in the reserved words");
+
+		constexpr uint32_t DDSD_CAPS = 0x1;
+		constexpr uint32_t DDSD_HEIGHT = 0x2;
+		constexpr uint32_t DDSD_WIDTH = 0x4;
+		constexpr uint32_t DDSD_PIXELFORMAT = 0x1000;
+		constexpr uint32_t DDSD_MIPMAPCOUNT = 0x20000;
+		constexpr uint32_t DDSD_LINEARSIZE = 0x80000;
+		constexpr uint32_t DDPF_FOURCC = 0x4;
+		constexpr uint32_t DDSCAPS_COMPLEX = 0x8;
+		constexpr uint32_t DDSCAPS_TEXTURE = 0x1000;
+		constexpr uint32_t DDSCAPS_MIPMAP = 0x400000;
+
+		// Halves an RGBA8 image with a box filter (an odd last row or column is averaged with itself).
+		std::vector<uint8_t> downsample(const std::vector<uint8_t>& rgba, int width, int height, int& outWidth, int& outHeight)
+		{
+			outWidth = std::max(1, width / 2);
+			outHeight = std::max(1, height / 2);
+
+			std::vector<uint8_t> result(static_cast<size_t>(outWidth) * outHeight * 4);
+			for (int y = 0; y < outHeight; y++)
+			{
+				const int y0 = std::min(y * 2, height - 1);
+				const int y1 = std::min(y * 2 + 1, height - 1);
+				for (int x = 0; x < outWidth; x++)
+				{
+					const int x0 = std::min(x * 2, width - 1);
+					const int x1 = std::min(x * 2 + 1, width - 1);
+					for (int c = 0; c < 4; c++)
+					{
+						const uint32_t sum = rgba[(static_cast<size_t>(y0) * width + x0) * 4 + c] + rgba[(static_cast<size_t>(y0) * width + x1) * 4 + c]
+							+ rgba[(static_cast<size_t>(y1) * width + x0) * 4 + c] + rgba[(static_cast<size_t>(y1) * width + x1) * 4 + c];
+						result[(static_cast<size_t>(y) * outWidth + x) * 4 + c] = static_cast<uint8_t>((sum + 2) / 4);
+					}
+				}
+			}
+			return result;
+		}
+	} // namespace
+
+	bool TextureFile::Open(const std::string& path)
+	{
+		Close();
+
+		if (!m_File.Open(path))
+		{
+			return false;
+		}
+
+		const size_t size = m_File.Size();
+		uint32_t	 magic = 0;
+		DDSHeader	 header = {};
+		if (size >= sizeof(magic) + sizeof(DDSHeader))
+		{
+			std::memcpy(&magic, m_File.Data(), sizeof(magic));
+			std::memcpy(&header, m_File.Data() + sizeof(magic), sizeof(DDSHeader));
+		}
+		if (magic != DDS_MAGIC || header.size != sizeof(DDSHeader))
+		{
+			LEI_ERROR("{0} is not a DDS file", path);
+			m_File.Close();
+			return false;
+		}
+
+		const uint32_t* format = std::find(std::begin(FOURCCS), std::end(FOURCCS), header.pixelFormat.fourCC);
+		if (!(header.pixelFormat.flags & DDPF_FOURCC) || format == std::end(FOURCCS))
+		{
+			LEI_ERROR("{0} isn't BC1, BC3, BC4 or BC5 compressed", path);
+			m_File.Close();
+			return false;
+		}
+		m_Format = static_cast<BlockFormat>(format - std::begin(FOURCCS));
+
+		m_HasSourceStamp = header.reserved1[0] == SOURCE_STAMP_MARKER;
+		if (m_HasSourceStamp)
+		{
+			std::memcpy(&m_SourceStamp, m_File.Data() + SOURCE_STAMP_OFFSET, sizeof(SourceStamp));
+		}
+
+		// Everything a level points at has to be inside the file, so nothing later has to check.
+		const uint32_t mipCount = std::min(std::max(header.mipMapCount, 1u), MAX_MIP_LEVELS);
+		size_t		   offset = sizeof(magic) + sizeof(DDSHeader);
+		int			   width = static_cast<int>(header.width);
+		int			   height = static_cast<int>(header.height);
+		for (uint32_t level = 0; level < mipCount; level++)
+		{
+			const size_t levelSize = GetCompressedSize(m_Format, width, height);
+			if (width <= 0 || height <= 0 || offset > size || levelSize > size - offset)
+			{
+				LEI_ERROR("{0} is truncated or corrupted", path);
+				Close();
+				return false;
+			}
+
+			m_Mips[level] = { reinterpret_cast<const uint8_t*>(m_File.Data() + offset), levelSize, width, height };
+			offset += levelSize;
+			width = std::max(1, width / 2);
+			height = std::max(1, height / 2);
+		}
+
+		m_MipCount = mipCount;
+		return true;
+	}
+
+	void TextureFile::Close()
+	{
+		m_MipCount = 0;
+		m_HasSourceStamp = false;
+		m_File.Close();
+	}
+
+	bool TextureFile::IsSourceUnchanged(const std::string& sourcePath) const
+	{
+		if (!m_HasSourceStamp)
+		{
+			LEI_WARN("{0} was cooked by an older lei3d_cook. Run lei3d_cook to update it.", sourcePath);
+			return false;
+		}
+		if (CheckSourceStamp(sourcePath, m_SourceStamp) == SOURCE_CHANGED)
+		{
+			LEI_WARN("{0} changed since it was cooked. Run lei3d_cook to update it.", sourcePath);
+			return false;
+		}
+		return true;
+	}
+
+	bool TextureFile::IsUpToDate(const std::string& sourcePath, const std::string& cookedPath)
+	{
+		std::error_code error;
+		if (!std::filesystem::exists(cookedPath, error))
+		{
+			return false;
+		}
+
+		TextureFile file;
+		if (!file.Open(cookedPath) || !file.m_HasSourceStamp)
+		{
+			return false;
+		}
+
+		SourceStamp		  stamp;
+		const SourceState state = CheckSourceStamp(sourcePath, file.m_SourceStamp, &stamp);
+		file.Close();
+		if (state == SOURCE_TOUCHED)
+		{
+			std::fstream fileStream(cookedPath, std::fstream::binary | std::fstream::in | std::fstream::out);
+			fileStream.seekp(SOURCE_STAMP_OFFSET);
+			fileStream.write(reinterpret_cast<const char*>(&stamp), sizeof(stamp));
+		}
+		return state != SOURCE_CHANGED;
+	}
+
+	std::string TextureFile::GetCookedPath(const std::string& sourcePath)
+	{
+		return sourcePath + ".dds";
+	}
+
+	bool TextureFile::IsImageSource(const std::string& path)
+	{
+		static const std::vector<std::string> extensions = { ".png", ".jpg", ".jpeg", ".tga", ".bmp" };
+
+		const size_t dot = path.find_last_of('.');
+		if (dot == std::string::npos)
+		{
+			return false;
+		}
+
+		std::string extension = path.substr(dot);
+		std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return std::tolower(c); });
+		return std::find(extensions.begin(), extensions.end(), extension) != extensions.end();
+	}
+
+	bool TextureFile::Cook(const std::string& sourcePath, const std::string& cookedPath)
+	{
+		SourceStamp stamp;
+		if (!MakeSourceStamp(sourcePath, stamp))
+		{
+			return false;
+		}
+
+		// Flipped like Texture flips it when it decodes the source itself.
+		int width, height, channels;
+		stbi_set_flip_vertically_on_load_thread(true);
+		unsigned char* pixels = stbi_load(sourcePath.c_str(), &width, &height, &channels, 4);
+		if (!pixels)
+		{
+			LEI_ERROR("Failed to decode {0} ({1})", sourcePath, stbi_failure_reason());
+			return false;
+		}
+
+		std::vector<uint8_t> rgba(pixels, pixels + static_cast<size_t>(width) * height * 4);
+		stbi_image_free(pixels);
+
+		// stb fills in 255 for sources without alpha.
+		bool opaque = true;
+		for (size_t i = 3; i < rgba.size() && opaque; i += 4)
+		{
+			opaque = rgba[i] == 255;
+		}
+
+		BlockFormat format = opaque ? BLOCK_FORMAT_BC1 : BLOCK_FORMAT_BC3;
+		if (channels == 1)
+		{
+			format = BLOCK_FORMAT_BC4;
+		}
+		else if (channels == 2)
+		{
+			// Grey and alpha, sampled as red and green like an uncompressed two channel texture.
+			format = BLOCK_FORMAT_BC5;
+			for (size_t i = 0; i < rgba.size(); i += 4)
+			{
+				rgba[i + 1] = rgba[i + 3];
+			}
+		}
+
+		std::vector<uint8_t> data;
+		uint32_t			 mipCount = 0;
+		int					 mipWidth = width;
+		int					 mipHeight = height;
+		while (mipCount < MAX_MIP_LEVELS)
+		{
+			const std::vector<uint8_t> compressed = CompressImage(rgba.data(), mipWidth, mipHeight, format);
+			data.insert(data.end(), compressed.begin(), compressed.end());
+			mipCount++;
+
+			if (mipWidth == 1 && mipHeight == 1)
+			{
+				break;
+			}
+			rgba = downsample(rgba, mipWidth, mipHeight, mipWidth, mipHeight);
+		}
+
+		DDSHeader header = {};
+		header.size = sizeof(DDSHeader);
+		header.flags = DDSD_CAPS | DDSD_HEIGHT | DDSD_WIDTH | DDSD_PIXELFORMAT | DDSD_MIPMAPCOUNT | DDSD_LINEARSIZE;
+		header.height = static_cast<uint32_t>(height);
+		header.width = static_cast<uint32_t>(width);
+		header.pitchOrLinearSize = static_cast<uint32_t>(GetCompressedSize(format, width, height));
+		header.mipMapCount = mipCount;
+		header.pixelFormat.size = sizeof(DDSPixelFormat);
+		header.pixelFormat.flags = DDPF_FOURCC;
+		header.pixelFormat.fourCC = FOURCCS[format];
+		header.caps = DDSCAPS_TEXTURE | DDSCAPS_COMPLEX | DDSCAPS_MIPMAP;
+		header.reserved1[0] = SOURCE_STAMP_MARKER;
+		std::memcpy(&header.reserved1[1], &stamp, sizeof(stamp));
+
+		std::ofstream fileStream(cookedPath, std::ofstream::binary | std::ofstream::trunc);
+		fileStream.write(reinterpret_cast<const char*>(&DDS_MAGIC), sizeof(DDS_MAGIC));
+		fileStream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		fileStream.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+		if (!fileStream.good())
+		{
+			LEI_ERROR("Failed to write cooked texture {0}", cookedPath);
+			return false;
+		}
+
+		LEI_TRACE("{0}: {1}x{2} {3}, {4} mips, {5} KB", cookedPath, width, height, GetBlockFormatName(format), mipCount, data.size() / 1024);
+		return true;
+	}
+} // namespace lei3d
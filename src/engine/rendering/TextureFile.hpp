@@ -0,0 +1,106 @@
+#pragma once
+
+#include "core/MappedFile.hpp"
+#include "core/SourceStamp.hpp"
+#include "rendering/BlockCompression.hpp"
+
+#include <cstdint>
+#include <string>
+
+namespace lei3d
+{
+	/*
+	 * Cooked textures:
+	 * lei3d_cook compresses every texture a model uses into a DDS twin next to it (grass.png -> grass.png.dds), with the
+	 * whole mip chain generated offline. Texture maps that file and hands each level to glCompressedTexImage2D as is,
+	 * so loading doesn't decode PNGs or run glGenerateMipmap, and the texture takes 4-8x less VRAM.
+	 *
+	 * Only the plain DDS header is used (no DX10 extension), with the FourCCs every reader knows: DXT1 (BC1), DXT5 (BC3),
+	 * ATI1 (BC4) and ATI2 (BC5). Rows are stored bottom up like OpenGL wants them, which is upside down for other DDS
+	 * viewers. The format is picked from the source's channels: 1 -> BC4, 2 -> BC5, 3 (or 4 but opaque) -> BC1, else BC3.
+	 * The SourceStamp of the image it was cooked from goes in the header's reserved words, which DDS readers ignore.
+	 */
+
+	static constexpr uint32_t DDS_MAGIC = 0x20534444; // "DDS "
+
+	struct DDSPixelFormat
+	{
+		uint32_t size;
+		uint32_t flags;
+		uint32_t fourCC;
+		uint32_t rgbBitCount;
+		uint32_t rBitMask;
+		uint32_t gBitMask;
+		uint32_t bBitMask;
+		uint32_t aBitMask;
+	};
+
+	struct DDSHeader
+	{
+		uint32_t	   size;
+		uint32_t	   flags;
+		uint32_t	   height;
+		uint32_t	   width;
+		uint32_t	   pitchOrLinearSize;
+		uint32_t	   depth;
+		uint32_t	   mipMapCount;
+		uint32_t	   reserved1[11];
+		DDSPixelFormat pixelFormat;
+		uint32_t	   caps;
+		uint32_t	   caps2;
+		uint32_t	   caps3;
+		uint32_t	   caps4;
+		uint32_t	   reserved2;
+	};
+
+	class TextureFile
+	{
+	public:
+		static constexpr uint32_t MAX_MIP_LEVELS = 16;
+
+		struct MipLevel
+		{
+			const uint8_t* data;
+			size_t		   size;
+			int			   width;
+			int			   height;
+		};
+
+	private:
+		MappedFile	m_File;
+		BlockFormat m_Format = BLOCK_FORMAT_BC1;
+		uint32_t	m_MipCount = 0;
+		MipLevel	m_Mips[MAX_MIP_LEVELS] = {};
+		SourceStamp m_SourceStamp = {};
+		bool		m_HasSourceStamp = false; // False for DDS files lei3d_cook didn't write.
+
+	public:
+		// Maps a cooked texture and checks every mip level is inside the file. Returns false (and logs why) if it isn't valid.
+		bool Open(const std::string& path);
+		void Close();
+
+		bool			IsOpen() const { return m_MipCount > 0; }
+		BlockFormat		GetFormat() const { return m_Format; }
+		uint32_t		GetMipCount() const { return m_MipCount; }
+		const MipLevel& GetMip(uint32_t level) const { return m_Mips[level]; }
+		size_t			GetFileSize() const { return m_File.Size(); }
+
+		// Whether the image it was cooked from is still the same. Logs why not if it isn't.
+		bool IsSourceUnchanged(const std::string& sourcePath) const;
+
+		// Where the cooked twin of a source image goes.
+		static std::string GetCookedPath(const std::string& sourcePath);
+
+		/*
+		 * For lei3d_cook: whether the cooked twin exists and is up to date. If the source was only touched (e.g. copied),
+		 * its recorded modification time is updated, so loading can tell without hashing the source again.
+		 */
+		static bool IsUpToDate(const std::string& sourcePath, const std::string& cookedPath);
+
+		// Whether path is an image format stb_image decodes for us (by extension).
+		static bool IsImageSource(const std::string& path);
+
+		// Decodes a source image, builds its mips and writes the compressed twin. Returns false (and logs why) on failure.
+		static bool Cook(const std::string& sourcePath, const std::string& cookedPath);
+	};
+} // namespace lei3d
@@ -0,0 +1,240 @@
+#include "TextureResidency.hpp"
+
+#include "core/Camera.hpp"
+#include "logging/Log.hpp"
+#include "rendering/Model.hpp"
+#include "rendering/Texture.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace lei3d
+{
+	TextureResidency* TextureResidency::s_Instance = nullptr;
+
+	TextureResidency::TextureResidency()
+	{
+		if (s_Instance)
+		{
+			LEI_ERROR("Multiple instances detected. Only one TextureResidency should exist.");
+		}
+
+		s_Instance = this;
+	}
+
+	TextureResidency::~TextureResidency()
+	{
+		s_Instance = nullptr;
+	}
+
+	bool TextureResidency::Register(Texture& texture)
+	{
+		const uint32_t tailLevel = GetTailLevel(texture);
+		if (!s_Instance || tailLevel == 0)
+		{
+			return false;
+		}
+
+		s_Instance->m_Entries.push_back({ &texture, tailLevel, tailLevel, tailLevel });
+		return true;
+	}
+
+	void TextureResidency::Unregister(Texture& texture)
+	{
+		if (!s_Instance)
+		{
+			return;
+		}
+
+		std::vector<Entry>& entries = s_Instance->m_Entries;
+		auto				entry = std::find_if(entries.begin(), entries.end(), [&texture](const Entry& e) { return e.texture == &texture; });
+		if (entry != entries.end())
+		{
+			*entry = entries.back();
+			entries.pop_back();
+		}
+	}
+
+	uint32_t TextureResidency::GetTailLevel(const Texture& texture)
+	{
+		const uint32_t mipCount = texture.GetMipCount();
+		const int	   size = std::max(texture.GetWidth(), texture.GetHeight());
+
+		uint32_t level = 0;
+		while (level + 1 < mipCount && (size >> level) > TAIL_SIZE)
+		{
+			level++;
+		}
+		return level;
+	}
+
+	void TextureResidency::BeginFrame(Camera& camera, int screenHeight)
+	{
+		if (!s_Instance)
+		{
+			return;
+		}
+
+		s_Instance->m_CameraPosition = camera.GetPosition();
+		s_Instance->m_PixelsPerUnit = screenHeight / (2.0f * std::tan(glm::radians(camera.GetFOV()) * 0.5f));
+	}
+
+	void TextureResidency::Track(const Model& model, const glm::mat4& transform)
+	{
+		if (!s_Instance || s_Instance->m_PixelsPerUnit <= 0.0f)
+		{
+			return;
+		}
+
+		const float scale = std::max({ glm::length(glm::vec3(transform[0])), glm::length(glm::vec3(transform[1])), glm::length(glm::vec3(transform[2])) });
+		for (const Mesh& mesh : model.GetMeshes())
+		{
+			const Material* material = mesh.material;
+			if (!material || mesh.GetUVDensity() <= 0.0f)
+			{
+				continue;
+			}
+
+			// The closest the mesh's bounding sphere gets to the camera. Inside it, as close as it gets.
+			glm::vec3 boundsMin, boundsMax;
+			mesh.GetBounds(boundsMin, boundsMax);
+			const glm::vec3 center = glm::vec3(transform * glm::vec4((boundsMin + boundsMax) * 0.5f, 1.0f));
+			const float		radius = glm::length(boundsMax - boundsMin) * 0.5f * scale;
+			const float		distance = std::max(glm::length(center - s_Instance->m_CameraPosition) - radius, 0.1f);
+
+			// Texels of a texture one texel wide per pixel on screen. Mip n halves it n times.
+			const float texelsPerPixel = distance / (mesh.GetUVDensity() * scale * s_Instance->m_PixelsPerUnit);
+
+			const std::pair<bool, Texture*> slots[] = {
+				{ material->m_UseAlbedoMap, material->m_AlbedoTexture },
+				{ material->m_UseMetallicMap, material->m_MetallicTexture },
+				{ material->m_UseRoughnessMap, material->m_RoughnessTexture },
+				{ material->m_UseAmbientMap, material->m_AmbientTexture },
+				{ material->m_UseNormalMap, material->m_NormalMap },
+				{ material->m_UseBumpMap, material->m_BumpMap },
+			};
+			for (const auto& [used, texture] : slots)
+			{
+				if (used && texture)
+				{
+					const float level = std::log2(std::max(texture->GetWidth(), texture->GetHeight()) * texelsPerPixel) + s_Instance->m_LodBias;
+					texture->RequestLevel(level > 0.0f ? static_cast<uint32_t>(level) : 0);
+				}
+			}
+		}
+	}
+
+	void TextureResidency::Update()
+	{
+		if (!s_Instance)
+		{
+			return;
+		}
+
+		TextureResidency& residency = *s_Instance;
+		residency.m_Frame++;
+
+		for (Entry& entry : residency.m_Entries)
+		{
+			const uint32_t requested = entry.texture->TakeRequestedLevel();
+			if (requested != Texture::NO_REQUEST)
+			{
+				entry.wantedLevel = std::min(requested, entry.tailLevel);
+				entry.lastSeenFrame = residency.m_Frame;
+			}
+			else if (residency.m_Frame - entry.lastSeenFrame > UNSEEN_FRAMES)
+			{
+				entry.wantedLevel = entry.tailLevel;
+			}
+		}
+
+		// The same number of levels off everything until it fits, so detail drops evenly rather than all from one texture.
+		residency.m_Bias = 0;
+		while (residency.m_Bias < TextureFile::MAX_MIP_LEVELS)
+		{
+			size_t bytes = 0;
+			bool   allAtTail = true;
+			for (Entry& entry : residency.m_Entries)
+			{
+				entry.targetLevel = std::min(entry.wantedLevel + residency.m_Bias, entry.tailLevel);
+				bytes += entry.texture->GetLevelBytes(entry.targetLevel);
+				allAtTail = allAtTail && entry.targetLevel == entry.tailLevel;
+			}
+			if (bytes <= residency.m_Budget || allAtTail)
+			{
+				break;
+			}
+			residency.m_Bias++;
+		}
+
+		for (Entry& entry : residency.m_Entries)
+		{
+			Texture& texture = *entry.texture;
+			if (entry.targetLevel > texture.GetAllocatedLevel())
+			{
+				// Not straight away unless the budget needs it, the camera may well turn back.
+				entry.coarserFrames++;
+				if (residency.m_Bias > 0 || entry.coarserFrames > EVICT_DELAY_FRAMES)
+				{
+					texture.EvictLevels(entry.targetLevel);
+					entry.coarserFrames = 0;
+				}
+			}
+			else
+			{
+				entry.coarserFrames = 0;
+			}
+
+			if (entry.targetLevel < texture.GetResidentLevel() && !texture.IsStreaming())
+			{
+				texture.StreamLevels(entry.targetLevel);
+			}
+		}
+	}
+
+	size_t TextureResidency::GetBudget()
+	{
+		return s_Instance ? s_Instance->m_Budget : 0;
+	}
+
+	void TextureResidency::SetBudget(size_t bytes)
+	{
+		if (s_Instance)
+		{
+			s_Instance->m_Budget = bytes;
+		}
+	}
+
+	float TextureResidency::GetLodBias()
+	{
+		return s_Instance ? s_Instance->m_LodBias : 0.0f;
+	}
+
+	void TextureResidency::SetLodBias(float bias)
+	{
+		if (s_Instance)
+		{
+			s_Instance->m_LodBias = bias;
+		}
+	}
+
+	TextureResidency::Stats TextureResidency::GetStats()
+	{
+		Stats stats;
+		if (!s_Instance)
+		{
+			return stats;
+		}
+
+		stats.textures = static_cast<uint32_t>(s_Instance->m_Entries.size());
+		stats.bias = s_Instance->m_Bias;
+		for (const Entry& entry : s_Instance->m_Entries)
+		{
+			stats.streaming += entry.texture->IsStreaming() ? 1 : 0;
+			stats.residentBytes += entry.texture->GetLevelBytes(entry.texture->GetAllocatedLevel());
+			stats.wantedBytes += entry.texture->GetLevelBytes(entry.wantedLevel);
+			stats.fullChainBytes += entry.texture->GetLevelBytes(0);
+		}
+		return stats;
+	}
+} // namespace lei3d
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace lei3d
+{
+	class Camera;
+	class Model;
+	class Texture;
+
+	/*
+	 * Keeps only the mips of cooked textures resident that are actually needed on screen, under a VRAM budget.
+	 * Without it every texture has its whole chain in VRAM, even if the material is only ever seen from across the map.
+	 *
+	 *   1. While the lighting pass draws, Track works out for each mesh the finest mip its textures can show: texels
+	 *      per pixel from the mesh's UV density (Mesh::GetUVDensity), its scale, its distance and the camera's FOV.
+	 *   2. Update (once per frame) turns the finest level each texture was drawn with into a target level. If the
+	 *      targets together don't fit in the budget, all of them drop the same number of levels until they do.
+	 *   3. Textures below their target stream the missing levels in (TextureStreamer), smallest first, and sample the
+	 *      finest one in so far: GL_TEXTURE_BASE_LEVEL stays clamped until the detail arrives. Textures with more than
+	 *      they need evict the finer levels after a while, or right away if the budget is exceeded.
+	 *
+	 * The small mips (up to 64x64) are always resident, so nothing ever samples black once uploaded. Textures that
+	 * weren't cooked keep their generated mip chain and aren't managed. Main thread only.
+	 */
+	class TextureResidency
+	{
+	public:
+		struct Stats
+		{
+			uint32_t textures = 0;		 // Managed ones.
+			uint32_t streaming = 0;		 // Busy streaming levels in.
+			uint32_t bias = 0;			 // Levels every target dropped to fit in the budget.
+			size_t	 residentBytes = 0;	 // Allocated in VRAM.
+			size_t	 wantedBytes = 0;	 // What the targets take, budget aside.
+			size_t	 fullChainBytes = 0; // What the managed textures would take with every level in.
+		};
+
+	private:
+		static TextureResidency* s_Instance;
+
+		static constexpr int	  TAIL_SIZE = 64;		   // Mips this big or smaller are never evicted.
+		static constexpr uint64_t UNSEEN_FRAMES = 120;	   // Not drawn for this long, a texture goes back to its tail.
+		static constexpr uint64_t EVICT_DELAY_FRAMES = 60; // Needing less detail for this long evicts it, budget allowing.
+
+		struct Entry
+		{
+			Texture* texture;
+			uint32_t tailLevel;
+			uint32_t wantedLevel;
+			uint32_t targetLevel;
+			uint64_t lastSeenFrame = 0;
+			uint64_t coarserFrames = 0; // Frames in a row the target was coarser than what's allocated.
+		};
+
+		std::vector<Entry> m_Entries;
+		size_t			   m_Budget = 512 * 1024 * 1024;
+		uint64_t		   m_Frame = 0;
+		uint32_t		   m_Bias = 0;
+		float			   m_LodBias = 0.0f; // Added to every requested level, negative for sharper textures.
+
+		// Set up for the frame being drawn, by BeginFrame.
+		glm::vec3 m_CameraPosition = glm::vec3(0.0f);
+		float	  m_PixelsPerUnit = 0.0f; // Pixels a world unit covers on screen at distance 1.
+
+	public:
+		TextureResidency();
+		~TextureResidency();
+
+		TextureResidency(const TextureResidency&) = delete;
+		TextureResidency& operator=(const TextureResidency&) = delete;
+
+		// Whether the texture is managed from now on. False without a residency or for textures without mips to stream.
+		static bool		Register(Texture& texture);
+		static void		Unregister(Texture& texture);
+		static uint32_t GetTailLevel(const Texture& texture); // The finest level that's always resident.
+
+		static void BeginFrame(Camera& camera, int screenHeight); // Before drawing with Track.
+		static void Track(const Model& model, const glm::mat4& transform);
+		static void Update(); // Once per frame, before TextureStreamer::Update.
+
+		static size_t GetBudget();
+		static void	  SetBudget(size_t bytes);
+		static float  GetLodBias();
+		static void	  SetLodBias(float bias);
+		static Stats  GetStats();
+	};
+} // namespace lei3d
@@ -0,0 +1,421 @@
+#include "TextureStreamer.hpp"
+
+#include "logging/GLDebug.hpp"
+#include "logging/Log.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace lei3d
+{
+	TextureStreamer* TextureStreamer::s_Instance = nullptr;
+
+	// Slots start on a 16 byte boundary, so the copies into them stay aligned.
+	static constexpr size_t SLOT_ALIGNMENT = 16;
+
+	TextureStreamer::TextureStreamer(JobSystem* jobs, size_t ringBytes)
+		: m_JobSystem(jobs)
+		, m_Capacity((ringBytes + SLOT_ALIGNMENT - 1) / SLOT_ALIGNMENT * SLOT_ALIGNMENT)
+	{
+		if (s_Instance)
+		{
+			LEI_ERROR("Multiple instances detected. Only one TextureStreamer should exist.");
+		}
+
+		s_Instance = this;
+
+		GLCall(glGenBuffers(1, &m_Buffer));
+		GLCall(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_Buffer));
+		if (GLAD_GL_VERSION_4_4 || GLAD_GL_ARB_buffer_storage)
+		{
+			// Coherent, so what the workers write is visible to the GPU without flushing anything.
+			const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+			GLCall(glBufferStorage(GL_PIXEL_UNPACK_BUFFER, m_Capacity, nullptr, flags));
+			m_Mapped = static_cast<uint8_t*>(glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, m_Capacity, flags));
+		}
+		else
+		{
+			GLCall(glBufferData(GL_PIXEL_UNPACK_BUFFER, m_Capacity, nullptr, GL_STREAM_DRAW));
+		}
+		GLCall(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0));
+
+		LEI_INFO("Texture streaming through a {0} MB ring buffer{1}", m_Capacity / (1024 * 1024), m_Mapped ? ", persistently mapped" : "");
+	}
+
+	TextureStreamer::~TextureStreamer()
+	{
+		if (!m_Copying.empty() && m_JobSystem)
+		{
+			m_JobSystem->Wait(m_CopyCounter);
+		}
+
+		for (const Batch& batch : m_InFlight)
+		{
+			GLCall(glDeleteSync(batch.fence));
+		}
+		if (m_Mapped)
+		{
+			GLCall(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_Buffer));
+			GLCall(glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER));
+			GLCall(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0));
+		}
+		GLCall(glDeleteBuffers(1, &m_Buffer));
+
+		s_Instance = nullptr;
+	}
+
+	bool TextureStreamer::Stream(TextureStreamRequest request)
+	{
+		if (!s_Instance || request.images.empty())
+		{
+			return false;
+		}
+
+		auto entry = std::make_unique<Request>();
+		for (const TextureStreamImage& image : request.images)
+		{
+			if (image.rowBytes + SLOT_ALIGNMENT > s_Instance->m_Capacity)
+			{
+				LEI_WARN("A {0}x{1} texture has rows too big to stream, uploading it at once", image.width, image.height);
+				return false;
+			}
+			entry->remaining += image.rowBytes * image.rowCount;
+		}
+
+		entry->request = std::move(request);
+		s_Instance->m_Requests.push_back(std::move(entry));
+		return true;
+	}
+
+	void TextureStreamer::Cancel(const void* owner)
+	{
+		if (s_Instance)
+		{
+			s_Instance->cancel(owner);
+		}
+	}
+
+	void TextureStreamer::cancel(const void* owner)
+	{
+		auto request = std::find_if(m_Requests.begin(), m_Requests.end(), [owner](const auto& entry) { return entry->request.owner == owner; });
+		if (request == m_Requests.end())
+		{
+			return;
+		}
+
+		// Workers may be copying its rows right now. The ring space stays taken until the next batch retires.
+		if ((*request)->inRing > 0)
+		{
+			if (m_JobSystem)
+			{
+				m_JobSystem->Wait(m_CopyCounter);
+			}
+			const Request* cancelled = request->get();
+			m_Copying.erase(std::remove_if(m_Copying.begin(), m_Copying.end(), [cancelled](const Chunk& chunk) { return chunk.request == cancelled; }),
+				m_Copying.end());
+		}
+
+		m_Requests.erase(request);
+	}
+
+	void TextureStreamer::Update()
+	{
+		if (!s_Instance)
+		{
+			return;
+		}
+
+		TextureStreamer& streamer = *s_Instance;
+		streamer.m_LastFrameBytes = 0;
+		streamer.retire(false);
+
+		if (!streamer.m_Copying.empty())
+		{
+			if (streamer.m_CopyCounter.pending > 0)
+			{
+				return; // The workers aren't done with last frame's rows, so nothing new gets handed out either.
+			}
+			streamer.submit(true);
+		}
+
+		streamer.plan(streamer.m_FrameBudget);
+		if (streamer.m_Copying.empty())
+		{
+			return;
+		}
+
+		if (streamer.m_Mapped && streamer.m_JobSystem)
+		{
+			for (const Chunk& chunk : streamer.m_Copying)
+			{
+				streamer.m_JobSystem->Run([&streamer, chunk]() { streamer.copy(streamer.m_Mapped, chunk); }, streamer.m_CopyCounter);
+			}
+		}
+		else
+		{
+			streamer.copyAndSubmit();
+		}
+	}
+
+	void TextureStreamer::Flush()
+	{
+		if (!s_Instance)
+		{
+			return;
+		}
+
+		TextureStreamer& streamer = *s_Instance;
+		if (!streamer.m_Copying.empty())
+		{
+			if (streamer.m_JobSystem)
+			{
+				streamer.m_JobSystem->Wait(streamer.m_CopyCounter);
+			}
+			streamer.submit(true);
+		}
+
+		while (!streamer.m_Requests.empty())
+		{
+			streamer.retire(false);
+			streamer.plan(SIZE_MAX);
+			if (streamer.m_Copying.empty())
+			{
+				if (streamer.m_InFlight.empty())
+				{
+					LEI_ERROR("Texture streaming is stuck with {0} requests left", streamer.m_Requests.size());
+					return;
+				}
+				streamer.retire(true); // The ring is full, wait for the GPU to free some of it.
+				continue;
+			}
+			streamer.copyAndSubmit();
+		}
+	}
+
+	size_t TextureStreamer::GetFrameBudget()
+	{
+		return s_Instance ? s_Instance->m_FrameBudget : 0;
+	}
+
+	void TextureStreamer::SetFrameBudget(size_t bytes)
+	{
+		if (s_Instance)
+		{
+			s_Instance->m_FrameBudget = bytes;
+		}
+	}
+
+	TextureStreamer::Stats TextureStreamer::GetStats()
+	{
+		Stats stats;
+		if (!s_Instance)
+		{
+			return stats;
+		}
+
+		const TextureStreamer& streamer = *s_Instance;
+		stats.pendingRequests = static_cast<uint32_t>(streamer.m_Requests.size());
+		for (const auto& request : streamer.m_Requests)
+		{
+			stats.pendingBytes += request->remaining;
+		}
+		stats.lastFrameBytes = streamer.m_LastFrameBytes;
+		stats.ringBytes = streamer.m_Head >= streamer.m_Tail ? streamer.m_Head - streamer.m_Tail : streamer.m_Capacity - streamer.m_Tail + streamer.m_Head;
+		stats.ringCapacity = streamer.m_Capacity;
+		stats.persistent = streamer.m_Mapped && streamer.m_JobSystem;
+		return stats;
+	}
+
+	void TextureStreamer::UploadRows(const TextureStreamImage& image, int firstRow, int rowCount, const void* pixels)
+	{
+		// Block rows are 4 pixels high, apart from the last one of images that aren't a multiple of 4.
+		const int rowHeight = image.compressed ? 4 : 1;
+		const int y = firstRow * rowHeight;
+		const int height = std::min(rowCount * rowHeight, image.height - y);
+
+		// Rows are tightly packed, e.g. RGB rows don't start on 4 bytes.
+		GLCall(glPixelStorei(GL_UNPACK_ALIGNMENT, 1));
+		if (image.compressed)
+		{
+			const GLsizei size = static_cast<GLsizei>(image.rowBytes * rowCount);
+			GLCall(glCompressedTexSubImage2D(image.target, image.level, 0, y, image.width, height, image.format, size, pixels));
+		}
+		else
+		{
+			GLCall(glTexSubImage2D(image.target, image.level, 0, y, image.width, height, image.format, GL_UNSIGNED_BYTE, pixels));
+		}
+		GLCall(glPixelStorei(GL_UNPACK_ALIGNMENT, 4));
+	}
+
+	void TextureStreamer::retire(bool wait)
+	{
+		while (!m_InFlight.empty())
+		{
+			const Batch& batch = m_InFlight.front();
+			const GLenum result = glClientWaitSync(batch.fence, wait ? GL_SYNC_FLUSH_COMMANDS_BIT : 0, wait ? GL_TIMEOUT_IGNORED : 0);
+			if (result == GL_TIMEOUT_EXPIRED)
+			{
+				break;
+			}
+			if (result == GL_WAIT_FAILED)
+			{
+				LEI_ERROR("Waiting on a texture streaming fence failed, reusing its ring space anyway");
+			}
+
+			GLCall(glDeleteSync(batch.fence));
+			m_Tail = batch.end;
+			m_InFlight.pop_front();
+			wait = false; // Only block for the oldest one.
+		}
+
+		if (m_InFlight.empty() && m_Copying.empty())
+		{
+			m_Head = 0;
+			m_Tail = 0;
+		}
+	}
+
+	size_t TextureStreamer::freeSpan(size_t& offset)
+	{
+		// The biggest contiguous free range. It never reaches up to the tail exactly, so a full ring doesn't look empty.
+		if (m_Head >= m_Tail)
+		{
+			const size_t toEnd = m_Capacity - m_Head;
+			const size_t fromStart = m_Tail > 0 ? m_Tail - 1 : 0;
+			offset = toEnd >= fromStart ? m_Head : 0;
+			return std::max(toEnd, fromStart);
+		}
+
+		offset = m_Head;
+		return m_Tail - m_Head - 1;
+	}
+
+	void TextureStreamer::plan(size_t budget)
+	{
+		size_t planned = 0;
+		for (const auto& entry : m_Requests)
+		{
+			Request& request = *entry;
+			while (request.image < request.request.images.size())
+			{
+				const TextureStreamImage& image = request.request.images[request.image];
+
+				// At least one row a frame, however small the budget.
+				const size_t budgetLeft = planned < budget ? budget - planned : 0;
+				if (budgetLeft < image.rowBytes && planned > 0)
+				{
+					return;
+				}
+
+				size_t		 offset = 0;
+				const size_t span = freeSpan(offset);
+				const size_t usable = span > SLOT_ALIGNMENT ? span - SLOT_ALIGNMENT : 0;
+				const size_t fits = std::min(std::max(budgetLeft, image.rowBytes), usable) / image.rowBytes;
+				if (fits == 0)
+				{
+					return; // The ring is full until the GPU catches up.
+				}
+
+				const int	 rows = static_cast<int>(std::min<size_t>(fits, image.rowCount - request.row));
+				const size_t bytes = image.rowBytes * rows;
+				m_Copying.push_back({ &request, request.image, request.row, rows, offset });
+				m_Head = std::min(m_Capacity, (offset + bytes + SLOT_ALIGNMENT - 1) / SLOT_ALIGNMENT * SLOT_ALIGNMENT);
+				planned += bytes;
+				request.remaining -= bytes;
+				request.inRing++;
+
+				request.row += rows;
+				if (request.row == image.rowCount)
+				{
+					request.image++;
+					request.row = 0;
+				}
+			}
+		}
+	}
+
+	void TextureStreamer::copy(uint8_t* base, const Chunk& chunk) const
+	{
+		const TextureStreamImage& image = chunk.request->request.images[chunk.image];
+		std::memcpy(base + chunk.offset, image.data + image.rowBytes * chunk.firstRow, image.rowBytes * chunk.rowCount);
+	}
+
+	void TextureStreamer::copyAndSubmit()
+	{
+		uint8_t* base = m_Mapped;
+		if (!base)
+		{
+			// Unsynchronized is fine, the rows only go in slots no fence is pending on.
+			GLCall(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_Buffer));
+			base = static_cast<uint8_t*>(glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, m_Capacity, GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT));
+		}
+		if (!base)
+		{
+			LEI_ERROR("Failed to map the texture streaming buffer, uploading from CPU memory");
+			GLCall(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0));
+			submit(false);
+			return;
+		}
+
+		for (const Chunk& chunk : m_Copying)
+		{
+			copy(base, chunk);
+		}
+		if (!m_Mapped)
+		{
+			GLCall(glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER));
+			GLCall(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0));
+		}
+		submit(true);
+	}
+
+	void TextureStreamer::submit(bool fromRing)
+	{
+		// With a buffer bound, the pixel pointers are offsets into it.
+		if (fromRing)
+		{
+			GLCall(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_Buffer));
+		}
+
+		for (const Chunk& chunk : m_Copying)
+		{
+			Request&				  request = *chunk.request;
+			const TextureStreamImage& image = request.request.images[chunk.image];
+			const void*				  pixels = fromRing ? reinterpret_cast<const void*>(chunk.offset) : image.data + image.rowBytes * chunk.firstRow;
+
+			GLCall(glBindTexture(request.request.bindTarget, request.request.textureID));
+			UploadRows(image, chunk.firstRow, chunk.rowCount, pixels);
+			m_LastFrameBytes += image.rowBytes * chunk.rowCount;
+			request.inRing--;
+
+			if (chunk.firstRow + chunk.rowCount == image.rowCount && request.request.onImageUploaded)
+			{
+				request.request.onImageUploaded(image);
+			}
+		}
+
+		if (fromRing)
+		{
+			GLCall(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0));
+			m_InFlight.push_back({ glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0), m_Head });
+		}
+		m_Copying.clear();
+
+		for (auto entry = m_Requests.begin(); entry != m_Requests.end();)
+		{
+			const Request& request = **entry;
+			if (request.image < request.request.images.size() || request.inRing > 0)
+			{
+				++entry;
+				continue;
+			}
+
+			if (request.request.onComplete)
+			{
+				GLCall(glBindTexture(request.request.bindTarget, request.request.textureID));
+				request.request.onComplete();
+			}
+			entry = m_Requests.erase(entry);
+		}
+	}
+} // namespace lei3d
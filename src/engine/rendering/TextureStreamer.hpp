@@ -0,0 +1,145 @@
+#pragma once
+
+#include "core/JobSystem.hpp"
+
+#include <glad/glad.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <deque>
+#include <vector>
+
+namespace lei3d
+{
+	// One image (a mip level or cube map face) of a texture, whose storage is already allocated, to fill with data.
+	struct TextureStreamImage
+	{
+		unsigned int   target; // GL_TEXTURE_2D, or the cube map face.
+		int			   level;
+		int			   width;
+		int			   height;
+		unsigned int   format; // Pixel format, or the internal format if compressed.
+		bool		   compressed;
+		const uint8_t* data;	 // Has to stay valid until the request completes or is cancelled.
+		size_t		   rowBytes; // Per row of pixels, or per row of 4x4 blocks if compressed. Rows are tightly packed.
+		int			   rowCount;
+	};
+
+	struct TextureStreamRequest
+	{
+		const void*						owner;		// Who Cancel is called with, normally the texture.
+		unsigned int					textureID;
+		unsigned int					bindTarget; // GL_TEXTURE_2D or GL_TEXTURE_CUBE_MAP.
+		std::vector<TextureStreamImage> images;		// Filled in this order.
+		std::function<void(const TextureStreamImage&)> onImageUploaded; // Optional. On the main thread, texture bound.
+		std::function<void()>						   onComplete;		// Optional. On the main thread, texture bound.
+	};
+
+	/*
+	 * Streams texture data to the GPU over a few frames instead of uploading it all from CPU memory the moment a
+	 * texture is created, which used to stall the frame a big texture (or a whole scene's worth) got uploaded in.
+	 *
+	 * Uploads go through a ring buffer of pixel unpack buffer (PBO) memory that stays mapped (ARB_buffer_storage,
+	 * which almost every driver has even without GL 4.4; otherwise the ring is mapped unsynchronized when it's written):
+	 *   1. Update hands out ring space to the queued images, row by row, up to the frame budget.
+	 *   2. Workers copy the rows into their slots (or the main thread does, without persistent mapping or a job system).
+	 *   3. Next Update, once the copies are done, the main thread issues glTexSubImage2D from the buffer offsets, which
+	 *      the driver turns into DMA transfers instead of copying on the spot, and puts a fence after them.
+	 *   4. A slot is handed out again once its fence has signalled, so nothing is overwritten that the GPU still reads.
+	 *
+	 * Textures are created (and bindable) straight away, they just aren't complete until their data is in: cooked
+	 * textures stream their smallest mip first and show each level as it arrives, the others sample black until done.
+	 * Everything here runs on the main thread, apart from the copies.
+	 */
+	class TextureStreamer
+	{
+	public:
+		struct Stats
+		{
+			uint32_t pendingRequests = 0;
+			size_t	 pendingBytes = 0;	 // Not copied into the ring yet.
+			size_t	 lastFrameBytes = 0; // Uploaded by the last Update.
+			size_t	 ringBytes = 0;		 // In use, including what the GPU may still read.
+			size_t	 ringCapacity = 0;
+			bool	 persistent = false; // Whether the ring stays mapped and workers fill it.
+		};
+
+	private:
+		static TextureStreamer* s_Instance;
+
+		struct Request
+		{
+			TextureStreamRequest request;
+			size_t				 image = 0;	   // Next image to hand out rows of.
+			int					 row = 0;	   // Next row of it.
+			uint32_t			 inRing = 0;   // Chunks handed out but not uploaded yet.
+			size_t				 remaining = 0; // Bytes not handed out yet.
+		};
+
+		// Rows of one image sitting in (or being copied into) the ring.
+		struct Chunk
+		{
+			Request* request;
+			size_t	 image;
+			int		 firstRow;
+			int		 rowCount;
+			size_t	 offset;
+		};
+
+		// Uploads issued in one Update, and the end of the ring space they read.
+		struct Batch
+		{
+			GLsync fence;
+			size_t end;
+		};
+
+		JobSystem*	 m_JobSystem;
+		unsigned int m_Buffer = 0;
+		uint8_t*	 m_Mapped = nullptr; // Only with persistent mapping.
+		size_t		 m_Capacity;
+		size_t		 m_Head = 0; // Where the next slot starts.
+		size_t		 m_Tail = 0; // Start of the oldest slot the GPU may still read.
+		size_t		 m_FrameBudget = 4 * 1024 * 1024;
+		size_t		 m_LastFrameBytes = 0;
+
+		std::vector<std::unique_ptr<Request>> m_Requests;
+		std::vector<Chunk>					  m_Copying; // Being copied by workers, uploaded next Update.
+		std::deque<Batch>					  m_InFlight;
+		JobCounter							  m_CopyCounter;
+
+	public:
+		explicit TextureStreamer(JobSystem* jobs = nullptr, size_t ringBytes = 16 * 1024 * 1024); // Needs the GL context.
+		~TextureStreamer();
+
+		TextureStreamer(const TextureStreamer&) = delete;
+		TextureStreamer& operator=(const TextureStreamer&) = delete;
+
+		/*
+		 * Queues a texture's data. Returns false if there's no streamer (or an image row doesn't fit in the ring), then
+		 * the caller should upload it right away with UploadRows.
+		 */
+		static bool Stream(TextureStreamRequest request);
+		static void Cancel(const void* owner); // Before the owner's data or texture goes away.
+
+		static void Update(); // Once per frame.
+		static void Flush();  // Uploads everything queued now, blocking until it's done.
+
+		static size_t GetFrameBudget();
+		static void	  SetFrameBudget(size_t bytes);
+		static Stats  GetStats();
+
+		// glTexSubImage2D (or the compressed version) for some rows of an image, from CPU memory or an offset into the bound PBO.
+		static void UploadRows(const TextureStreamImage& image, int firstRow, int rowCount, const void* pixels);
+
+	private:
+		void   retire(bool wait); // Frees the ring space of batches the GPU is done with. wait blocks for the oldest one.
+		size_t freeSpan(size_t& offset);
+		void   plan(size_t budget);
+		void   copy(uint8_t* base, const Chunk& chunk) const;
+		void   copyAndSubmit();
+		void   submit(bool fromRing);
+		void   cancel(const void* owner);
+	};
+} // namespace lei3d
@@ -0,0 +1,334 @@
+#include "DataScene.hpp"
+
+#include "core/Application.hpp"
+
+#include "components/CharacterController.hpp"
+#include "components/FollowCameraController.hpp"
+#include "components/ModelInstance.hpp"
+#include "components/SkyBox.hpp"
+#include "components/StaticCollider.hpp"
+
+#include "audio/AudioPlayer.hpp"
+#include "physics/PhysicsWorld.hpp"
+#include "rendering/Model.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <iterator>
+
+namespace lei3d
+{
+	// Component types a scene file can contain, by the name used in the file.
+	const std::unordered_map<StringId, DataScene::ComponentLoader> DataScene::s_ComponentLoaders = {
+		{ "ModelInstance"_sid, &DataScene::LoadModelInstance },
+		{ "StaticCollider"_sid, &DataScene::LoadStaticCollider },
+		{ "CharacterController"_sid, &DataScene::LoadCharacterController },
+		{ "FollowCameraController"_sid, &DataScene::LoadFollowCameraController },
+		{ "SkyBox"_sid, &DataScene::LoadSkyBox },
+	};
+
+	DataScene::DataScene(const std::string& path)
+		: m_Path(path)
+	{
+	}
+
+	DataScene::~DataScene()
+	{
+	}
+
+	const std::string& DataScene::GetPath() const
+	{
+		return m_Path;
+	}
+
+	bool DataScene::OpenSceneFile()
+	{
+		namespace fs = std::filesystem;
+
+		const std::string textPath = m_Path + ".txt";
+		std::error_code	  error;
+		const bool		  hasText = fs::exists(textPath, error);
+
+		// The binary records the text it was cooked from (see SourceStamp), modification times alone can't be trusted.
+		if (fs::exists(m_Path, error) && m_File.Open(m_Path))
+		{
+			if (!hasText || m_File.IsSourceUnchanged(textPath))
+			{
+				return true;
+			}
+
+			LEI_INFO("{0} changed since it was cooked, cooking it again", textPath);
+			m_File.Close();
+		}
+
+		// No binary, one from an older version of the format, or one cooked from an older text.
+		return hasText && SceneFile::Cook(textPath, m_Path) && m_File.Open(m_Path);
+	}
+
+	// The face properties of a SkyBox component, in the order SkyBox::Init wants them.
+	static constexpr StringId SKYBOX_FACES[] = { "right"_sid, "left"_sid, "up"_sid, "down"_sid, "front"_sid, "back"_sid };
+
+	void DataScene::OnPrepare(SceneLoadProgress& progress)
+	{
+		m_Prepared = true;
+		m_Models.clear();
+		m_SkyBoxes.clear();
+
+		if (!OpenSceneFile())
+		{
+			LEI_ERROR("Failed to load scene {0}", m_Path);
+			return;
+		}
+
+		const SceneFileHeader& header = m_File.GetHeader();
+		m_NextScene = header.nextScene.Get() ? StringId::Intern(header.nextScene.Get()) : StringId();
+
+		// Find out what needs loading first, so the progress bar knows how far along it is.
+		std::vector<bool>					usedAsModel(header.assetCount, false);
+		std::vector<bool>					usedAsCollider(header.assetCount, false);
+		std::vector<const SceneComponentRecord*> skyBoxes;
+		for (uint32_t i = 0; i < header.entityCount; i++)
+		{
+			const SceneEntityRecord& entity = header.entities[i];
+			for (uint32_t c = 0; c < entity.componentCount; c++)
+			{
+				const SceneComponentRecord& component = entity.components[c];
+				const StringId				type = StringId::FromHash(component.type);
+				if (type == "SkyBox"_sid)
+				{
+					skyBoxes.push_back(&component);
+				}
+				else if (type == "ModelInstance"_sid || type == "StaticCollider"_sid)
+				{
+					const ScenePropertyRecord* model = component.FindProperty("model"_sid, SCENE_PROPERTY_ASSET);
+					if (model && model->asset < header.assetCount)
+					{
+						usedAsModel[model->asset] = true;
+						usedAsCollider[model->asset] = usedAsCollider[model->asset] || type == "StaticCollider"_sid;
+					}
+				}
+			}
+		}
+
+		progress.totalSteps = static_cast<uint32_t>(std::count(usedAsModel.begin(), usedAsModel.end(), true)
+			+ std::count(usedAsCollider.begin(), usedAsCollider.end(), true) + skyBoxes.size() * std::size(SKYBOX_FACES));
+
+		m_Models.resize(header.assetCount);
+		for (uint32_t i = 0; i < header.assetCount; i++)
+		{
+			if (!usedAsModel[i])
+			{
+				continue;
+			}
+
+			m_Models[i] = AssetManager::GetModel(header.assets[i].path.Get());
+			progress.completedSteps++;
+
+			if (usedAsCollider[i])
+			{
+				m_Models[i]->GetCollisionShapes();
+				progress.completedSteps++;
+			}
+		}
+
+		for (const SceneComponentRecord* skyBox : skyBoxes)
+		{
+			std::vector<std::string> faces;
+			for (StringId face : SKYBOX_FACES)
+			{
+				if (const ScenePropertyRecord* path = skyBox->FindProperty(face, SCENE_PROPERTY_STRING))
+				{
+					faces.push_back(path->string.Get());
+				}
+			}
+
+			// LoadSkyBox complains about the missing faces.
+			if (faces.size() == std::size(SKYBOX_FACES))
+			{
+				m_SkyBoxes[skyBox] = AssetManager::GetCubeMap(faces);
+			}
+			progress.completedSteps += static_cast<uint32_t>(std::size(SKYBOX_FACES));
+		}
+	}
+
+	void DataScene::OnLoad()
+	{
+		// Loaded without going through SceneManager's loading thread.
+		if (!m_Prepared)
+		{
+			SceneLoadProgress progress;
+			OnPrepare(progress);
+		}
+		m_Prepared = false; // The next load prepares again.
+
+		if (!m_File.IsOpen())
+		{
+			return;
+		}
+
+		// Models another scene uses too may be uploaded already.
+		for (AssetHandle<Model>& model : m_Models)
+		{
+			if (model && !model->IsUploaded())
+			{
+				model->Upload();
+			}
+		}
+
+		const SceneFileHeader& header = m_File.GetHeader();
+		m_EntityHandles.clear();
+		m_EntityHandles.reserve(header.entityCount);
+
+		// Create every entity before adding components, so components can find the entities they refer to.
+		for (uint32_t i = 0; i < header.entityCount; i++)
+		{
+			const SceneEntityRecord& record = header.entities[i];
+			Entity&					 entity = AddEntity(record.name.Get());
+			ApplyTransform(entity, record);
+			m_EntityHandles.push_back(entity.GetHandle());
+		}
+
+		for (uint32_t i = 0; i < header.entityCount; i++)
+		{
+			const SceneEntityRecord& record = header.entities[i];
+			Entity&					 entity = *GetEntity(m_EntityHandles[i]);
+
+			if (record.parent >= 0 && static_cast<uint32_t>(record.parent) < header.entityCount)
+			{
+				entity.SetParent(GetEntity(m_EntityHandles[record.parent]));
+			}
+
+			for (uint32_t c = 0; c < record.componentCount; c++)
+			{
+				const SceneComponentRecord& component = record.components[c];
+				auto						loader = s_ComponentLoaders.find(StringId::FromHash(component.type));
+				if (loader == s_ComponentLoaders.end())
+				{
+					LEI_WARN("{0}: {1} has an unknown component type {2}", m_Path, entity.GetName(), component.typeName.Get());
+					continue;
+				}
+				(this->*loader->second)(entity, component);
+			}
+		}
+
+		if (header.music.Get())
+		{
+			AudioPlayer::PlayMusic(StringId::Intern(header.music.Get()));
+		}
+	}
+
+	void DataScene::OnUnload()
+	{
+		// Scene::Unload has already destroyed the components using these. The assets stay cached in AssetManager (within
+		// its budget) in case this or another scene uses them again.
+		m_Models.clear();
+		m_SkyBoxes.clear();
+		m_EntityHandles.clear();
+		m_File.Close();
+	}
+
+	void DataScene::OnPhysicsUpdate()
+	{
+		m_PhysicsWorld->Step(Application::FixedDeltaTime());
+	}
+
+	void DataScene::OnReset()
+	{
+		if (!m_File.IsOpen())
+		{
+			return;
+		}
+
+		const SceneFileHeader& header = m_File.GetHeader();
+		for (uint32_t i = 0; i < header.entityCount; i++)
+		{
+			if (Entity* entity = GetEntity(m_EntityHandles[i]))
+			{
+				ApplyTransform(*entity, header.entities[i]);
+			}
+		}
+	}
+
+	StringId DataScene::GetPreloadHint() const
+	{
+		return m_NextScene;
+	}
+
+	void DataScene::ApplyTransform(Entity& entity, const SceneEntityRecord& record)
+	{
+		entity.SetPosition(glm::vec3(record.position[0], record.position[1], record.position[2]));
+		entity.SetRotation(glm::quat(record.rotation[3], record.rotation[0], record.rotation[1], record.rotation[2]));
+		entity.SetScale(glm::vec3(record.scale[0], record.scale[1], record.scale[2]));
+	}
+
+	Model* DataScene::GetModel(const SceneComponentRecord& component, const char* key)
+	{
+		const ScenePropertyRecord* property = component.FindProperty(StringId(key), SCENE_PROPERTY_ASSET);
+		if (!property || property->asset >= m_Models.size())
+		{
+			LEI_ERROR("{0}: {1} needs a model asset for {2}", m_Path, component.typeName.Get(), key);
+			return nullptr;
+		}
+
+		AssetHandle<Model>& model = m_Models[property->asset];
+		if (!model)
+		{
+			// Only happens for component types OnPrepare doesn't know use models.
+			model = AssetManager::GetModel(m_File.GetHeader().assets[property->asset].path.Get());
+		}
+		if (!model->IsUploaded())
+		{
+			model->Upload();
+		}
+		return model.get();
+	}
+
+	void DataScene::LoadModelInstance(Entity& entity, const SceneComponentRecord& component)
+	{
+		if (Model* model = GetModel(component, "model"))
+		{
+			entity.AddComponent<ModelInstance>()->Init(model);
+		}
+	}
+
+	void DataScene::LoadStaticCollider(Entity& entity, const SceneComponentRecord& component)
+	{
+		if (Model* model = GetModel(component, "model"))
+		{
+			StaticCollider* collider = entity.AddComponent<StaticCollider>();
+			collider->Init();
+			collider->SetColliderToModel(*model);
+		}
+	}
+
+	void DataScene::LoadCharacterController(Entity& entity, const SceneComponentRecord& component)
+	{
+		const ScenePropertyRecord* width = component.FindProperty("width"_sid, SCENE_PROPERTY_FLOAT);
+		const ScenePropertyRecord* height = component.FindProperty("height"_sid, SCENE_PROPERTY_FLOAT);
+		const ScenePropertyRecord* groundCheckDist = component.FindProperty("groundCheckDist"_sid, SCENE_PROPERTY_FLOAT);
+
+		CharacterController* controller = entity.AddComponent<CharacterController>();
+		controller->Init(width ? width->values[0] : 1.0f, height ? height->values[0] : 3.0f,
+			groundCheckDist ? groundCheckDist->values[0] : 1.0f);
+	}
+
+	void DataScene::LoadFollowCameraController(Entity& entity, const SceneComponentRecord& component)
+	{
+		const ScenePropertyRecord* offset = component.FindProperty("offset"_sid, SCENE_PROPERTY_VEC3);
+
+		FollowCameraController* followCam = entity.AddComponent<FollowCameraController>();
+		followCam->Init(*m_DefaultCamera, offset ? glm::vec3(offset->values[0], offset->values[1], offset->values[2]) : glm::vec3(0.0f));
+	}
+
+	void DataScene::LoadSkyBox(Entity& entity, const SceneComponentRecord& component)
+	{
+		auto cubeMap = m_SkyBoxes.find(&component);
+		if (cubeMap == m_SkyBoxes.end())
+		{
+			LEI_ERROR("{0}: {1} is missing one of the SkyBox faces (right, left, up, down, front, back)", m_Path, entity.GetName());
+			return;
+		}
+
+		entity.AddComponent<SkyBox>()->Init(cubeMap->second);
+	}
+} // namespace lei3d
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "core/AssetManager.hpp"
+#include "core/Scene.hpp"
+#include "core/SceneFile.hpp"
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace lei3d
+{
+	/*
+	 * A scene loaded from a scene file (see SceneFile.hpp) instead of being built in code.
+	 * Build.config lists these by the path of their binary (e.g. data/scenes/TestKevin.lscene). If the text twin next
+	 * to it (TestKevin.lscene.txt) is newer, or the binary is missing or from another version, it gets cooked first.
+	 * OnPrepare opens the file and loads the models and images on the loading thread, OnLoad uploads them and
+	 * creates the entities.
+	 */
+	class DataScene : public Scene
+	{
+	private:
+		using ComponentLoader = void (DataScene::*)(Entity& entity, const SceneComponentRecord& component);
+		static const std::unordered_map<StringId, ComponentLoader> s_ComponentLoaders;
+
+		std::string m_Path;
+		SceneFile	m_File; // Stays mapped while the scene is loaded, OnReset puts the entities back where the file has them.
+
+		// Filled in by OnPrepare on the loading thread (through AssetManager, so scenes share them), used by OnLoad.
+		std::vector<AssetHandle<Model>>										  m_Models; // Indexed like the file's assets, uploaded by OnLoad.
+		std::unordered_map<const SceneComponentRecord*, AssetHandle<CubeMap>> m_SkyBoxes;
+		bool																  m_Prepared = false;
+		StringId															  m_NextScene; // The file's next statement, see GetPreloadHint.
+
+		std::vector<EntityHandle> m_EntityHandles; // Indexed like the file's entities.
+
+	public:
+		DataScene(const std::string& path);
+		~DataScene();
+
+		const std::string& GetPath() const;
+
+		void OnPrepare(SceneLoadProgress& progress) override;
+		void OnLoad() override;
+		void OnUnload() override;
+		void OnPhysicsUpdate() override;
+		void OnReset() override;
+
+		StringId GetPreloadHint() const override;
+
+	private:
+		bool OpenSceneFile();
+		void ApplyTransform(Entity& entity, const SceneEntityRecord& record);
+
+		Model* GetModel(const SceneComponentRecord& component, const char* key); // key has to be an asset property.
+
+		void LoadModelInstance(Entity& entity, const SceneComponentRecord& component);
+		void LoadStaticCollider(Entity& entity, const SceneComponentRecord& component);
+		void LoadCharacterController(Entity& entity, const SceneComponentRecord& component);
+		void LoadFollowCameraController(Entity& entity, const SceneComponentRecord& component);
+		void LoadSkyBox(Entity& entity, const SceneComponentRecord& component);
+	};
+} // namespace lei3d
@@ -1,36 +0,0 @@
-#pragma once
-
-#include "components/CharacterController.hpp"
-#include "components/SkyBox.hpp"
-#include "components/StaticCollider.hpp"
-#include "core/Entity.hpp"
-#include "core/Scene.hpp"
-#include "physics/PhysicsWorld.hpp"
-#include "rendering/Shader.hpp"
-
-namespace lei3d
-{
-
-	class Entity;
-	class Model;
-	class Shader;
-	class SkyBox;
-	class PhysicsWorld;
-
-	class TestSceneLogan : public Scene
-	{
-	public:
-		TestSceneLogan();
-		~TestSceneLogan();
-
-		void OnLoad() override;
-		void OnPhysicsUpdate() override;
-		void OnReset() override;
-
-	private:
-		std::unique_ptr<Model> backpackModel;
-		std::unique_ptr<Model> playgroundModel;
-	};
-
-	extern std::unique_ptr<Scene> MakeTestSceneLogan();
-} // namespace lei3d
\ No newline at end of file
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <vector>
+
+namespace lei3d
+{
+	/*
+	 * STL allocator that aligns every allocation to Alignment bytes, so loops over the data can use aligned SIMD loads.
+	 */
+	template <typename T, size_t Alignment>
+	struct AlignedAllocator
+	{
+		static_assert(Alignment >= alignof(T), "Alignment must be at least the natural alignment of T.");
+
+		using value_type = T;
+
+		template <typename U>
+		struct rebind
+		{
+			using other = AlignedAllocator<U, Alignment>;
+		};
+
+		AlignedAllocator() = default;
+
+		template <typename U>
+		AlignedAllocator(const AlignedAllocator<U, Alignment>&)
+		{
+		}
+
+		T* allocate(size_t n)
+		{
+			return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(Alignment)));
+		}
+
+		void deallocate(T* p, size_t)
+		{
+			::operator delete(p, std::align_val_t(Alignment));
+		}
+
+		template <typename U>
+		bool operator==(const AlignedAllocator<U, Alignment>&) const
+		{
+			return true;
+		}
+	};
+
+	template <typename T>
+	using AlignedVector = std::vector<T, AlignedAllocator<T, 16>>;
+} // namespace lei3d
@@ -3,6 +3,7 @@
 #include <btBulletDynamicsCommon.h>
 
 #include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
 
 namespace lei3d
 {
@@ -18,6 +19,16 @@ namespace lei3d
 		return {v.getX(), v.getY(), v.getZ()};
 	}
 
+	inline btQuaternion glmToBTQuat(const glm::quat& q)
+	{
+		return btQuaternion{ q.x, q.y, q.z, q.w };
+	}
+
+	inline glm::quat btToGLMQuat(const btQuaternion& q)
+	{
+		return { float(q.getW()), float(q.getX()), float(q.getY()), float(q.getZ()) };
+	}
+
 	inline glm::vec3 btTransformToVec3(const btTransform& trans)
 	{
 		const btVector3& origin = trans.getOrigin();
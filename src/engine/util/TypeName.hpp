@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstdlib>
+#include <string>
+#include <typeinfo>
+
+#if defined(__GNUG__)
+	#include <cxxabi.h>
+#endif
+
+namespace lei3d
+{
+	/*
+	 * Readable name of type T without the lei3d namespace, e.g. "SkyBox".
+	 * Only meant for display (editor, logs). The exact format depends on the compiler.
+	 */
+	template <typename T>
+	std::string TypeNameOf()
+	{
+		std::string name = typeid(T).name();
+
+#if defined(__GNUG__)
+		// GCC and Clang give mangled names.
+		int	  status = 0;
+		char* demangled = abi::__cxa_demangle(name.c_str(), nullptr, nullptr, &status);
+		if (status == 0 && demangled)
+		{
+			name = demangled;
+		}
+		std::free(demangled);
+#endif
+
+		// MSVC puts the kind of type in front.
+		for (const char* prefix : { "class ", "struct ", "lei3d::" })
+		{
+			const std::string prefixString = prefix;
+			if (name.compare(0, prefixString.size(), prefixString) == 0)
+			{
+				name.erase(0, prefixString.size());
+			}
+		}
+
+		return name;
+	}
+} // namespace lei3d